@@ -0,0 +1,618 @@
+/*
+    cbench.cpp
+    10/18/26
+
+    Comparative benchmark: fsu containers vs their standard library counterparts
+
+    Runs identical workloads through type-generic adapters and reports, per
+    workload, ns/op for each side, the fsu/std speed ratio, and (for workloads
+    that build a container) heap bytes per element and the fsu/std size ratio.
+
+      Map_ADT<String,int>   vs  std::map<std::string,int>
+      Map_ADT<String,int>   vs  std::unordered_map<std::string,int>
+      Map_ADT<uint32_t,int> vs  std::map<uint32_t,int>
+      FrozenHashDict<int>   vs  std::unordered_map<std::string,int>, built
+                                from the same keys; build is from a filled
+                                Map_ADT, bytes are the image size
+      String                vs  std::string
+      Vector<int>           vs  std::vector<int>
+      Deque<int>            vs  std::deque<int>
+      List<int>             vs  std::list<int>
+      PriorityQueue<int>    vs  std::priority_queue<int>, arity 2 and 4,
+                                n = max(n, 1000000)
+      PriorityQueue<String> vs  std::priority_queue<std::string>, arity 2 and 4
+
+    The library has no hash table, so the unordered_map rows compare against
+    the ordered Map_ADT; they answer "what would a hash table buy us".
+
+    Heap bytes are counted by the memtrack.h operator new/delete, which tally
+    requested sizes only. Map rows also report allocations per insert, the
+    peak heap reached while building, and the fsu map's own MemoryUsage(),
+    which should agree with the counted bytes.
+
+    On Linux, where perf_event_open is permitted, map and string rows are
+    followed by a "per op:" line of L1d/LLC/branch/dTLB misses and IPC,
+    fsu/std, measured over the same fastest repetition as the ns/op figure.
+
+    usage: cbench [n = 200000] [reps = 3]
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <list>
+#include <queue>
+
+#include <bench.h>
+#include <memtrack.h>
+#include <histogram.h>
+#include <map_adt.h>
+#include <vector.h>
+#include <deque.h>
+#include <list.h>
+#include <pq.h>
+#include <frozendict.h>
+#include <xstring.h>
+#include <xran.h>
+#include <xranxstr.h>
+#include <xstring.cpp>  // in lieu of makefile
+#include <xran.cpp>     // in lieu of makefile
+#include <xranxstr.cpp> // in lieu of makefile
+
+//----------------------------------
+//   heap byte counting
+//----------------------------------
+
+FSU_MEMTRACK_INSTALL_OPERATORS
+
+static size_t LiveBytes () { return fsu::HeapStats().Live(); }
+
+//----------------------------------
+//   map adapters
+//----------------------------------
+
+template < class M >
+struct MapAdapter;
+
+template < typename K , typename D , class P >
+struct MapAdapter < fsu::Map_ADT<K,D,P> >
+{
+  typedef fsu::Map_ADT<K,D,P> M;
+  static void   Insert (M& m, const K& k, const D& d) { m.Put(k,d); }
+  static D&     Get    (M& m, const K& k)             { return m.Get(k); }
+  static bool   Find   (const M& m, const K& k, D& d) { return m.Retrieve(k,d); }
+  static void   Erase  (M& m, const K& k)             { m.Erase(k); }
+  static size_t Owned  (const M& m)                   { return fsu::HeapUsage(m); }
+  static size_t Scan   (const M& m)
+  {
+    size_t sum = 0;
+    for (typename M::ConstIterator i = m.Begin(); i != m.End(); ++i)
+      sum += (size_t)(*i).data_;
+    return sum;
+  }
+};
+
+template < typename K , typename D , class C , class A >
+struct MapAdapter < std::map<K,D,C,A> >
+{
+  typedef std::map<K,D,C,A> M;
+  static void   Insert (M& m, const K& k, const D& d) { m[k] = d; }
+  static D&     Get    (M& m, const K& k)             { return m[k]; }
+  static bool   Find   (const M& m, const K& k, D& d)
+  {
+    typename M::const_iterator i = m.find(k);
+    if (i == m.end()) return 0;
+    d = i->second;
+    return 1;
+  }
+  static void   Erase  (M& m, const K& k)             { m.erase(k); }
+  static size_t Owned  (const M&)                     { return 0; }  // not modeled
+  static size_t Scan   (const M& m)
+  {
+    size_t sum = 0;
+    for (typename M::const_iterator i = m.begin(); i != m.end(); ++i)
+      sum += (size_t)i->second;
+    return sum;
+  }
+};
+
+template < typename K , typename D , class H , class E , class A >
+struct MapAdapter < std::unordered_map<K,D,H,E,A> >
+{
+  typedef std::unordered_map<K,D,H,E,A> M;
+  static void   Insert (M& m, const K& k, const D& d) { m[k] = d; }
+  static D&     Get    (M& m, const K& k)             { return m[k]; }
+  static bool   Find   (const M& m, const K& k, D& d)
+  {
+    typename M::const_iterator i = m.find(k);
+    if (i == m.end()) return 0;
+    d = i->second;
+    return 1;
+  }
+  static void   Erase  (M& m, const K& k)             { m.erase(k); }
+  static size_t Owned  (const M&)                     { return 0; }  // not modeled
+  static size_t Scan   (const M& m)
+  {
+    size_t sum = 0;
+    for (typename M::const_iterator i = m.begin(); i != m.end(); ++i)
+      sum += (size_t)i->second;
+    return sum;
+  }
+};
+
+// timings for one map type over one key set
+struct MapTimes
+{
+  double insert, hit, miss, scan, erase, bytes;
+  double allocs, peak, owned;   // allocations/insert, peak B/elt, MemoryUsage() B/elt
+  fsu::PerfSample pInsert, pHit, pMiss, pScan, pErase;   // hardware counters, same regions
+};
+
+template < class M , typename K >
+MapTimes RunMap (const std::vector<K>& keys, const std::vector<K>& absent, size_t reps)
+{
+  typedef MapAdapter<M> A;
+  MapTimes t;
+  size_t n = keys.size();
+  M m;
+  size_t before = LiveBytes();
+  fsu::HeapMark mark;
+  t.insert = fsu::BestOf([&]()
+    {
+      m = M();
+      mark.Reset();
+      for (size_t i = 0; i < n; ++i) A::Insert(m, keys[i], (int)i);
+    }, reps, t.pInsert) / n;
+  t.bytes  = double(LiveBytes() - before) / n;
+  t.allocs = double(mark.Allocations()) / n;
+  t.peak   = double(mark.Peak()) / n;
+  t.owned  = double(A::Owned(m)) / n;
+  int d = 0;
+  size_t found = 0;
+  t.hit = fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < n; ++i) found += A::Find(m, keys[i], d);
+    }, reps, t.pHit) / n;
+  t.miss = fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < absent.size(); ++i) found += A::Find(m, absent[i], d);
+    }, reps, t.pMiss) / absent.size();
+  size_t sum = 0;
+  t.scan = fsu::BestOf([&]() { sum += A::Scan(m); }, reps, t.pScan) / n;
+  fsu::BenchCounters().Start();
+  fsu::Timer timer;
+  for (size_t i = 0; i < n; ++i) A::Erase(m, keys[i]);
+  t.erase = timer.Nanoseconds() / n;
+  t.pErase = fsu::BenchCounters().Stop();
+  fsu::DoNotOptimize(found);
+  fsu::DoNotOptimize(sum);
+  return t;
+}
+
+template < class F , class S , typename KF , typename KS >
+void CompareMaps (fsu::BenchTable& table, const char* title,
+                  const std::vector<KF>& fkeys, const std::vector<KF>& fabsent,
+                  const std::vector<KS>& skeys, const std::vector<KS>& sabsent, size_t reps)
+{
+  MapTimes f = RunMap<F>(fkeys, fabsent, reps);
+  MapTimes s = RunMap<S>(skeys, sabsent, reps);
+  table.Title(title);
+  double n = (double)fkeys.size(), an = (double)fabsent.size();
+  table.Row("insert (build)", f.insert, s.insert, f.bytes, s.bytes);
+  table.Counters(f.pInsert, s.pInsert, n, n);
+  table.Heap(f.allocs, s.allocs, f.peak, s.peak, f.owned);
+  table.Row("lookup hit", f.hit, s.hit);
+  table.Counters(f.pHit, s.pHit, n, n);
+  table.Row("lookup miss", f.miss, s.miss);
+  table.Counters(f.pMiss, s.pMiss, an, an);
+  table.Row("inorder scan", f.scan, s.scan);
+  table.Counters(f.pScan, s.pScan, n, n);
+  table.Row("erase", f.erase, s.erase);
+  table.Counters(f.pErase, s.pErase, n, n);
+}
+
+// per-call latency of Put, Get, Retrieve, Erase, one histogram each
+template < class M , typename K >
+void MapLatency (const std::vector<K>& keys, fsu::LatencyHistogram h[4])
+{
+  typedef MapAdapter<M> A;
+  M m;
+  fsu::LatencyTimer t;
+  int d = 0;
+  size_t n = keys.size();
+  for (size_t i = 0; i < n; ++i)
+  {
+    t.Start(); A::Insert(m, keys[i], (int)i); h[0].Record(t.ElapsedNs());
+  }
+  for (size_t i = 0; i < n; ++i)
+  {
+    t.Start(); d += A::Get(m, keys[n - 1 - i]); h[1].Record(t.ElapsedNs());
+  }
+  for (size_t i = 0; i < n; ++i)
+  {
+    t.Start(); A::Find(m, keys[i], d); h[2].Record(t.ElapsedNs());
+  }
+  for (size_t i = 0; i < n; ++i)
+  {
+    t.Start(); A::Erase(m, keys[i]); h[3].Record(t.ElapsedNs());
+  }
+  fsu::DoNotOptimize(d);
+}
+
+template < class M , typename K >
+void ReportLatency (const char* title, const std::vector<K>& keys)
+{
+  static const char* ops[4] = { "Put", "Get", "Retrieve", "Erase" };
+  fsu::LatencyHistogram h[4];
+  MapLatency<M>(keys, h);
+  std::cout << '\n' << title << '\n';
+  fsu::LatencyHistogram::ReportHeader(std::cout);
+  for (size_t i = 0; i < 4; ++i)
+    h[i].Report(std::cout, ops[i]);
+}
+
+// build from a filled map, then hit and miss lookups: ns per key
+void CompareFrozen (fsu::BenchTable& table, const std::vector<fsu::String>& keys, const std::vector<fsu::String>& absent,
+                    const std::vector<std::string>& skeys, const std::vector<std::string>& sabsent, size_t reps)
+{
+  fsu::Map_ADT<fsu::String,int> m;
+  for (size_t i = 0; i < keys.size(); ++i)
+    m.Put(keys[i], (int)i);
+  fsu::FrozenHashDict<int> f;
+  double n = (double)keys.size(), an = (double)absent.size();
+  double build = fsu::BestOf([&]() { f.Build(m); }, reps) / n;
+  int d = 0;
+  size_t found = 0;
+  double hit = fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < keys.size(); ++i) found += f.Retrieve(keys[i], d);
+    }, reps) / n;
+  double miss = fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < absent.size(); ++i) found += f.Retrieve(absent[i], d);
+    }, reps) / an;
+  fsu::DoNotOptimize(found);
+  MapTimes s = RunMap< std::unordered_map<std::string,int> >(skeys, sabsent, reps);
+  table.Title("FrozenHashDict<int> vs std::unordered_map<string,int>");
+  table.Row("build", build, s.insert, (double)f.MemoryUsage() / f.Size(), s.bytes);
+  table.Row("lookup hit", hit, s.hit);
+  table.Row("lookup miss", miss, s.miss);
+}
+
+//----------------------------------
+//   sequence and string workloads
+//----------------------------------
+
+template < class V >
+double VectorBuild (size_t n, size_t reps, double& bytes)
+{
+  V* v = nullptr;
+  double ns = fsu::BestOf([&]()
+    {
+      delete v;
+      size_t before = LiveBytes();
+      v = new V;
+      for (size_t i = 0; i < n; ++i) v->push_back((int)i);
+      bytes = double(LiveBytes() - before) / n;
+    }, reps) / n;
+  delete v;
+  return ns;
+}
+
+// fsu::Vector speaks PushBack; give it the std spelling for the template above
+struct FsuVector : public fsu::Vector<int> { void push_back (int x) { PushBack(x); } };
+struct FsuDeque  : public fsu::Deque<int>  { void push_back (int x) { PushBack(x); } };
+struct FsuList   : public fsu::List<int>   { void push_back (int x) { PushBack(x); } };
+
+template < class V >
+double IndexSum (const V& v, size_t n, size_t reps)
+{
+  size_t sum = 0;
+  double ns = fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < n; ++i) sum += v[i];
+    }, reps) / n;
+  fsu::DoNotOptimize(sum);
+  return ns;
+}
+
+double FsuQueueCycle (size_t n, size_t reps)
+{
+  fsu::Deque<int> q;
+  return fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < n; ++i) { q.PushBack((int)i); if (i & 1) q.PopFront(); }
+      while (!q.Empty()) q.PopFront();
+    }, reps) / n;
+}
+
+double StdQueueCycle (size_t n, size_t reps)
+{
+  std::deque<int> q;
+  return fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < n; ++i) { q.push_back((int)i); if (i & 1) q.pop_front(); }
+      while (!q.empty()) q.pop_front();
+    }, reps) / n;
+}
+
+template < class L >
+double ListScan (const L& l, size_t n, size_t reps)
+{
+  size_t sum = 0;
+  double ns = fsu::BestOf([&]()
+    {
+      for (typename L::ConstIterator i = l.Begin(); i != l.End(); ++i) sum += *i;
+    }, reps) / n;
+  fsu::DoNotOptimize(sum);
+  return ns;
+}
+
+double StdListScan (const std::list<int>& l, size_t n, size_t reps)
+{
+  size_t sum = 0;
+  double ns = fsu::BestOf([&]()
+    {
+      for (std::list<int>::const_iterator i = l.begin(); i != l.end(); ++i) sum += *i;
+    }, reps) / n;
+  fsu::DoNotOptimize(sum);
+  return ns;
+}
+
+template < class S >
+double StringCopy (const std::vector<S>& src, size_t reps, double& bytes)
+{
+  std::vector<S> dst(src.size());
+  double ns = fsu::BestOf([&]()
+    {
+      for (size_t i = 0; i < src.size(); ++i) dst[i] = S();
+      size_t before = LiveBytes();
+      for (size_t i = 0; i < src.size(); ++i) dst[i] = src[i];
+      bytes = double(LiveBytes() - before) / src.size() + sizeof(S);
+    }, reps) / src.size();
+  return ns;
+}
+
+template < class S >
+double StringCompare (const std::vector<S>& s, size_t reps, fsu::PerfSample& sample)
+{
+  size_t less = 0;
+  double ns = fsu::BestOf([&]()
+    {
+      for (size_t i = 1; i < s.size(); ++i) less += (s[i-1] < s[i]);
+    }, reps, sample) / (s.size() - 1);
+  fsu::DoNotOptimize(less);
+  return ns;
+}
+
+template < class S >
+double StringConcat (const std::vector<S>& s, size_t reps)
+{
+  size_t total = 0;
+  double ns = fsu::BestOf([&]()
+    {
+      for (size_t i = 1; i < s.size(); ++i)
+      {
+        S t = s[i-1] + s[i];
+        total += t.size();
+      }
+    }, reps) / (s.size() - 1);
+  fsu::DoNotOptimize(total);
+  return ns;
+}
+
+// fsu::String speaks Size(); give it the std spelling for the templates above
+struct FsuString : public fsu::String
+{
+  FsuString () {}
+  FsuString (const char* s) : fsu::String(s) {}
+  FsuString (const fsu::String& s) : fsu::String(s) {}
+  size_t size () const { return Size(); }
+};
+
+FsuString operator + (const FsuString& a, const FsuString& b)
+{
+  return FsuString((const fsu::String&)a + (const fsu::String&)b);
+}
+
+//----------------------------------
+//   priority queues
+//----------------------------------
+
+// std::priority_queue spelled like fsu::PriorityQueue
+template < typename T >
+struct StdPQ : public std::priority_queue<T>
+{
+  StdPQ () {}
+  template < class I > StdPQ (I b, I e) : std::priority_queue<T>(b, e) {}
+  void     Push  (const T& t) { this->push(t); }
+  void     Pop   ()           { this->pop(); }
+  const T& Front () const     { return this->top(); }
+  bool     Empty () const     { return this->empty(); }
+  T PushPop (const T& t)
+  {
+    if (this->empty() || !(t < this->top())) return t;
+    T top = this->top();
+    this->pop();
+    this->push(t);
+    return top;
+  }
+} ;
+
+// Push all, then Pop all; returns ns per Push + Pop, checks the pops are in order
+template < class Q , typename T >
+double PQCycle (const std::vector<T>& v, size_t reps, bool& ordered)
+{
+  ordered = true;
+  return fsu::BestOf([&]()
+    {
+      Q q;
+      for (size_t i = 0; i < v.size(); ++i) q.Push(v[i]);
+      T last = q.Front();
+      while (!q.Empty())
+      {
+        if (last < q.Front()) ordered = false;
+        last = q.Front();
+        q.Pop();
+      }
+    }, reps) / v.size();
+}
+
+// heapify the whole range, then pop k
+template < class Q , typename T >
+double PQHeapify (const std::vector<T>& v, size_t k, size_t reps)
+{
+  return fsu::BestOf([&]()
+    {
+      Q q(v.begin(), v.end());
+      for (size_t i = 0; i < k && !q.Empty(); ++i) q.Pop();
+    }, reps) / v.size();
+}
+
+// the k smallest of the stream through PushPop on a k-element max-heap
+template < class Q , typename T >
+double PQTopK (const std::vector<T>& v, size_t k, size_t reps, T& kth)
+{
+  return fsu::BestOf([&]()
+    {
+      Q q;
+      for (size_t i = 0; i < k; ++i) q.Push(v[i]);
+      for (size_t i = k; i < v.size(); ++i) q.PushPop(v[i]);
+      kth = q.Front();
+    }, reps) / v.size();
+}
+
+template < typename T , typename S >
+void ComparePQ (fsu::BenchTable& table, const char* title,
+                const std::vector<T>& fv, const std::vector<S>& sv, size_t reps)
+{
+  typedef fsu::PriorityQueue<T, fsu::Vector<T>, fsu::LessThan<T>, 2> PQ2;
+  typedef fsu::PriorityQueue<T, fsu::Vector<T>, fsu::LessThan<T>, 4> PQ4;
+  size_t k = fv.size() / 100 + 1;
+  bool o2, o4, os;
+  table.Title(title);
+  double s = PQCycle< StdPQ<S> >(sv, reps, os);
+  table.Row("Push + Pop        arity 2", PQCycle<PQ2>(fv, reps, o2), s);
+  table.Row("Push + Pop        arity 4", PQCycle<PQ4>(fv, reps, o4), s);
+  s = PQHeapify< StdPQ<S> >(sv, k, reps);
+  table.Row("heapify + 1% Pop  arity 2", PQHeapify<PQ2>(fv, k, reps), s);
+  table.Row("heapify + 1% Pop  arity 4", PQHeapify<PQ4>(fv, k, reps), s);
+  T t2, t4;
+  S ts;
+  s = PQTopK< StdPQ<S> >(sv, k, reps, ts);
+  table.Row("top 1% PushPop    arity 2", PQTopK<PQ2>(fv, k, reps, t2), s);
+  table.Row("top 1% PushPop    arity 4", PQTopK<PQ4>(fv, k, reps, t4), s);
+  if (!(o2 && o4 && os) || !(t2 == t4))
+    std::cout << " ** PriorityQueue order check FAILED\n";
+}
+
+int main(int argc, char* argv[])
+{
+  size_t n    = (argc > 1) ? atoi(argv[1]) : 200000;
+  size_t reps = (argc > 2) ? atoi(argv[2]) : 3;
+  if (n < 2) n = 2;
+  if (reps < 1) reps = 1;
+
+  std::cout << "Comparative benchmark, n = " << n << ", best of " << reps << '\n';
+  if (fsu::BenchCounters().Available())
+    std::cout << "hardware counters: on\n";
+  else
+    std::cout << "hardware counters: off (" << fsu::BenchCounters().Reason() << ")\n";
+
+  // identical key sets for both sides; absent keys have a length no present key has
+  fsu::Random_String ranstr;
+  fsu::Random_int    ranint;
+  std::vector<fsu::String> fkeys, fabsent;
+  std::vector<std::string> skeys, sabsent;
+  std::vector<uint32_t>    ukeys, uabsent;
+  for (size_t i = 0; i < n; ++i)
+  {
+    fsu::String k = ranstr(ranint(4,12));
+    fkeys.push_back(k);
+    skeys.push_back(k.Cstr());
+    ukeys.push_back((uint32_t)ranint(0,INT_MAX) << 1);  // even
+    fsu::String a = ranstr(13);
+    fabsent.push_back(a);
+    sabsent.push_back(a.Cstr());
+    uabsent.push_back(ukeys.back() | 1);               // odd
+  }
+
+  fsu::BenchTable table;
+
+  CompareMaps < fsu::Map_ADT<fsu::String,int> , std::map<std::string,int> >
+    (table, "Map_ADT<String,int> vs std::map<string,int>", fkeys, fabsent, skeys, sabsent, reps);
+  CompareMaps < fsu::Map_ADT<fsu::String,int> , std::unordered_map<std::string,int> >
+    (table, "Map_ADT<String,int> vs std::unordered_map<string,int>", fkeys, fabsent, skeys, sabsent, reps);
+  CompareMaps < fsu::Map_ADT<uint32_t,int> , std::map<uint32_t,int> >
+    (table, "Map_ADT<uint32_t,int> vs std::map<uint32_t,int>", ukeys, uabsent, ukeys, uabsent, reps);
+
+  CompareFrozen(table, fkeys, fabsent, skeys, sabsent, reps);
+
+  ReportLatency < fsu::Map_ADT<fsu::String,int> > ("Latency: Map_ADT<String,int>", fkeys);
+  ReportLatency < std::map<std::string,int> >     ("Latency: std::map<string,int>", skeys);
+
+  {
+    std::vector<FsuString> fs(fkeys.begin(), fkeys.end());
+    double fb = 0, sb = 0;
+    double fc = StringCopy(fs, reps, fb), sc = StringCopy(skeys, reps, sb);
+    table.Title("String vs std::string");
+    table.Row("copy assign", fc, sc, fb, sb);
+    fsu::PerfSample fp, sp;
+    double fl = StringCompare(fs, reps, fp), sl = StringCompare(skeys, reps, sp);
+    table.Row("operator <", fl, sl);
+    table.Counters(fp, sp, (double)fs.size() - 1, (double)skeys.size() - 1);
+    table.Row("operator +", StringConcat(fs, reps), StringConcat(skeys, reps));
+  }
+
+  {
+    double fb = 0, sb = 0;
+    double fv = VectorBuild<FsuVector>(n, reps, fb), sv = VectorBuild< std::vector<int> >(n, reps, sb);
+    FsuVector fvec;
+    std::vector<int> svec;
+    for (size_t i = 0; i < n; ++i) { fvec.PushBack((int)i); svec.push_back((int)i); }
+    table.Title("Vector<int> vs std::vector<int>");
+    table.Row("PushBack", fv, sv, fb, sb);
+    table.Row("operator []", IndexSum(fvec, n, reps), IndexSum(svec, n, reps));
+  }
+
+  {
+    double fb = 0, sb = 0;
+    double fd = VectorBuild<FsuDeque>(n, reps, fb), sd = VectorBuild< std::deque<int> >(n, reps, sb);
+    FsuDeque fdq;
+    std::deque<int> sdq;
+    for (size_t i = 0; i < n; ++i) { fdq.PushBack((int)i); sdq.push_back((int)i); }
+    table.Title("Deque<int> vs std::deque<int>");
+    table.Row("PushBack", fd, sd, fb, sb);
+    table.Row("operator []", IndexSum(fdq, n, reps), IndexSum(sdq, n, reps));
+    table.Row("queue cycle", FsuQueueCycle(n, reps), StdQueueCycle(n, reps));
+  }
+
+  {
+    double fb = 0, sb = 0;
+    double fl = VectorBuild<FsuList>(n, reps, fb), sl = VectorBuild< std::list<int> >(n, reps, sb);
+    FsuList flst;
+    std::list<int> slst;
+    for (size_t i = 0; i < n; ++i) { flst.PushBack((int)i); slst.push_back((int)i); }
+    table.Title("List<int> vs std::list<int>");
+    table.Row("PushBack", fl, sl, fb, sb);
+    table.Row("iterate", ListScan(flst, n, reps), StdListScan(slst, n, reps));
+  }
+
+  {
+    size_t pn = (n < 1000000) ? 1000000 : n;
+    std::vector<int> pv;
+    for (size_t i = 0; i < pn; ++i) pv.push_back(ranint(0, INT_MAX));
+    ComparePQ(table, "PriorityQueue<int> vs std::priority_queue<int>, n = max(n,1e6)", pv, pv, reps);
+    std::vector<FsuString> fs(fkeys.begin(), fkeys.end());
+    ComparePQ(table, "PriorityQueue<String> vs std::priority_queue<string>", fs, skeys, reps);
+  }
+
+  std::cout << '\n';
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,331 @@
+/*
+    cmmap.cpp
+    10/18/26
+
+    Concurrent random test of SyncMap<String, int> (syncmap.h)
+
+    The multi-threaded counterpart of mmap: T threads run a random mix of
+    Put, Update (read-modify-write through Get), Erase, Retrieve and
+    Includes against one shared map, for T = 1, 2, 4, ... up to the
+    maximum, once with each lock type (SharedLock, ExclusiveLock).
+
+    Thread t writes only its own keys, "t<t>.<i>", but reads the keys of
+    every thread. Each data value carries a 15-bit tag computed from its
+    key in the upper bits, and a counter in the lower 16 bits. That gives
+    two checks:
+
+      torn      every value a reader sees must carry the tag of the key it
+                was read under. A torn or misplaced entry fails this.
+      merge     each thread logs its own writes. After the threads are
+                joined, the logs are applied one thread after another to a
+                plain Map_ADT. The key sets are disjoint, so this sequential
+                merge must equal the shared map's final state exactly, and
+                the shared tree must pass CheckRBLLTFast.
+
+    A last run, at the largest T with SharedLock, has the background
+    compactor (SyncMap::StartCompactor) rebuilding the tree as the erases
+    pile up. Compaction drops tombstones, and with them the data a Get
+    would revive, so in that run Update sets a new value instead of
+    bumping the counter, and is logged as the Put it amounts to.
+
+    Each row reports the wall time of the run, total throughput and the
+    throughput per thread. The latency of each operation, all threads
+    merged, is reported for the largest T with each lock type, and for the
+    compacting run, whose foreground latencies should match those of the
+    plain SharedLock run. On a machine
+    with fewer cores than threads, the threads time-slice, and the checks
+    still apply.
+
+    usage: cmmap [ops per thread = 200000] [max threads = max(4, cores)]
+                 [keys per thread = 4096]
+*/
+
+#include <cstdlib>
+#include <cstdio>      // snprintf
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <syncmap.h>
+#include <histogram.h>
+#include <xstring.h>
+#include <xran.h>
+#include <xstring.cpp>  // in lieu of makefile
+#include <xran.cpp>     // in lieu of makefile
+
+typedef fsu::String KeyType;
+typedef int         DataType;
+
+// operation mix, percent
+const unsigned int putPercent      = 20;
+const unsigned int updatePercent   = 10;
+const unsigned int erasePercent    = 10;
+const unsigned int retrievePercent = 45; // the rest are Includes
+
+enum { PUT, UPDATE, ERASE, RETRIEVE, INCLUDES, NUM_OPS };
+const char* opName[NUM_OPS] = { "Put", "Update", "Erase", "Retrieve", "Includes" };
+
+// the 15-bit tag of a key; data = tag << 16 | counter
+int Tag (const KeyType& k)
+{
+  return (int)(fsu::HashValue(k) >> 49);
+}
+
+DataType Value (const KeyType& k, unsigned counter)
+{
+  return (Tag(k) << 16) | (int)(counter & 0xFFFF);
+}
+
+bool Intact (const KeyType& k, DataType d)
+{
+  return (d >> 16) == Tag(k);
+}
+
+// Update's function: the counter goes up by one
+struct Bump
+{
+  int tag;
+  void operator () (DataType& d) const { d = (tag << 16) | ((d + 1) & 0xFFFF); }
+};
+
+// Update's function while compacting
+struct Set
+{
+  DataType value;
+  void operator () (DataType& d) const { d = value; }
+};
+
+// one logged write
+struct WriteRecord
+{
+  uint8_t  op;
+  uint32_t key;
+  DataType data;
+};
+
+struct Worker
+{
+  std::vector<WriteRecord> log;
+  fsu::LatencyHistogram    hist[NUM_OPS];
+  size_t                   torn;
+  Worker () : torn(0) {}
+};
+
+template < class M >
+void Work (M& map, size_t self, const std::vector< std::vector<KeyType> >& keys,
+           size_t ops, bool compact, Worker& w, std::atomic<bool>& go)
+{
+  fsu::Random_int ran;
+  fsu::LatencyTimer timer;
+  const std::vector<KeyType>& mine = keys[self];
+  size_t threads = keys.size();
+  DataType d;
+  w.log.reserve(ops / 2);
+  while (!go.load())
+    std::this_thread::yield();
+  for (size_t n = 0; n < ops; ++n)
+  {
+    unsigned int p = ran(0,100);
+    if (p < putPercent + updatePercent + erasePercent)
+    {
+      uint32_t i = ran(0, mine.size());
+      const KeyType& k = mine[i];
+      WriteRecord r = { 0, i, 0 };
+      timer.Start();
+      if (p < putPercent)
+      {
+        r.op = PUT;
+        r.data = Value(k, (unsigned)n);
+        map.Put(k, r.data);
+      }
+      else if (p < putPercent + updatePercent)
+      {
+        r.op = UPDATE;
+        if (compact)
+        {
+          r.data = Value(k, (unsigned)n);
+          Set f = { r.data };
+          map.Update(k, f);
+        }
+        else
+        {
+          Bump b = { Tag(k) };
+          map.Update(k, b);
+        }
+      }
+      else
+      {
+        r.op = ERASE;
+        map.Erase(k);
+      }
+      w.hist[r.op].Record(timer.ElapsedNs());
+      if (compact && r.op == UPDATE)
+        r.op = PUT;
+      w.log.push_back(r);
+    }
+    else
+    {
+      const std::vector<KeyType>& theirs = keys[ran(0, threads)];
+      const KeyType& k = theirs[ran(0, theirs.size())];
+      if (p < putPercent + updatePercent + erasePercent + retrievePercent)
+      {
+        timer.Start();
+        bool found = map.Retrieve(k, d);
+        w.hist[RETRIEVE].Record(timer.ElapsedNs());
+        if (found && !Intact(k, d))
+          ++w.torn;
+      }
+      else
+      {
+        timer.Start();
+        map.Includes(k);
+        w.hist[INCLUDES].Record(timer.ElapsedNs());
+      }
+    }
+  }
+}
+
+// applies the logs, one thread after another, to a plain map
+fsu::Map_ADT<KeyType,DataType> Merge (const std::vector<Worker>& workers,
+                                      const std::vector< std::vector<KeyType> >& keys)
+{
+  fsu::Map_ADT<KeyType,DataType> m;
+  for (size_t t = 0; t < workers.size(); ++t)
+  {
+    const std::vector<WriteRecord>& log = workers[t].log;
+    for (size_t i = 0; i < log.size(); ++i)
+    {
+      const KeyType& k = keys[t][log[i].key];
+      switch (log[i].op)
+      {
+        case PUT:    m.Put(k, log[i].data); break;
+        case UPDATE: { Bump b = { Tag(k) }; b(m.Get(k)); } break;
+        case ERASE:  m.Erase(k); break;
+      }
+    }
+  }
+  return m;
+}
+
+template < class L >
+bool Run (size_t threads, size_t ops, size_t perThread, bool latency, bool compact = 0)
+{
+  typedef fsu::SyncMap< KeyType , DataType , fsu::LessThan<KeyType> , L > MapType;
+  std::vector< std::vector<KeyType> > keys(threads);
+  char buf[48];
+  for (size_t t = 0; t < threads; ++t)
+  {
+    for (size_t i = 0; i < perThread; ++i)
+    {
+      snprintf(buf, sizeof(buf), "t%zu.%zu", t, i);
+      keys[t].push_back(KeyType(buf));
+    }
+  }
+
+  MapType map;
+  if (compact)
+    map.StartCompactor(0.05, 1);
+  std::vector<Worker> workers(threads);
+  std::vector<std::thread> pool;
+  std::atomic<bool> go(false);
+  for (size_t t = 0; t < threads; ++t)
+    pool.push_back(std::thread(Work<MapType>, std::ref(map), t, std::cref(keys), ops, compact,
+                               std::ref(workers[t]), std::ref(go)));
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  go.store(true);
+  for (size_t t = 0; t < threads; ++t)
+    pool[t].join();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  map.StopCompactor();
+  std::string name = std::string(L::Name()) + (compact ? "+C" : "");
+
+  size_t torn = 0;
+  for (size_t t = 0; t < threads; ++t)
+    torn += workers[t].torn;
+  fsu::Map_ADT<KeyType,DataType> merged = Merge(workers, keys);
+  bool same  = (map.Snapshot() == merged);
+  bool rbllt = map.Read([](const fsu::Map_ADT<KeyType,DataType>& m) { return m.CheckRBLLTFast(0); });
+  bool ok = same && rbllt && torn == 0;
+
+  double total = double(threads * ops);
+  std::cout << "  " << std::setw(14) << std::left << name << std::right
+            << std::setw(8) << threads
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << sec * 1e3
+            << std::setprecision(3)
+            << std::setw(10) << total / sec / 1e6
+            << std::setw(12) << total / sec / 1e6 / threads
+            << std::setw(8) << map.Size()
+            << std::setw(7) << torn
+            << "  " << (same ? "merge ok" : "MERGE FAILED")
+            << (rbllt ? "" : ", RBLLT FAILED");
+  if (compact)
+    std::cout << ", " << map.Compactions() << " compactions";
+  std::cout << '\n';
+  std::cout.unsetf(std::ios::floatfield);
+
+  if (latency)
+  {
+    std::cout << "  latency, " << threads << " threads, " << name << ":\n";
+    fsu::LatencyHistogram::ReportHeader(std::cout);
+    for (size_t op = 0; op < NUM_OPS; ++op)
+    {
+      fsu::LatencyHistogram h;
+      for (size_t t = 0; t < threads; ++t)
+        h.Merge(workers[t].hist[op]);
+      h.Report(std::cout, opName[op]);
+    }
+    std::cout << '\n';
+  }
+  return ok;
+}
+
+template < class L >
+bool RunAll (size_t maxThreads, size_t ops, size_t perThread)
+{
+  bool ok = 1;
+  for (size_t t = 1; ; t *= 2)
+  {
+    if (t > maxThreads) t = maxThreads;
+    ok = Run<L>(t, ops, perThread, t == maxThreads) && ok;
+    if (t == maxThreads) break;
+  }
+  return ok;
+}
+
+int main(int argc, char* argv[])
+{
+  size_t ops        = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+  size_t maxThreads = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 0;
+  size_t perThread  = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 4096;
+  if (maxThreads == 0)
+  {
+    maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 4) maxThreads = 4;
+  }
+  if (perThread == 0) perThread = 1;
+
+  std::cout << "\nConcurrent random test of SyncMap < String , int >: "
+            << ops << " operations per thread, " << perThread << " keys per thread,\n"
+            << "  mix: Put " << putPercent << "%, Update " << updatePercent
+            << "%, Erase " << erasePercent << "%, Retrieve " << retrievePercent
+            << "%, Includes " << 100 - putPercent - updatePercent - erasePercent - retrievePercent
+            << "%; " << std::thread::hardware_concurrency() << " cores\n\n";
+  std::cout << std::setw(16) << std::left << "  lock" << std::right
+            << std::setw(8)  << "threads"
+            << std::setw(10) << "ms"
+            << std::setw(10) << "Mops/s"
+            << std::setw(12) << "per thread"
+            << std::setw(8)  << "size"
+            << std::setw(7)  << "torn" << '\n';
+  bool ok = RunAll<fsu::SharedLock>(maxThreads, ops, perThread);
+  ok = RunAll<fsu::ExclusiveLock>(maxThreads, ops, perThread) && ok;
+  ok = Run<fsu::SharedLock>(maxThreads, ops, perThread, 1, 1) && ok;
+  std::cout << (ok ? "Test Complete\n" : " ** Test FAILED\n");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,17 +1,29 @@
 /*
     fmap.cpp
     03/02/17
+
+    fmap              commands from the keyboard
+    fmap comfile      commands from comfile, echoed
+    fmap -b comfile   commands from comfile, silent and timed (scriptbench.h)
+
+    fmap -r logfile ...   any of the above, with the map's operations
+                          recorded in logfile (maplog.h), for mreplay
 */
 
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>  // EXIT_FAILURE
 #include <map_adt.h>
+#include <scriptbench.h>
+#include <maplog.h>
 
 // <String, int>
 #include <xstring.h>
 #include <xstring.cpp>  // in lieu of makefile
+#include <tableload.h>
 typedef fsu::String KeyType;
 typedef int         DataType;
 const char fill = '-';
@@ -36,6 +48,23 @@ int CorrectDataWidth(const fsu::String& t, int dw)
   return dw;
 }
 
+// the command type a bench run files each command under
+
+fsu::ScriptBench::Op BenchOp (char command)
+{
+  switch (command)
+  {
+    case '1': case 'p': case 'P':           return fsu::ScriptBench::PUT;
+    case '2': case 'g': case 'G': case '[': return fsu::ScriptBench::GET;
+    case 'e': case 'E':                     return fsu::ScriptBench::ERASE;
+    case 'i': case 'I':                     return fsu::ScriptBench::INCLUDES;
+    case 't': case 'T': case 'd': case 'D': return fsu::ScriptBench::TRAVERSAL;
+    case 'h': case 'H': case 'r': case 'R': return fsu::ScriptBench::REHASH;
+    case 'l': case 'L':                     return fsu::ScriptBench::LOAD;
+    default:                                return fsu::ScriptBench::OTHER;
+  }
+}
+
 void DisplayMenu(std::ostream& os = std::cout);
 
 // copy test
@@ -115,24 +144,50 @@ void AssignTest ( const C& x1 )
 
 int main(int argc, char* argv[])
 {
-  fsu::Map_ADT<KeyType, DataType> map;
+  fsu::MapRecorder< fsu::Map_ADT<KeyType, DataType> > map;
   fsu::Map_ADT<KeyType, DataType>::Iterator mapi;
   fsu::Map_ADT<KeyType, DataType>::ConstIterator mapci;
   bool initited = 0;
   KeyType     key;
   DataType    data;
   char        command;
-  size_t      size, numnodes, nsize, digits, ndigits;
+  size_t      size, numnodes;
   int dw1 = 1, dw2 = 1;
   std::ifstream com;
-  std::ifstream ifs;
+  fsu::TableLoadInfo info;
   std::istream * inptr = &std::cin;
-  bool BATCH = 0;
-  if (argc > 1)
+  bool BATCH = 0, BENCH = 0;
+  fsu::ScriptBench bench;
+  int arg = 1;
+  if (argc > arg + 1 && strcmp(argv[arg], "-r") == 0)
+  {
+    if (!map.Record(argv[arg + 1]))
+    {
+      std::cout << " ** Unable to open log file " << argv[arg + 1] << '\n';
+      return 0;
+    }
+    arg += 2;
+  }
+  if (argc > arg + 1 && strcmp(argv[arg], "-b") == 0)
+  {
+    BATCH = BENCH = 1;
+    if (!bench.Open(argv[arg + 1]))
+    {
+      std::cerr << " ** cannot read script file " << argv[arg + 1] << '\n';
+      return EXIT_FAILURE;
+    }
+    inptr = &bench.Script();
+    bench.Begin();
+  }
+  else if (argc > arg)
   {
     BATCH = 1;
-    com.open(argv[1]);
-    if (com.fail()) return 0;
+    com.open(argv[arg]);
+    if (com.fail())
+    {
+      std::cerr << " ** cannot open command file " << argv[arg] << '\n';
+      return EXIT_FAILURE;
+    }
     inptr = &com;
   }
   if (!BATCH) DisplayMenu();
@@ -140,6 +195,8 @@ int main(int argc, char* argv[])
   {
     std::cout << "command ('M' for menu, 'Q' to quit): ";
     *inptr >> command;
+    if (BENCH && inptr->fail()) break; // script ended without Q
+    if (BENCH) bench.Start(BenchOp(command));
     if (BATCH) std::cout << command;
     switch(command)
     {
@@ -323,6 +380,15 @@ int main(int argc, char* argv[])
           std::cout << "  optimal ht (size)   = " << (size_t)(floor(log2(size))) << '\n';
         if (numnodes > 0)
           std::cout << "  optimal ht (nodes)  = " << (size_t)(floor(log2(numnodes))) << '\n';
+#ifdef MAP_ADT_STATS
+        std::cout << "  map.Stats() since last S:\n";
+        map.Stats().Dump(std::cout);
+        map.ResetStats();
+#endif
+#ifdef MAP_ADT_CHECK
+        std::cout << "  map.CheckStats():\n";
+        map.CheckStats().Dump(std::cout);
+#endif
         break;
       case 'c': case 'C':
         if (BATCH) std::cout << '\n';
@@ -330,7 +396,7 @@ int main(int argc, char* argv[])
         initited = 0;
         break;
       case 'x': case 'X':
-        if (BATCH)
+        if (BATCH && !BENCH)
         {
           std::cout << '\n';
           inptr = &std::cin;
@@ -352,28 +418,13 @@ int main(int argc, char* argv[])
       case 'l': case 'L':
         *inptr >> key;
         if (BATCH) std::cout << ' ' << key << '\n';
-        ifs.open(key.Cstr());
-        if (ifs.fail())
+        if (!fsu::LoadTable(key.Cstr(), map, info))
         {
           std::cout << "  ** Unable to open file " << key << '\n';
-          ifs.clear();
           break;
         }
-        size = 0;
-        digits = 0;
-        while (ifs >> key >> data)
-        {
-          map[key] = data;
-          // map[key] += data;
-          nsize = key.Size();
-          ndigits = 1 + (size_t)log10(data);
-          if (size < nsize) size = nsize;
-          if (digits < ndigits) digits = ndigits;
-        }
-        if (dw1 < (int)size)   dw1 = size;
-        if (dw2 < (int)digits) dw2 = digits;
-        ifs.clear();
-        ifs.close();
+        if (dw1 < (int)info.keyWidth)  dw1 = info.keyWidth;
+        if (dw2 < (int)info.dataWidth) dw2 = info.dataWidth;
         std::cout << "  ** table data read and stored\n";
         initited = 0;
         break;
@@ -382,6 +433,16 @@ int main(int argc, char* argv[])
         map.Rehash();
         initited = 0;
         break;
+      case 'R': case 'r':
+        *inptr >> size;
+        if (BATCH) std::cout << ' ' << size << '\n';
+        map.StartRehash();
+        if (map.RehashStep(size))
+          std::cout << "  ** rehash complete\n";
+        else
+          std::cout << "  ** rehash in progress\n";
+        initited = 0;
+        break;
 
       case 'i': case 'I':
         *inptr >> key;
@@ -452,6 +513,8 @@ int main(int argc, char* argv[])
           case '0': map.CheckRBLLT(0); break;
           case '1': map.CheckRBLLT(1); break;
           case '2': map.CheckRBLLT(2); break;
+          case '3': map.CheckRBLLTFast(1); break;
+          case '4': map.CheckRBLLTFast(1,1,1024); break;
           default: std::cout << " ** undefined command (level 2)\n";
         }
         break;
@@ -474,8 +537,11 @@ int main(int argc, char* argv[])
         // while (command != '\n')
         //   command = *inptr.get(); 
     }
+    if (BENCH) bench.Stop();
   }
   while (command != 'q');
+  if (BENCH) bench.Report(std::cout);
+  FSU_TRACE_DUMP("fmap.trace.json"); // -DFSU_TRACE only
 }
 
 void DisplayMenu(std::ostream& os)
@@ -500,8 +566,10 @@ void DisplayMenu(std::ostream& os)
      << "   x.Dump(cout,ofc,fill) ......... D3\n"
      << "   Size test  .................... S\n"
      << "   Structural test  .............. ! 0 | 1 | 2\n"
+     << "   One-pass / parallel test  ..... ! 3 | 4\n"
      << "   traversal  .................... TF | TR | TL | T!\n"
      << "   Rehash  ....................... H\n"
+     << "   Incremental rehash step ....... R microseconds\n"
      << "   Copy/Assign test .............. =\n"
      << "   switch from batch mode ........ X\n"
      << "   quit program .................. Q\n";
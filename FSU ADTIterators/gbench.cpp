@@ -0,0 +1,508 @@
+/*
+    gbench.cpp
+    10/18/26
+
+    Benchmark of the generic algorithms (genalg.h, pgenalg.h)
+
+    Parallel scaling: each algorithm runs sequentially (genalg.h) and then
+    through fsu::par on pools of 1, 2, 4, ... threads up to the hardware
+    concurrency, over a Vector<int> and a Vector<double> of n elements.
+    Reported per thread count: best-of-reps milliseconds and speedup over
+    the sequential version. Every parallel result is checked against the
+    sequential one; a mismatch is reported and sets the exit status.
+
+    A short run over Deque<int> iterators confirms the parallel versions
+    accept non-pointer random access iterators.
+
+    Block fast paths: g_copy, g_fill and g_fill_n over raw pointers (which
+    lower to memmove / memset / a vectorized loop) against the generic
+    element loop they replace, in ns per element, plus agreement checks
+    for pointer, List and Deque iterators and for overlapping copies.
+
+    Vector kernels (gsimd.h): g_find, g_min_element, g_max_element on
+    int, unsigned, float, double (and char, long for g_find) at every
+    level the CPU has -- scalar, sse2, avx2 -- checked element for element
+    against the plain loops (odd lengths, unaligned starts, duplicate
+    extremes, -0.0, NaN), then ns per element for a cache-resident
+    range (4096) and for n.
+
+    Sorting and searching (gsort.h, gbsearch.h) against std::sort,
+    std::stable_sort, std::nth_element and std::lower_bound on the same
+    data, ns per element (per lookup for searches), with fsu/std ratios;
+    every fsu result is compared with the std one.
+
+    usage: gbench [n = 100000000] [reps = 3]
+*/
+
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+#include <bench.h>
+#include <genalg.h>
+#include <pgenalg.h>
+#include <threadpool.h>
+#include <vector.h>
+#include <deque.h>
+#include <list.h>
+#include <gsimd.h>
+#include <gsort.h>
+#include <gbsearch.h>
+#include <compare.h>
+#include <xstring.h>
+#include <xran.h>
+#include <xranxstr.h>
+#include <xstring.cpp>  // in lieu of makefile
+#include <xran.cpp>     // in lieu of makefile
+#include <xranxstr.cpp> // in lieu of makefile
+
+static bool failed = false;
+
+static void Check (bool ok, const char* what)
+{
+  if (!ok)
+  {
+    std::cout << " ** MISMATCH: " << what << '\n';
+    failed = true;
+  }
+}
+
+template < typename T >
+struct Step   // g_for_each body: a little arithmetic per element
+{
+  void operator () (T& x) const { x = x / 2 + 1; }
+} ;
+
+//----------------------------------
+//   parallel scaling
+//----------------------------------
+
+// one row: sequential time, then time and speedup per pool
+template < class Seq , class Par >
+void ScaleRow (const char* name, Seq seq, Par par, const std::vector<fsu::ThreadPool*>& pools, size_t reps)
+{
+  double s = fsu::BestOf(seq, reps) * 1.0e-6;
+  std::cout << std::setw(16) << std::left << name << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10) << s;
+  for (size_t i = 0; i < pools.size(); ++i)
+  {
+    fsu::ParallelPolicy pol(32768, pools[i]);
+    double p = fsu::BestOf([&]() { par(pol); }, reps) * 1.0e-6;
+    std::cout << std::setw(10) << p << std::setprecision(2) << std::setw(7) << (p > 0 ? s / p : 0.0)
+              << std::setprecision(1);
+  }
+  std::cout << '\n';
+  std::cout.unsetf(std::ios::fixed);
+}
+
+template < typename T >
+void Scaling (const char* title, size_t n, const std::vector<fsu::ThreadPool*>& pools, size_t reps)
+{
+  std::cout << '\n' << title << ", n = " << n << '\n';
+  for (const char* p = title; *p; ++p) std::cout << '-';
+  std::cout << '\n' << std::setw(16) << std::left << "algorithm" << std::right << std::setw(10) << "seq ms";
+  for (size_t i = 0; i < pools.size(); ++i)
+    std::cout << std::setw(6) << pools[i]->Concurrency() << "T ms" << std::setw(7) << "x";
+  std::cout << '\n';
+
+  fsu::Vector<T> a(n), b(n);
+  T* beg = a.Begin();
+  T* end = a.End();
+
+  ScaleRow("g_fill",
+           [&]() { fsu::g_fill(beg, end, (T)1); },
+           [&](const fsu::ParallelPolicy& pol) { fsu::g_fill(pol, beg, end, (T)1); }, pools, reps);
+
+  for (size_t i = 0; i < n; ++i) a[i] = (T)((i * 2654435761u) % 1000003);
+  ScaleRow("g_copy",
+           [&]() { fsu::g_copy(beg, end, b.Begin()); },
+           [&](const fsu::ParallelPolicy& pol) { fsu::g_copy(pol, beg, end, b.Begin()); }, pools, reps);
+  Check(a == b, "g_copy");
+
+  ScaleRow("g_for_each",
+           [&]() { fsu::g_for_each(b.Begin(), b.End(), Step<T>()); },
+           [&](const fsu::ParallelPolicy& pol) { fsu::g_for_each(pol, b.Begin(), b.End(), Step<T>()); }, pools, reps);
+
+  // the only occurrence of the target is the last element: a full scan
+  a[n-1] = (T)-7;
+  T* s = nullptr;
+  T* p = nullptr;
+  ScaleRow("g_find",
+           [&]() { s = fsu::g_find(beg, end, (T)-7); },
+           [&](const fsu::ParallelPolicy& pol) { p = fsu::g_find(pol, beg, end, (T)-7); }, pools, reps);
+  Check(s == p && s == end - 1, "g_find");
+
+  a[n/3] = (T)-9; a[2*n/3] = (T)-9;   // two equal minima: both must report the first
+  ScaleRow("g_min_element",
+           [&]() { s = fsu::g_min_element(beg, end); },
+           [&](const fsu::ParallelPolicy& pol) { p = fsu::g_min_element(pol, beg, end); }, pools, reps);
+  Check(s == p && s == beg + n/3, "g_min_element");
+
+  ScaleRow("g_max_element",
+           [&]() { s = fsu::g_max_element(beg, end); },
+           [&](const fsu::ParallelPolicy& pol) { p = fsu::g_max_element(pol, beg, end); }, pools, reps);
+  Check(s == p, "g_max_element");
+}
+
+// parallel overloads over Deque<T> iterators agree with the sequential ones
+void DequeCheck (size_t n)
+{
+  fsu::Deque<int> d;
+  for (size_t i = 0; i < n; ++i) d.PushBack((int)((i * 40503u) % 65521));
+  d[n - 5] = -1;
+  fsu::ParallelPolicy pol(1024);
+  Check(fsu::g_find(pol, d.Begin(), d.End(), -1) == fsu::g_find(d.Begin(), d.End(), -1), "Deque g_find");
+  Check(fsu::g_min_element(pol, d.Begin(), d.End()) == fsu::g_min_element(d.Begin(), d.End()), "Deque g_min_element");
+  Check(fsu::g_max_element(pol, d.Begin(), d.End()) == fsu::g_max_element(d.Begin(), d.End()), "Deque g_max_element");
+  fsu::g_fill(pol, d.Begin(), d.End(), 5);
+  Check(fsu::g_find_if(pol, d.Begin(), d.End(), [](int x) { return x != 5; }) == d.End(), "Deque g_fill");
+  std::cout << "\nDeque<int> iterators, n = " << n << ": " << (failed ? "FAILED" : "ok") << '\n';
+}
+
+//----------------------------------
+//   block fast paths (g_copy, g_fill)
+//----------------------------------
+
+template < typename T >
+void BlockRows (const char* type, size_t n, size_t reps)
+{
+  fsu::Vector<T> a(n), b(n);
+  for (size_t i = 0; i < n; ++i) a[i] = (T)(i % 101);
+  T* s = a.Begin();
+  T* d = b.Begin();
+  double loop = fsu::BestOf([&]() { fsu::genalg::Copy(s, s + n, d, std::false_type()); }, reps) / n;
+  double fast = fsu::BestOf([&]() { fsu::g_copy(s, s + n, d); }, reps) / n;
+  std::cout << "  g_copy   " << std::setw(8) << std::left << type << std::right << std::fixed
+            << std::setprecision(3) << std::setw(12) << loop << std::setw(12) << fast
+            << std::setprecision(2) << std::setw(9) << (fast > 0 ? loop / fast : 0.0) << '\n';
+  Check(a == b, "g_copy block");
+  loop = fsu::BestOf([&]() { fsu::genalg::Fill(d, d + n, (T)7, std::false_type()); }, reps) / n;
+  fast = fsu::BestOf([&]() { fsu::g_fill(d, d + n, (T)7); }, reps) / n;
+  std::cout << "  g_fill   " << std::setw(8) << std::left << type << std::right
+            << std::setprecision(3) << std::setw(12) << loop << std::setw(12) << fast
+            << std::setprecision(2) << std::setw(9) << (fast > 0 ? loop / fast : 0.0) << '\n';
+  std::cout.unsetf(std::ios::fixed);
+  Check(fsu::g_find_if(d, d + n, [](const T& x) { return x != (T)7; }) == d + n, "g_fill block");
+}
+
+void BlockChecks ()
+{
+  // overlapping copy toward the front: memmove must match the element loop
+  int x[64], y[64];
+  for (int i = 0; i < 64; ++i) x[i] = y[i] = i;
+  fsu::g_copy(x + 8, x + 64, x);
+  fsu::genalg::Copy(y + 8, y + 64, y, std::false_type());
+  Check(fsu::g_find_if(x, x + 64, [&](const int& v) { return v != y[&v - x]; }) == x + 64, "overlapping g_copy");
+
+  // const source, char fill through memset, g_fill_n
+  const int* cx = x;
+  int z[64];
+  fsu::g_copy(cx, cx + 64, z);
+  Check(z[0] == x[0] && z[63] == x[63], "const source g_copy");
+  char c[33];
+  fsu::g_fill_n(c, 32, 'q');
+  c[32] = '\0';
+  Check(fsu::g_find_if(c, c + 32, [](char v) { return v != 'q'; }) == c + 32, "g_fill_n char");
+
+  // non-pointer iterators keep the element loop
+  fsu::List<int> l;
+  fsu::Deque<int> q;
+  for (int i = 0; i < 100; ++i) { l.PushBack(0); q.PushBack(0); }
+  fsu::g_copy(x, x + 64, l.Begin());
+  fsu::g_copy(x, x + 64, q.Begin());
+  fsu::g_fill_n(q.Begin() + 64, 36, -1);
+  fsu::g_fill(l.Begin(), l.End(), 3);
+  Check(q[10] == x[10] && q[63] == x[63] && q[64] == -1 && q[99] == -1, "Deque g_copy / g_fill_n");
+  Check(fsu::g_find_if(l.Begin(), l.End(), [](int v) { return v != 3; }) == l.End(), "List g_fill");
+}
+
+void Blocks (size_t n, size_t reps)
+{
+  std::cout << "\nBlock fast paths, n = " << n << "\n-----------------\n"
+            << "  algo     type       loop ns/e   fast ns/e  speedup\n";
+  BlockRows<char>  ("char",   n, reps);
+  BlockRows<int>   ("int",    n, reps);
+  BlockRows<double>("double", n, reps);
+  BlockChecks();
+}
+
+//----------------------------------
+//   vector kernels (gsimd.h)
+//----------------------------------
+
+// the loops genalg.h used before gsimd.h, as the reference
+template < typename T >
+const T* RefFind (const T* b, const T* e, const T& t)
+{
+  for ( ; b != e; ++b) if (t == *b) return b;
+  return e;
+}
+
+template < typename T >
+const T* RefExtreme (const T* b, const T* e, bool max)
+{
+  if (b == e) return b;
+  const T* x = b;
+  while (++b != e) if (max ? *x < *b : *b < *x) x = b;
+  return x;
+}
+
+template < typename T >
+void SimdCheck (const char* type, fsu::Random_int& ran, bool extremes)
+{
+  std::vector<T> a(4200 + 8);
+  bool ok = true;
+  for (size_t trial = 0; trial < 400 && ok; ++trial)
+  {
+    size_t n = (trial < 300) ? trial % 150 : (size_t)ran(1000, 4200);
+    size_t off = trial % 4;
+    for (size_t i = 0; i < n + off; ++i)
+      a[i] = (T)ran(-20, 20);
+    const T* b = a.data() + off;
+    const T* e = b + n;
+    if (std::is_floating_point<T>::value && n > 0)
+    {
+      if (trial % 7 == 1) a[off + ran(0, (int)n)] = (T)-0.0;
+      if (trial % 11 == 3) a[off + ran(0, (int)n)] = (T)(0.0 / 0.0 * (trial & 1 ? 1 : -1));
+    }
+    T keys[3] = { (T)ran(-20, 20), (T)99, n ? b[n - 1] : (T)0 };
+    for (size_t k = 0; k < 3; ++k)
+      ok = ok && fsu::g_find(b, e, keys[k]) == RefFind(b, e, keys[k]);
+    if (extremes)
+    {
+      ok = ok && fsu::g_min_element(b, e) == RefExtreme(b, e, false);
+      ok = ok && fsu::g_max_element(b, e) == RefExtreme(b, e, true);
+    }
+  }
+  std::cout << ' ' << type << (ok ? "" : "(MISMATCH)");
+  Check(ok, type);
+}
+
+// ns/element of one full scan at each level; the key is absent
+template < typename T >
+void SimdRow (const char* name, size_t n, size_t reps, int top)
+{
+  std::vector<T> a(n);
+  for (size_t i = 0; i < n; ++i) a[i] = (T)((i * 2654435761u) % 1000);
+  a[n / 2] = (T)-3;
+  const T* b = a.data();
+  const T* e = b + n;
+  size_t loops = (n < 100000) ? 10000000 / n : 1;
+  double ns[3][3] = { { 0 } };
+  for (int l = fsu::gsimd::scalar; l <= top; ++l)
+  {
+    fsu::gsimd::SetLevel(l);
+    ns[0][l] = fsu::BestOf([&]() { for (size_t r = 0; r < loops; ++r) fsu::DoNotOptimize(fsu::g_find(b, e, (T)-1)); }, reps) / (n * loops);
+    ns[1][l] = fsu::BestOf([&]() { for (size_t r = 0; r < loops; ++r) fsu::DoNotOptimize(fsu::g_min_element(b, e)); }, reps) / (n * loops);
+    ns[2][l] = fsu::BestOf([&]() { for (size_t r = 0; r < loops; ++r) fsu::DoNotOptimize(fsu::g_max_element(b, e)); }, reps) / (n * loops);
+  }
+  const char* algo[3] = { "g_find", "g_min_element", "g_max_element" };
+  for (int k = 0; k < 3; ++k)
+  {
+    std::cout << "  " << std::setw(14) << std::left << algo[k] << std::setw(8) << name << std::right
+              << std::fixed << std::setprecision(3);
+    for (int l = fsu::gsimd::scalar; l <= top; ++l)
+      std::cout << std::setw(10) << ns[k][l];
+    std::cout << std::setprecision(2) << std::setw(9) << (ns[k][top] > 0 ? ns[k][0] / ns[k][top] : 0.0) << '\n';
+    std::cout.unsetf(std::ios::fixed);
+  }
+}
+
+void Simd (size_t n, size_t reps)
+{
+  int top = fsu::gsimd::Detect();
+  std::cout << "\nVector kernels, CPU level " << fsu::gsimd::LevelName(top) << "\n--------------\n"
+            << "  differential check:";
+  fsu::Random_int ran;
+  for (int l = fsu::gsimd::scalar; l <= top; ++l)
+  {
+    fsu::gsimd::SetLevel(l);
+    std::cout << "\n    " << std::setw(8) << std::left << fsu::gsimd::LevelName(l) << std::right;
+    SimdCheck<char>    ("char",     ran, false);
+    SimdCheck<int>     ("int",      ran, true);
+    SimdCheck<unsigned>("unsigned", ran, true);
+    SimdCheck<long>    ("long",     ran, false);
+    SimdCheck<float>   ("float",    ran, true);
+    SimdCheck<double>  ("double",   ran, true);
+  }
+  std::cout << '\n';
+
+  size_t sizes[2] = { 4096, n };
+  for (size_t s = 0; s < 2; ++s)
+  {
+    std::cout << "\n  n = " << sizes[s] << ", ns/element\n  " << std::setw(22) << std::left << "algorithm" << std::right;
+    for (int l = fsu::gsimd::scalar; l <= top; ++l)
+      std::cout << std::setw(10) << fsu::gsimd::LevelName(l);
+    std::cout << std::setw(9) << "speedup" << '\n';
+    SimdRow<int>   ("int",    sizes[s], reps, top);
+    SimdRow<float> ("float",  sizes[s], reps, top);
+    SimdRow<double>("double", sizes[s], reps, top);
+  }
+  fsu::gsimd::SetLevel(top);
+}
+
+//----------------------------------
+//   sorting and searching
+//----------------------------------
+
+// best ns/element over reps sorts of a fresh copy of src; result left in out
+template < typename T , class F >
+double SortTime (const std::vector<T>& src, std::vector<T>& out, F sort, size_t reps)
+{
+  double best = 0;
+  for (size_t r = 0; r < reps; ++r)
+  {
+    out = src;
+    fsu::Timer t;
+    sort(out.data(), out.data() + out.size());
+    double ns = t.Nanoseconds();
+    if (r == 0 || ns < best) best = ns;
+  }
+  return best / src.size();
+}
+
+template < typename T , class F , class G >
+void SortRow (fsu::BenchTable& table, const char* name, const std::vector<T>& src, F fsort, G ssort, size_t reps)
+{
+  std::vector<T> f, s;
+  double fns = SortTime(src, f, fsort, reps);
+  double sns = SortTime(src, s, ssort, reps);
+  table.Row(name, fns, sns);
+  Check(f == s, name);
+}
+
+struct Keyed   // stability probe: equal keys must keep idx order
+{
+  uint32_t key, idx;
+  bool operator == (const Keyed& k) const { return key == k.key && idx == k.idx; }
+} ;
+
+struct KeyLess
+{
+  bool operator () (const Keyed& a, const Keyed& b) const { return a.key < b.key; }
+} ;
+
+void Sorting (size_t n, size_t reps)
+{
+  fsu::Random_int ranint;
+  fsu::Random_String ranstr;
+  std::vector<int>      vi(n);
+  std::vector<double>   vd(n);
+  std::vector<uint32_t> vu(n);
+  std::vector<Keyed>    vk(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    vi[i] = ranint(-1000000000, 1000000000);
+    vd[i] = vi[i] * 0.001;
+    vu[i] = (uint32_t)ranint(0, INT_MAX) * 2u + (uint32_t)(i & 1);
+    vk[i].key = (uint32_t)ranint(0, 1000);
+    vk[i].idx = (uint32_t)i;
+  }
+  size_t m = n < 1000000 ? n : 1000000;
+  std::vector<fsu::String> vs(m);
+  for (size_t i = 0; i < m; ++i) vs[i] = ranstr(ranint(1, 12));
+
+  typedef int* IP;
+  fsu::BenchTable table;
+  table.Title("Sorting and searching vs std (ns/element)");
+  SortRow(table, "g_sort int", vi,
+          [](IP b, IP e) { fsu::g_sort(b, e); }, [](IP b, IP e) { std::sort(b, e); }, reps);
+  SortRow(table, "g_sort int GreaterThan", vi,
+          [](IP b, IP e) { fsu::g_sort(b, e, fsu::GreaterThan<int>()); },
+          [](IP b, IP e) { std::sort(b, e, std::greater<int>()); }, reps);
+  SortRow(table, "g_sort double", vd,
+          [](double* b, double* e) { fsu::g_sort(b, e); }, [](double* b, double* e) { std::sort(b, e); }, reps);
+  SortRow(table, "g_stable_sort int", vi,
+          [](IP b, IP e) { fsu::g_stable_sort(b, e); }, [](IP b, IP e) { std::stable_sort(b, e); }, reps);
+  SortRow(table, "g_stable_sort keyed", vk,
+          [](Keyed* b, Keyed* e) { fsu::g_stable_sort(b, e, KeyLess()); },
+          [](Keyed* b, Keyed* e) { std::stable_sort(b, e, KeyLess()); }, reps);
+  SortRow(table, "g_radix_sort uint32", vu,
+          [](uint32_t* b, uint32_t* e) { fsu::g_radix_sort(b, e); },
+          [](uint32_t* b, uint32_t* e) { std::sort(b, e); }, reps);
+  SortRow(table, "g_sort String", vs,
+          [](fsu::String* b, fsu::String* e) { fsu::g_sort(b, e); },
+          [](fsu::String* b, fsu::String* e) { std::sort(b, e); }, reps);
+  SortRow(table, "g_radix_sort String", vs,
+          [](fsu::String* b, fsu::String* e) { fsu::g_radix_sort(b, e); },
+          [](fsu::String* b, fsu::String* e) { std::sort(b, e); }, reps);
+
+  {
+    std::vector<int> f, s;
+    size_t k = n / 2;
+    double fns = SortTime(vi, f, [&](IP b, IP e) { fsu::g_nth_element(b, b + k, e); }, reps);
+    double sns = SortTime(vi, s, [&](IP b, IP e) { std::nth_element(b, b + k, e); }, reps);
+    table.Row("g_nth_element (median)", fns, sns);
+    Check(f[k] == s[k] && *std::max_element(f.begin(), f.begin() + k) <= f[k]
+          && *std::min_element(f.begin() + k, f.end()) >= f[k], "g_nth_element");
+  }
+
+  {
+    std::vector<int> sorted(vi);
+    std::sort(sorted.begin(), sorted.end());
+    const int* b = sorted.data();
+    const int* e = b + n;
+    size_t fsum = 0, ssum = 0;
+    double fns = fsu::BestOf([&]()
+      {
+        for (size_t i = 0; i < m; ++i) fsum += fsu::g_lower_bound(b, e, vi[i] + (int)(i & 1)) - b;
+      }, reps) / m;
+    double sns = fsu::BestOf([&]()
+      {
+        for (size_t i = 0; i < m; ++i) ssum += std::lower_bound(b, e, vi[i] + (int)(i & 1)) - b;
+      }, reps) / m;
+    table.Row("g_lower_bound", fns, sns);
+    Check(fsum == ssum, "g_lower_bound");
+    bool ok = true;
+    for (size_t i = 0; i < 1000 && i < n; ++i)
+    {
+      ok = ok && (fsu::g_upper_bound(b, e, vi[i]) == std::upper_bound(b, e, vi[i]));
+      ok = ok && fsu::g_binary_search(b, e, vi[i]) && !fsu::g_binary_search(b, e, 1000000001);
+    }
+    Check(ok, "g_upper_bound / g_binary_search");
+  }
+
+  // Deque iterators through the same templates
+  fsu::Deque<int> d;
+  for (size_t i = 0; i < 5000 && i < n; ++i) d.PushBack(vi[i]);
+  fsu::g_sort(d.Begin(), d.End(), fsu::GreaterThan<int>());
+  bool ok = true;
+  for (size_t i = 1; i < d.Size(); ++i) ok = ok && !(d[i-1] < d[i]);
+  ok = ok && fsu::g_binary_search(d.Begin(), d.End(), d[d.Size() / 2], fsu::GreaterThan<int>());
+  Check(ok, "Deque g_sort / g_binary_search");
+}
+
+int main(int argc, char* argv[])
+{
+  size_t n    = (argc > 1) ? atol(argv[1]) : 100000000;
+  size_t reps = (argc > 2) ? atoi(argv[2]) : 3;
+  if (n < 16) n = 16;
+  if (reps < 1) reps = 1;
+
+  size_t hw = std::thread::hardware_concurrency();
+  if (hw == 0) hw = 1;
+  std::cout << "Generic algorithm benchmark, best of " << reps
+            << ", hardware threads = " << hw << '\n';
+
+  std::vector<fsu::ThreadPool*> pools;   // t threads = t - 1 workers + caller
+  for (size_t t = 1; t < hw; t *= 2)
+    pools.push_back(new fsu::ThreadPool(t - 1));
+  pools.push_back(new fsu::ThreadPool(hw - 1));
+
+  Scaling<int>   ("Vector<int>",    n, pools, reps);
+  Scaling<double>("Vector<double>", n, pools, reps);
+  DequeCheck(n < 1000000 ? n : 1000000);
+  Blocks(n < 10000000 ? n : 10000000, reps);
+  Simd(n < 10000000 ? n : 10000000, reps);
+  Sorting(n < 5000000 ? n : 5000000, reps);
+
+  for (size_t i = 0; i < pools.size(); ++i)
+    delete pools[i];
+  std::cout << '\n';
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
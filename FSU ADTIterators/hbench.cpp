@@ -0,0 +1,175 @@
+/*
+    hbench.cpp
+    10/18/26
+
+    Benchmark of Map_ADT<uint64_t,uint64_t> lookups with and without huge pages
+
+    Builds a map of n random keys three times, putting the keys in the
+    same random order each time:
+
+      heap        nodes from operator new
+      4K pages    nodes from a NodeArena (arena.h) without huge pages
+      huge pages  nodes from a NodeArena with huge pages (MAP_HUGETLB,
+                  else madvise(MADV_HUGEPAGE))
+
+    Each map then answers the same random lookups of present keys through
+    Retrieve(). Each row reports:
+
+      backing     what the arena got from the system (NodeArena::Name)
+      huge MB     AnonHugePages + Hugetlb of the process after the build, from
+                  /proc/self/smaps_rollup: how much the kernel did map huge
+      build ms    the n Puts
+      ns/op       lookups, best of reps over the whole batch
+      p50, p99    latency of single lookups, timed one at a time (LatencyTimer)
+      dTLB, LLC   misses per lookup, from the fastest batch, where
+                  perf_event_open is permitted (perfcount.h)
+
+    Each map is destroyed before the next one is built, so huge MB belongs
+    to the map of its row. The sum of the retrieved data must agree across
+    the rows; a mismatch sets the exit status.
+
+    usage: hbench [n = 4000000] [lookups = 1000000] [reps = 3]
+*/
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <bench.h>
+#include <histogram.h>
+#include <arena.h>
+#include <map_adt.h>
+
+typedef fsu::Map_ADT<uint64_t,uint64_t> MapType;
+
+enum Mode { HEAP, PAGES, HUGEPAGES, NUM_MODES };
+const char* modeName[NUM_MODES] = { "heap", "4K pages", "huge pages" };
+
+static uint64_t SplitMix (uint64_t& s)
+{
+  uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// huge page memory of the process, MB; 0 where /proc/self/smaps_rollup is not readable
+static double HugeMB ()
+{
+  double kb = 0;
+#if defined(__linux__)
+  FILE* f = fopen("/proc/self/smaps_rollup", "r");
+  if (f == nullptr)
+    return 0;
+  char line[256], name[64];
+  unsigned long v;
+  while (fgets(line, sizeof(line), f))   // the first line is the address range
+    if (sscanf(line, "%63s %lu", name, &v) == 2
+        && (strcmp(name, "AnonHugePages:") == 0 || strcmp(name, "Private_Hugetlb:") == 0))
+      kb += v;
+  fclose(f);
+#endif
+  return kb / 1024;
+}
+
+static uint64_t Run (Mode mode, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& probes, size_t reps)
+{
+  MapType map;
+  if (mode != HEAP)
+    map.EnableArena(mode == HUGEPAGES);
+  fsu::Timer t;
+  for (size_t i = 0; i < keys.size(); ++i)
+    map.Put(keys[i], keys[i] >> 7);
+  double buildMs = t.Nanoseconds() * 1.0e-6;
+  double hugeMB = HugeMB();
+
+  const MapType& cm = map;
+  uint64_t sum = 0;
+  fsu::PerfSample sample;
+  double ns = fsu::BestOf([&]()
+    {
+      uint64_t s = 0, d;
+      for (size_t i = 0; i < probes.size(); ++i)
+        if (cm.Retrieve(probes[i], d)) s += d;
+      sum = s;
+    }, reps, sample);
+
+  fsu::LatencyHistogram h;
+  fsu::LatencyTimer timer;
+  uint64_t d;
+  for (size_t i = 0; i < probes.size(); ++i)
+  {
+    timer.Start();
+    cm.Retrieve(probes[i], d);
+    h.Record(timer.ElapsedNs());
+    fsu::DoNotOptimize(d);
+  }
+
+  std::cout << "  " << std::setw(12) << std::left << modeName[mode]
+            << std::setw(10) << (map.Arena() ? fsu::NodeArena::Name(map.Arena()->Backing()) : "-") << std::right
+            << std::fixed << std::setprecision(1)
+            << std::setw(9)  << hugeMB
+            << std::setw(10) << buildMs
+            << std::setw(9)  << ns / probes.size()
+            << std::setw(8)  << h.Percentile(50.0)
+            << std::setw(8)  << h.Percentile(99.0);
+  std::cout << std::setprecision(2);
+  if (sample.Valid(fsu::PerfCounters::dtlbMisses))
+    std::cout << std::setw(8) << sample.PerOp(fsu::PerfCounters::dtlbMisses, (double)probes.size());
+  else
+    std::cout << std::setw(8) << "-";
+  if (sample.Valid(fsu::PerfCounters::llcMisses))
+    std::cout << std::setw(8) << sample.PerOp(fsu::PerfCounters::llcMisses, (double)probes.size());
+  else
+    std::cout << std::setw(8) << "-";
+  std::cout << '\n';
+  std::cout.unsetf(std::ios::fixed);
+  return sum;
+}
+
+int main(int argc, char* argv[])
+{
+  size_t n    = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 4000000;
+  size_t q    = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000000;
+  size_t reps = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 3;
+  if (n == 0) n = 1;
+  if (reps == 0) reps = 1;
+
+  uint64_t seed = 20261018;
+  std::vector<uint64_t> keys(n), probes(q);
+  for (size_t i = 0; i < n; ++i)
+    keys[i] = SplitMix(seed);
+  for (size_t i = 0; i < q; ++i)
+    probes[i] = keys[SplitMix(seed) % n];
+
+  std::cout << "\nMap_ADT < uint64_t , uint64_t >: " << n << " keys, " << q << " lookups, best of " << reps
+            << "; huge page size " << fsu::NodeArena::HugePageSize() / 1024 << " KiB\n";
+  if (!fsu::BenchCounters().Available())
+    std::cout << "  no hardware counters: " << fsu::BenchCounters().Reason() << '\n';
+  std::cout << "  " << std::setw(12) << std::left << "nodes" << std::setw(10) << "backing" << std::right
+            << std::setw(9)  << "huge MB"
+            << std::setw(10) << "build ms"
+            << std::setw(9)  << "ns/op"
+            << std::setw(8)  << "p50"
+            << std::setw(8)  << "p99"
+            << std::setw(8)  << "dTLB"
+            << std::setw(8)  << "LLC" << '\n';
+  bool ok = true;
+  uint64_t sum = 0;
+  for (int m = 0; m < NUM_MODES; ++m)
+  {
+    uint64_t s = Run((Mode)m, keys, probes, reps);
+    if (m == 0)
+      sum = s;
+    else if (s != sum)
+    {
+      std::cout << " ** MISMATCH: " << modeName[m] << " lookups disagree with the heap map\n";
+      ok = false;
+    }
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,188 @@
+/*
+    lbench.cpp
+    10/18/26
+
+    Benchmark of Map_ADT<uint64_t,uint64_t> node layouts after churn
+
+    Builds a map of n random keys on the heap, then churns it: each of
+    the rounds erases n/2 random keys, puts n/2 new ones and Rehash()es,
+    so the nodes end up wherever the allocator had room. Then the same
+    tree, with the same shape throughout, is timed in each layout:
+
+      churned      the heap nodes as the churn left them
+      preorder     EnableArena(): the nodes copied into an arena (arena.h) in preorder
+      levelorder   Relayout(LEVELORDER)
+      veb          Relayout(VEB), van Emde Boas order
+      inorder      Relayout(INORDER)
+
+    Each row reports:
+
+      lookup ns    per Retrieve() of a random present key, best of reps
+      walk ns      per entry of a ConstIterator walk over the map, best of reps
+      L1d, dTLB    misses per lookup and per entry walked, where
+                   perf_event_open is permitted (perfcount.h)
+
+    The arena rows use huge pages unless the fourth argument is 0, so the
+    preorder row separates what the arena gives from what the order gives.
+    The height, node count, lookup sum and walk sum must stay the same, and
+    the tree must pass CheckRBLLTFast, after every relayout; a mismatch sets
+    the exit status.
+
+    usage: lbench [n = 2000000] [rounds = 4] [reps = 3] [huge pages = 1]
+*/
+
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <bench.h>
+#include <map_adt.h>
+
+typedef fsu::Map_ADT<uint64_t,uint64_t> MapType;
+
+static bool failed = false;
+
+static void Check (bool ok, const char* what)
+{
+  if (!ok)
+  {
+    std::cout << " ** MISMATCH: " << what << '\n';
+    failed = true;
+  }
+}
+
+static uint64_t SplitMix (uint64_t& s)
+{
+  uint64_t z = (s += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+struct Baseline
+{
+  int      height;
+  size_t   nodes;
+  uint64_t lookupSum, walkSum;
+} ;
+
+static void Misses (const fsu::PerfSample& s, double ops)
+{
+  const size_t events[] = { fsu::PerfCounters::l1dMisses, fsu::PerfCounters::dtlbMisses };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    if (s.Valid(events[i]))
+      std::cout << std::setw(8) << s.PerOp(events[i], ops);
+    else
+      std::cout << std::setw(8) << "-";
+  }
+}
+
+static void Row (const char* name, const MapType& m, const std::vector<uint64_t>& probes, size_t reps,
+                 Baseline& base, bool first)
+{
+  uint64_t lookupSum = 0, walkSum = 0;
+  size_t entries = 0;
+  fsu::PerfSample ls, ws;
+  double lns = fsu::BestOf([&]()
+    {
+      uint64_t s = 0, d;
+      for (size_t i = 0; i < probes.size(); ++i)
+        if (m.Retrieve(probes[i], d)) s += d;
+      lookupSum = s;
+    }, reps, ls);
+  double wns = fsu::BestOf([&]()
+    {
+      uint64_t s = 0;
+      size_t c = 0;
+      for (MapType::ConstIterator i = m.Begin(); i != m.End(); ++i, ++c)
+        s += (*i).data_;
+      walkSum = s;
+      entries = c;
+    }, reps, ws);
+
+  if (first)
+  {
+    base.height = m.Height();
+    base.nodes = m.NumNodes();
+    base.lookupSum = lookupSum;
+    base.walkSum = walkSum;
+  }
+  else
+  {
+    Check(m.Height() == base.height && m.NumNodes() == base.nodes, "the shape changed");
+    Check(lookupSum == base.lookupSum, "lookups disagree");
+    Check(walkSum == base.walkSum, "the walk disagrees");
+    Check(m.CheckRBLLTFast(0), "CheckRBLLTFast failed");
+  }
+
+  std::cout << "  " << std::setw(12) << std::left << name << std::right
+            << std::setw(10) << (m.Arena() ? fsu::NodeArena::Name(m.Arena()->Backing()) : "-")
+            << std::fixed << std::setprecision(1)
+            << std::setw(11) << lns / probes.size()
+            << std::setw(9)  << (entries ? wns / entries : 0.0);
+  std::cout << std::setprecision(2);
+  Misses(ls, (double)probes.size());
+  Misses(ws, (double)entries);
+  std::cout << '\n';
+  std::cout.unsetf(std::ios::fixed);
+}
+
+int main(int argc, char* argv[])
+{
+  size_t n      = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 2000000;
+  size_t rounds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4;
+  size_t reps   = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 3;
+  bool   huge   = (argc > 4) ? strtoul(argv[4], nullptr, 10) != 0 : true;
+  if (n < 2) n = 2;
+  if (reps == 0) reps = 1;
+
+  uint64_t seed = 20261018;
+  std::vector<uint64_t> keys(n);
+  MapType map;
+  for (size_t i = 0; i < n; ++i)
+  {
+    keys[i] = SplitMix(seed);
+    map.Put(keys[i], keys[i] >> 7);
+  }
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    for (size_t i = 0; i < n / 2; ++i)
+    {
+      size_t j = SplitMix(seed) % n;
+      map.Erase(keys[j]);
+      keys[j] = SplitMix(seed);
+      map.Put(keys[j], keys[j] >> 7);
+    }
+    map.Rehash();
+  }
+  std::vector<uint64_t> probes(n / 2);
+  for (size_t i = 0; i < probes.size(); ++i)
+    probes[i] = keys[SplitMix(seed) % n];
+
+  std::cout << "\nMap_ADT < uint64_t , uint64_t >: " << map.Size() << " entries after " << rounds
+            << " rounds of churn, " << probes.size() << " lookups, best of " << reps << '\n';
+  if (!fsu::BenchCounters().Available())
+    std::cout << "  no hardware counters: " << fsu::BenchCounters().Reason() << '\n';
+  std::cout << "  " << std::setw(12) << std::left << "layout" << std::right
+            << std::setw(10) << "backing"
+            << std::setw(11) << "lookup ns"
+            << std::setw(9)  << "walk ns"
+            << std::setw(16) << "lookup L1d/dTLB"
+            << std::setw(16) << "walk L1d/dTLB" << '\n';
+
+  Baseline base;
+  Row("churned", map, probes, reps, base, true);
+  map.EnableArena(huge);
+  Row("preorder", map, probes, reps, base, false);
+  const MapType::Layout orders[] = { MapType::LEVELORDER, MapType::VEB, MapType::INORDER };
+  const char* names[] = { "levelorder", "veb", "inorder" };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    map.Relayout(orders[i]);
+    Row(names[i], map, probes, reps, base, false);
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
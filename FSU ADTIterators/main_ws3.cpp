@@ -10,6 +10,12 @@
 #include <cctype>
 #include <iostream>
 #include <fstream>
+#include <trace.h>
+#include <memtrack.h>
+
+#ifdef FSU_MEMTRACK
+FSU_MEMTRACK_INSTALL_OPERATORS // heap totals in ShowSummary()
+#endif
 
 void  DisplayMenu ();
 
@@ -103,6 +109,33 @@ int main( int argc, char* argv[] )
         ifs.clear();
         break;
 
+      case 't':
+        std::cout << "  Enter stopword file name ('-' for none): ";
+        *isptr >> filename;
+        if (BATCH) std::cout << filename << '\n';
+        if (filename == "-")
+        {
+          ws.ClearStopwords();
+          std::cout << "\n     Stopwords cleared\n";
+          break;
+        }
+        while (!ws.LoadStopwords(filename))
+        {
+          std::cout << "    ** Cannot load stopwords from " << filename << '\n'
+                    << "    Try another file name: ";
+          *isptr >> filename;
+          if (BATCH) std::cout << filename << '\n';
+        }
+        break;
+
+      case 'T':
+        std::cout << "  Enter file name: ";
+        *isptr >> filename;
+        if (BATCH) std::cout << filename << '\n';
+        if (!ws.SaveStopwords(filename))
+          std::cout << "    ** No stopwords loaded, or cannot write " << filename << '\n';
+        break;
+
       case 'c': case 'C':
         ws.ClearData();
         std::cout << "\n     Current data erased\n";
@@ -143,6 +176,7 @@ int main( int argc, char* argv[] )
     }
   }
   while (selection != 'q');
+  FSU_TRACE_DUMP("ws3.trace.json"); // -DFSU_TRACE only
 
   std::cout << "\nWordSmith wishes you a nice day." << std::endl;
   return EXIT_SUCCESS;
@@ -158,6 +192,8 @@ void DisplayMenu()
             << "     show summary  ........................  's'\n"
             << "     write report  ........................  'w'\n"
             << "     show last report file to screen ......  'f'\n"
+            << "     load stopwords ('-' clears)  .........  't'\n"
+            << "     write stopwords as frozen dictionary .  'T'\n"
             << "     clear current data  ..................  'c'\n"
             << "     exit BATCH mode  .....................  'x'\n"
             << "     display menu  ........................  'm'\n"
@@ -4,6 +4,7 @@
   bool Map_ADT<K,D,P>::CheckBST(bool verboseFlag) const
   // Checks the order conditions for BST.
   // Note this implicitly also checks unimodality - there are no duplicate entries.
+  // During an incremental rehash only the new tree is checked.
   {
     if (root_ == nullptr) return 1;
     ConstIterator i,j,k;
@@ -43,6 +44,7 @@
   template <typename K, typename D, class P>
   bool Map_ADT<K,D,P>::CheckRBLLT (int verboseFlag) const
   // 0 = no output, 1 = messages, 2 = messages & data
+  // During an incremental rehash only the new tree is checked.
   {
     if (this->root_ == nullptr) return 1;
 
@@ -183,5 +185,206 @@
     return ok;
   } // CheckRBLLT()
 
+  template <typename K, typename D, class P>
+  bool Map_ADT<K,D,P>::CheckRBLLTFast (int verboseFlag, bool parallel, size_t grain, ThreadPool* pool) const
+  // The checks of CheckBST and CheckRBLLT in one postorder pass: each node
+  // is compared with the key bounds inherited from its ancestors, and
+  // black heights are combined bottom-up. O(n) time, O(height) stack.
+  // During an incremental rehash only the new tree is checked.
+  // 0 = no output, 1 = messages and counts
+  {
+    FSU_TRACE_SCOPE("Map::CheckRBLLTFast");
+    CheckSummary s;
+    if (parallel)
+    {
+      ThreadPool& tp = pool ? *pool : ThreadPool::Default();
+      s = RParallelCheck(root_, nullptr, nullptr, RBlackHeight(root_), grain, tp);
+    }
+    else
+      s = RCheckFast(root_, nullptr, nullptr);
+    if (s.bad == nullptr && root_ != nullptr && !root_->IsBlack())
+    {
+      s.bad = root_;
+      s.property = 2;
+    }
+    if (s.bad == nullptr && s.height > 2 * s.black)
+    {
+      s.bad = root_;
+      s.property = 6;
+    }
+    if (s.bad != nullptr)
+    {
+      static const char* what[7] =
+      {
+        "out of order with an ancestor", "",
+        "root is not black",
+        "red with a red left child",
+        "black counts of its two subtrees differ",
+        "red right child",
+        "height exceeds twice the black height"
+      };
+      std::cout << "  ** CheckRBLLTFast: property " << s.property << " failure at "
+                << s.bad->value_ << ": " << what[s.property] << '\n';
+      return 0;
+    }
+    if (verboseFlag)
+    {
+      std::cout << "  ** CheckRBLLTFast: nodes = " << s.nodes << ", dead = " << s.dead
+                << ", height = " << s.height - 1 << ", black height = " << s.black << '\n'
+                << "  ** CheckRBLLTFast: OK\n";
+    }
+    return 1;
+  } // CheckRBLLTFast()
+
+  template <typename K, typename D, class P>
+  typename Map_ADT<K,D,P>::CheckSummary Map_ADT<K,D,P>::RCheckFast (const Node* n, const K* lo, const K* hi) const
+  {
+    if (n == nullptr)
+    {
+      CheckSummary s = { 0, 0, 0, 0, nullptr, 0 };
+      return s;
+    }
+    const K& k = n->value_.key_;
+    CheckSummary l = RCheckFast(n->lchild_, lo, &k);
+    CheckSummary r = RCheckFast(n->rchild_, &k, hi);
+    return Join(n, lo, hi, l, r);
+  }
+
+  template <typename K, typename D, class P>
+  typename Map_ADT<K,D,P>::CheckSummary Map_ADT<K,D,P>::RParallelCheck
+    (const Node* n, const K* lo, const K* hi, int bh, size_t grain, ThreadPool& pool) const
+  // bh is only a size estimate for splitting; the check does not trust it
+  {
+    if (n == nullptr || !Splittable(bh, grain))
+      return RCheckFast(n, lo, hi);
+    if (n->IsBlack()) --bh;
+    const K& k = n->value_.key_;
+    CheckSummary l;
+    TaskGroup g(pool);
+    g.Run([&]() { l = RParallelCheck(n->lchild_, lo, &k, bh, grain, pool); });
+    CheckSummary r = RParallelCheck(n->rchild_, &k, hi, bh, grain, pool);
+    g.Wait();
+    return Join(n, lo, hi, l, r);
+  }
+
+  template <typename K, typename D, class P>
+  typename Map_ADT<K,D,P>::CheckSummary Map_ADT<K,D,P>::Join
+    (const Node* n, const K* lo, const K* hi, const CheckSummary& l, const CheckSummary& r) const
+  // the summary of n from those of its subtrees; pred_ rather than Less()
+  // so that parallel checks do not share the comparison counter
+  {
+    CheckSummary s;
+    s.nodes    = l.nodes + r.nodes + 1;
+    s.dead     = l.dead + r.dead + (n->IsDead() ? 1 : 0);
+    s.height   = 1 + (l.height < r.height ? r.height : l.height);
+    s.black    = l.black + (n->IsBlack() ? 1 : 0);
+    s.bad      = l.bad;
+    s.property = l.property;
+    if (s.bad != nullptr)
+      return s;
+    const K& k = n->value_.key_;
+    s.bad = n;
+    if ((lo != nullptr && !pred_(*lo, k)) || (hi != nullptr && !pred_(k, *hi)))
+      s.property = 0;
+    else if (n->RightChildIsRed())
+      s.property = 5;
+    else if (n->IsRed() && n->LeftChildIsRed())
+      s.property = 3;
+    else if (l.black != r.black)
+      s.property = 4;
+    else
+    {
+      s.bad      = r.bad;
+      s.property = r.property;
+    }
+    return s;
+  }
+
+
 
 
+#ifdef MAP_ADT_CHECK
+  template <typename K, typename D, class P>
+  bool Map_ADT<K,D,P>::CheckPath (const K& k) const
+  // the RBLLT properties at every node on the path to k and on the left
+  // spine below it, and the black count of that root-null path
+  {
+    const Node* n = root_;
+    if (n == nullptr) return 1;
+    if (!n->IsBlack()) return 0;
+    const K* lo = nullptr;
+    const K* hi = nullptr;
+    int  black = 0;
+    bool below = 0;      // past k: going down the left spine
+    while (n != nullptr)
+    {
+      const K& nk = n->value_.key_;
+      if ((lo != nullptr && !pred_(*lo, nk)) || (hi != nullptr && !pred_(nk, *hi)))
+        return 0;
+      if (n->RightChildIsRed() || (n->IsRed() && n->LeftChildIsRed()))
+        return 0;
+      if (n->IsBlack()) ++black;
+      if (!below && pred_(nk, k))
+      {
+        lo = &nk;
+        n = n->rchild_;
+      }
+      else
+      {
+        below = below || !pred_(k, nk);
+        hi = &nk;
+        n = n->lchild_;
+      }
+    }
+    return black == RBlackHeight(root_);
+  } // CheckPath()
+
+  template <typename K, typename D, class P>
+  void Map_ADT<K,D,P>::Checked (const char* op, const K& k)
+  {
+    ++check_.operations;
+    ++check_.pathChecks;
+    if (!CheckPath(k))
+    {
+      ++check_.failures;
+      std::cerr << "  ** Map_ADT check: RBLLT property broken on the path to " << k << " after " << op << '\n';
+    }
+    if (check_.FullDue())
+    {
+      const Map_ADT* self = this;
+      check_.Start([self]() { return self->CheckRBLLTFast(0); });
+    }
+  } // Checked()
+#endif
+
+#ifdef MAP_ADT_DIGEST
+  template <typename K, typename D, class P>
+  bool Map_ADT<K,D,P>::CheckDigest (bool verboseFlag) const
+  // recomputes every subtree digest and compares it with the stored sum_;
+  // a stale map has nothing to compare and passes
+  {
+    if (digestStale_)
+    {
+      if (verboseFlag) std::cout << "  ** CheckDigest: stale, not checked\n";
+      return 1;
+    }
+    Refresh(); //the writes through lent references
+    bool ok = 1;
+    RCheckDigest(root_, ok);
+    if (ok && verboseFlag) std::cout << "  ** CheckDigest: OK\n";
+    return ok;
+  } // CheckDigest()
+
+  template <typename K, typename D, class P>
+  uint64_t Map_ADT<K,D,P>::RCheckDigest (const Node* n, bool& ok)
+  {
+    if (n == nullptr) return 0;
+    uint64_t s = Own(n) + RCheckDigest(n->lchild_, ok) + RCheckDigest(n->rchild_, ok);
+    if (s != n->sum_)
+    {
+      ok = 0;
+      std::cout << "  ** CheckDigest: stored subtree digest wrong at key " << n->value_.key_ << '\n';
+    }
+    return s;
+  }
+#endif
@@ -22,7 +22,9 @@
 #include <vector.h>
 #include <list.h>
 #include <entry.h>
-#include <debug.h>     // argh
+#include <trace.h>     // FSU_TRACE_*(): compiled in with -DFSU_TRACE
+#include <map_stats.h> // MAP_STAT(): dead-node skips are counted here
+#include <map_digest.h> // MAP_DIGEST(): entries written through an iterator are reported
 
 #ifndef _MAPITER_ADT_H
 #define _MAPITER_ADT_H
@@ -61,13 +63,16 @@ namespace fsu
   private: // inner sanctum
     friend C; //needed for nodes, etc
     fsu::Queue < Node* > que_; // default is deque-based
+#ifdef MAP_ADT_STATS
+    MapStats* stats_; // owning map's counters, set by C
+#endif
 
   public:
     // first class
-    LevelorderMapIterator                 () : que_() {}
+    LevelorderMapIterator                 () : que_() { MAP_STAT(stats_ = nullptr;) }
     virtual  ~LevelorderMapIterator       () { que_.Clear(); }
-    LevelorderMapIterator                 (const LevelorderMapIterator& i) : que_(i.que_) {}
-    LevelorderMapIterator<C>&  operator=  (const LevelorderMapIterator& i) { que_ = i.que_; return *this; }
+    LevelorderMapIterator                 (const LevelorderMapIterator& i) : que_(i.que_) { MAP_STAT(stats_ = i.stats_;) }
+    LevelorderMapIterator<C>&  operator=  (const LevelorderMapIterator& i) { que_ = i.que_; MAP_STAT(stats_ = i.stats_;) return *this; }
 
     // information/access
     bool  Valid   () const { return !que_.Empty(); } // Iterator can be de-referenced
@@ -120,7 +125,10 @@ namespace fsu
       if (n == nullptr) return;
       que_.Push(n);
       while (!que_.Empty() && que_.Front()->IsDead()) //if the front item is a deaad node
+      {
+          MAP_STAT(if (stats_) ++stats_->deadSkips;)
           Increment();
+      }
   }
 
     
@@ -139,11 +147,12 @@ namespace fsu
   template < class C >
   LevelorderMapIterator<C>&  LevelorderMapIterator<C>::operator++ ()
   {
-      do
+      Increment();
+      while (Valid() && que_.Front()->IsDead())
       {
+          MAP_STAT(if (stats_) ++stats_->deadSkips;)
           Increment();
       }
-      while (Valid() && que_.Front()->IsDead());
       return *this;
   }
 
@@ -171,23 +180,33 @@ namespace fsu
 
   protected: // inner sanctum; keep stack implementation choice compatible w ChechRBLLT
     friend C;
+    typedef fsu::Stack < Node* , fsu::Vector < Node* > > StackType;
     // fsu::Stack < Node* > stk_; // default is deque-based - better safety & error detection
-    fsu::Stack < Node* , fsu::Vector < Node* > > stk_; // faster
+    StackType stk_; // faster
+    // While the map is rehashing (C::StartRehash) an iterator walks both trees at once:
+    // stk_ is at the least new-tree key >= the entry, old_ at the least key left in the
+    // old tree >= the entry, and the entry is the lesser of the two; on a tie the new
+    // tree's node hides the old one. map_ is nullptr otherwise, and old_ empty.
+    StackType  old_;
+    const C*   map_;
+#ifdef MAP_ADT_STATS
+    MapStats* stats_; // owning map's counters, set by C
+#endif
 
   public:
     // first class
-    ConstInorderMapIterator                 () : stk_() {}
+    ConstInorderMapIterator                 () : stk_(), old_(), map_(nullptr) { MAP_STAT(stats_ = nullptr;) }
     virtual  ~ConstInorderMapIterator       () { stk_.Clear(); }
-    ConstInorderMapIterator                 (const ConstInorderMapIterator& i) : stk_(i.stk_) {}
-    ConstInorderMapIterator<C>&  operator=  (const ConstInorderMapIterator& i) { stk_ = i.stk_; return *this; }
+    ConstInorderMapIterator                 (const ConstInorderMapIterator& i) : stk_(i.stk_), old_(i.old_), map_(i.map_) { MAP_STAT(stats_ = i.stats_;) }
+    ConstInorderMapIterator<C>&  operator=  (const ConstInorderMapIterator& i) { stk_ = i.stk_; old_ = i.old_; map_ = i.map_; MAP_STAT(stats_ = i.stats_;) return *this; }
 
     // information/access
-    bool  Valid   () const { return !stk_.Empty(); } // Iterator can be de-references
+    bool  Valid   () const { return !stk_.Empty() || !old_.Empty(); } // Iterator can be de-references
 
     // various operators
-    bool                         operator== (const ConstInorderMapIterator& i2) const { return stk_ == i2.stk_; }
+    bool                         operator== (const ConstInorderMapIterator& i2) const { return stk_ == i2.stk_ && old_ == i2.old_; }
     bool                         operator!= (const ConstInorderMapIterator& i2) const { return !(*this == i2); }
-    const EntryType&             operator*  () const { return stk_.Top()->value_; }
+    const EntryType&             operator*  () const { return Top()->value_; }
     ConstInorderMapIterator<C>&  operator++ ();    // prefix
     ConstInorderMapIterator<C>   operator++ (int); // postfix
     ConstInorderMapIterator<C>&  operator-- ();    // prefix
@@ -196,12 +215,26 @@ namespace fsu
     // developers helper
     void Dump( std::ostream& os = std::cout , char ofc = '\0' ) const;
 
+  protected:
+    Node* Top () const; // the node at the current position
+
   private:
     void Init      (Node* n); // live nodes only
     void sInit     (Node* n); // structural (all nodes) version - pair with Increment for structural traversal
     void rInit     (Node* n); // live nodes only
     void Increment (); // structural version of ++
     void Decrement (); // structural version of --
+
+    // both trees of a rehashing map m; see old_ above
+    void mInit     (const C* m);                               // live nodes only
+    void mrInit    (const C* m);                               // live nodes only
+    void mSeek     (const C* m, const typename C::KeyType& k); // structural: the least key >= k
+    static void Next    (StackType& s); // the inorder successor in a tree
+    static void Prev    (StackType& s); // the inorder predecessor in a tree
+    void        OldPrev (StackType& s) const;
+    void        NewLast (StackType& s) const;
+    void        OldLast (StackType& s) const;
+    bool        Before  (const StackType& a, const StackType& b) const; // a's key < b's key
   };
 
   template < class C >
@@ -262,7 +295,10 @@ namespace fsu
       stk_.Push(n);
     }
     while (Valid() && stk_.Top()->IsDead())
+    {
+      MAP_STAT(if (stats_) ++stats_->deadSkips;)
       Increment();
+    }
   }
 
 
@@ -279,77 +315,290 @@ namespace fsu
           stk_.Push(n);
       }
       while (Valid() && stk_.Top()->IsDead())
+      {
+          MAP_STAT(if (stats_) ++stats_->deadSkips;)
           Decrement();
+      }
   }
     
 
   template < class C >
-  void ConstInorderMapIterator<C>::Increment()
+  void ConstInorderMapIterator<C>::Next(StackType& stk)
   {
-    // fsu::Debug("Increment()");
-    if ( stk_.Empty() )
+    FSU_TRACE_SCOPE("MapIterator::Increment");
+    if ( stk.Empty() )
       return;
     Node * n;
-    if ( stk_.Top()->HasRightChild() )
+    if ( stk.Top()->HasRightChild() )
     {
-      // fsu::Debug("Increment branch 1");
-      n = stk_.Top()->rchild_;
-      stk_.Push(n);
+      FSU_TRACE_EVENT("Increment branch 1", 0);
+      n = stk.Top()->rchild_;
+      stk.Push(n);
       while ( n != nullptr && n->HasLeftChild() )
       {
         n = n->lchild_;
-        stk_.Push(n);
+        stk.Push(n);
       }
     }
     else
     {
-      // fsu::Debug("Increment branch 2");
+      FSU_TRACE_EVENT("Increment branch 2", 0);
       do
       {
-        n = stk_.Top();
-        stk_.Pop();
+        n = stk.Top();
+        stk.Pop();
       }
-      while( !stk_.Empty() && stk_.Top()->HasRightChild() && n == stk_.Top()->rchild_ );
+      while( !stk.Empty() && stk.Top()->HasRightChild() && n == stk.Top()->rchild_ );
     }
   }
 
     
   template < class C >
-  void ConstInorderMapIterator<C>::Decrement()
+  void ConstInorderMapIterator<C>::Prev(StackType& stk)
   {
-      if ( stk_.Empty() )
+      if ( stk.Empty() )
           return;
       Node * n;
-      if ( stk_.Top()->HasLeftChild() ) //if the stack has a left child, go left and slide down right
+      if ( stk.Top()->HasLeftChild() ) //if the stack has a left child, go left and slide down right
       {                                 // as far as possible
-          n = stk_.Top()->lchild_;
-          stk_.Push(n);
+          n = stk.Top()->lchild_;
+          stk.Push(n);
           while (n != nullptr && n->HasRightChild() )
           {
               n = n->rchild_;
-              stk_.Push(n);
+              stk.Push(n);
           }
       }
       else //if the top item in stack does not have a left child
       {
           do
           {
-              n = stk_.Top();
-              stk_.Pop();
+              n = stk.Top();
+              stk.Pop();
           }
-          while ( !stk_.Empty() && stk_.Top()->HasLeftChild() && n == stk_.Top()->lchild_ );
+          while ( !stk.Empty() && stk.Top()->HasLeftChild() && n == stk.Top()->lchild_ );
+      }
+  }
+
+
+  template < class C >
+  typename ConstInorderMapIterator<C>::Node* ConstInorderMapIterator<C>::Top() const
+  {
+    if (old_.Empty())
+      return stk_.Top();
+    if (stk_.Empty() || Before(old_, stk_))
+      return old_.Top();
+    return stk_.Top();
+  }
+
+
+  template < class C >
+  bool ConstInorderMapIterator<C>::Before(const StackType& a, const StackType& b) const
+  {
+    return map_->Less(a.Top()->value_.key_, b.Top()->value_.key_);
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::Increment()
+  {
+    if (old_.Empty())
+    {
+      Next(stk_);
+      return;
+    }
+    // advance each tree that is at the current key
+    bool onNew = !stk_.Empty() && !Before(old_, stk_);
+    bool onOld = stk_.Empty() || !Before(stk_, old_);
+    if (onNew) Next(stk_);
+    if (onOld) Next(old_);
+  }
+
+    
+  template < class C >
+  void ConstInorderMapIterator<C>::Decrement()
+  {
+    if (map_ == nullptr)
+    {
+      Prev(stk_);
+      return;
+    }
+    if (!Valid())
+      return;
+    // each tree steps back from its position; the greater key wins, and the
+    // other tree stays where it is, at its least key >= the new entry
+    StackType n(stk_), o(old_);
+    if (n.Empty()) NewLast(n); else Prev(n);
+    if (o.Empty()) OldLast(o); else OldPrev(o);
+    if (n.Empty() && o.Empty())
+    {
+      stk_.Clear();
+      old_.Clear();
+      return;
+    }
+    bool toNew = !n.Empty() && (o.Empty() || !Before(n, o));
+    bool toOld = !o.Empty() && (n.Empty() || !Before(o, n));
+    if (toNew) stk_ = n;
+    if (toOld) old_ = o;
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::OldPrev(StackType& s) const
+  // what is left of the old tree is the map's rehash stack, least key on top, each
+  // node followed by its right subtree; the left links of the stack nodes lead to
+  // nodes already moved and deleted, so a stack node steps back to the next one
+  // up the rehash stack instead
+  {
+    const fsu::Vector < Node* >& spine = map_->rehash_;
+    size_t d = s.Size();
+    if (d > spine.Size() || spine[d - 1] != s.Top()) // inside a right subtree
+    {
+      Prev(s);
+      return;
+    }
+    if (d == spine.Size()) // the least key left
+    {
+      s.Clear();
+      return;
+    }
+    Node * n = spine[d];
+    s.Push(n);
+    for (n = n->rchild_; n != nullptr; n = n->rchild_)
+      s.Push(n);
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::NewLast(StackType& s) const
+  {
+    s.Clear();
+    for (Node * n = map_->root_; n != nullptr; n = n->rchild_)
+      s.Push(n);
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::OldLast(StackType& s) const
+  {
+    s.Clear();
+    if (map_->rehash_.Empty())
+      return;
+    for (Node * n = map_->rehash_[0]; n != nullptr; n = n->rchild_)
+      s.Push(n);
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::mInit(const C* m)
+  {
+    map_ = m;
+    stk_.Clear();
+    old_.Clear();
+    for (Node * n = m->root_; n != nullptr; n = n->lchild_)
+      stk_.Push(n);
+    for (size_t i = 0; i < m->rehash_.Size(); ++i)
+      old_.Push(m->rehash_[i]);
+    while (Valid() && Top()->IsDead())
+    {
+      MAP_STAT(if (stats_) ++stats_->deadSkips;)
+      Increment();
+    }
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::mrInit(const C* m)
+  {
+    map_ = m;
+    NewLast(stk_);
+    OldLast(old_);
+    if (!stk_.Empty() && !old_.Empty()) // only the tree holding the greatest key keeps its place
+    {
+      if (Before(stk_, old_))
+        stk_.Clear();
+      else if (Before(old_, stk_))
+        old_.Clear();
+    }
+    while (Valid() && Top()->IsDead())
+    {
+      MAP_STAT(if (stats_) ++stats_->deadSkips;)
+      Decrement();
+    }
+  }
+
+
+  template < class C >
+  void ConstInorderMapIterator<C>::mSeek(const C* m, const typename C::KeyType& k)
+  {
+    map_ = m;
+    // the new tree: the path to k, cut back to the last node at or above k
+    stk_.Clear();
+    size_t keep = 0;
+    for (Node * n = m->root_; n != nullptr; )
+    {
+      MAP_STAT(if (stats_) stats_->Visit();)
+      stk_.Push(n);
+      if (m->Less(n->value_.key_, k))
+        n = n->rchild_;
+      else
+      {
+        keep = stk_.Size();
+        if (!m->Less(k, n->value_.key_))
+          break;
+        n = n->lchild_;
+      }
+    }
+    MAP_STAT(if (stats_) stats_->EndPath();)
+    while (stk_.Size() > keep)
+      stk_.Pop();
+    // the old tree: the rehash stack nodes at or above k, then the right subtree
+    // of the next one down, which holds the keys between it and them
+    const fsu::Vector < Node* >& spine = m->rehash_;
+    size_t lo = 0, hi = spine.Size(); // the first index whose key is < k
+    while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      if (m->Less(spine[mid]->value_.key_, k))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    old_.Clear();
+    for (size_t i = 0; i < lo; ++i)
+      old_.Push(spine[i]);
+    if (lo < spine.Size())
+    {
+      keep = lo;
+      old_.Push(spine[lo]);
+      for (Node * n = spine[lo]->rchild_; n != nullptr; )
+      {
+        old_.Push(n);
+        if (m->Less(n->value_.key_, k))
+          n = n->rchild_;
+        else
+        {
+          keep = old_.Size();
+          if (!m->Less(k, n->value_.key_))
+            break;
+          n = n->lchild_;
+        }
       }
+      while (old_.Size() > keep)
+        old_.Pop();
+    }
   }
 
     
   template < class C >
   ConstInorderMapIterator<C>&  ConstInorderMapIterator<C>::operator++ ()
   {
-      do
+      Increment();
+      while (Valid() && Top()->IsDead()) //increment until non-dead node is found
       {
+          MAP_STAT(if (stats_) ++stats_->deadSkips;)
           Increment();
       }
-      while (Valid() && stk_.Top()->IsDead()); //increment until non-dead node is found
       return *this;
   }
 
@@ -365,11 +614,12 @@ namespace fsu
   template < class C >
   ConstInorderMapIterator<C>&  ConstInorderMapIterator<C>::operator-- ()
   {
-      do
+      Decrement();
+      while (Valid() && Top()->IsDead())
       {
+          MAP_STAT(if (stats_) ++stats_->deadSkips;)
           Decrement();
       }
-      while (Valid() && stk_.Top()->IsDead());
       return *this;
   }
 
@@ -390,6 +640,9 @@ namespace fsu
   {
   private: // inner sanctum; keep stack implementation choice compatible w ChechRBLLT
     friend C;
+#ifdef MAP_ADT_DIGEST
+    const C* lender_; // set by C when it wants to know which entries * hands out, or nullptr
+#endif
 
   public:
     typedef typename fsu::Entry<typename C::KeyType,typename C::DataType> EntryType;
@@ -398,17 +651,17 @@ namespace fsu
     typedef InorderMapIterator<C>                                         Iterator;
 
     // first class
-    InorderMapIterator                 () : ConstInorderMapIterator<C>() {}
+    InorderMapIterator                 () : ConstInorderMapIterator<C>() { MAP_DIGEST(lender_ = nullptr;) }
     virtual  ~InorderMapIterator       () { }
-    InorderMapIterator                 (const InorderMapIterator& i) : ConstInorderMapIterator<C> (i) {}
-    InorderMapIterator<C>&  operator=  (const InorderMapIterator& i) { this->stk_ = i.stk_; return *this; }
+    InorderMapIterator                 (const InorderMapIterator& i) : ConstInorderMapIterator<C> (i) { MAP_DIGEST(lender_ = i.lender_;) }
+    InorderMapIterator<C>&  operator=  (const InorderMapIterator& i) { ConstInorderMapIterator<C>::operator=(i); MAP_DIGEST(lender_ = i.lender_;) return *this; }
 
     // various operators
-    bool                       operator== (const InorderMapIterator& i2) const { return this->stk_ == i2.stk_; }
+    bool                       operator== (const InorderMapIterator& i2) const { return ConstInorderMapIterator<C>::operator==(i2); }
     bool                       operator!= (const InorderMapIterator& i2) const { return !(*this == i2); }
 
-    const EntryType&           operator*  () const { return this->stk_.Top()->value_; }
-    EntryType&                 operator*  ()       { return this->stk_.Top()->value_; }
+    const EntryType&           operator*  () const { return this->Top()->value_; }
+    EntryType&                 operator*  ();
     InorderMapIterator<C>&     operator++ ();    // prefix
     InorderMapIterator<C>      operator++ (int); // postfix
     InorderMapIterator<C>&     operator-- ();    // prefix
@@ -416,6 +669,17 @@ namespace fsu
 
   };
 
+  template < class C >
+  typename InorderMapIterator<C>::EntryType&  InorderMapIterator<C>::operator* ()
+  {
+    Node * n = this->Top();
+#ifdef MAP_ADT_DIGEST
+    if (lender_ != nullptr && (this->old_.Empty() || n != this->old_.Top())) //old entries are summed as they are
+      lender_->Lend(n);
+#endif
+    return n->value_;
+  }
+
   template < class C >
   InorderMapIterator<C>&  InorderMapIterator<C>::operator++ ()
   {
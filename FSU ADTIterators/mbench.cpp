@@ -0,0 +1,325 @@
+/*
+    mbench.cpp
+    10/18/26
+
+    Benchmark of whole-map traversals of Map_ADT<uint32_t,int>
+
+    Builds a map of n random keys and erases every tenth one, so the
+    traversals also step over tombstones. Then each aggregation runs once
+    single-threaded through ConstIterator and then through
+    ParallelForEach / ParallelReduce on pools of 1, 2, 4, ... threads up
+    to the hardware concurrency. For each thread count it reports the
+    best-of-reps milliseconds and the speedup over the iterator loop.
+
+      sum         ParallelReduce, sum of data_
+      inorder     ParallelReduce with a non-commutative combiner: first key,
+                  last key, count, and whether every key is above the one
+                  before it. This checks that the entries are grouped in key order.
+      transform   non-const ParallelForEach, data_ = 16 rounds of hashing
+                  of key_ (compute bound)
+      check       CheckRBLLTFast, sequential vs parallel; the iterator-based
+                  CheckRBLLT is timed once for comparison
+
+    Then it times n/10 lookups through the const Includes(), first for
+    absent keys and then for present keys in random order, each without
+    and with EnableFilter() (bloom.h). It also reports the filter's size
+    and its measured false-positive rate.
+
+    All rows run on the same map. A copy of it would be faster to walk:
+    the copy constructor allocates nodes in preorder, so they sit close
+    together in memory.
+
+    Built with -DMAP_ADT_DIGEST it then times the content digests
+    (map_digest.h) against a second map holding the same entries, put
+    in reverse order so the two trees have different shapes:
+
+      refresh     the O(n) recompute after the transform rows wrote data_
+                  through references
+      equal       walking both maps with iterators vs comparing Digest()
+      diff d      Diff() after d keys of the second map were changed, for
+                  d = 1, 10, 100, 1000
+
+    Every parallel result is checked against the iterator loop, and every
+    Diff() against the changed keys; a mismatch is reported and sets the
+    exit status.
+
+    usage: mbench [n = 10000000] [reps = 3] [grain = 4096]
+*/
+
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <thread>
+
+#include <bench.h>
+#include <threadpool.h>
+#include <map_adt.h>
+#include <xran.h>
+#include <xran.cpp>     // in lieu of makefile
+
+typedef fsu::Map_ADT<uint32_t,int> MapType;
+typedef MapType::EntryType         EntryType;
+
+static bool failed = false;
+
+static void Check (bool ok, const char* what)
+{
+  if (!ok)
+  {
+    std::cout << " ** MISMATCH: " << what << '\n';
+    failed = true;
+  }
+}
+
+// the inorder monoid: combine(a,b) is "a then b"
+struct Run
+{
+  uint32_t first, last;
+  size_t   count;
+  bool     sorted;
+  Run () : first(0), last(0), count(0), sorted(true) {}
+  explicit Run (uint32_t k) : first(k), last(k), count(1), sorted(true) {}
+  bool operator == (const Run& r) const
+  {
+    return first == r.first && last == r.last && count == r.count && sorted == r.sorted;
+  }
+} ;
+
+static Run Then (const Run& a, const Run& b)
+{
+  if (a.count == 0) return b;
+  if (b.count == 0) return a;
+  Run r;
+  r.first  = a.first;
+  r.last   = b.last;
+  r.count  = a.count + b.count;
+  r.sorted = a.sorted && b.sorted && a.last < b.first;
+  return r;
+}
+
+static int Mix (uint32_t h)
+{
+  for (int i = 0; i < 16; ++i)
+  {
+    h ^= h >> 16; h *= 0x7feb352dU;
+    h ^= h >> 15; h *= 0x846ca68bU;
+  }
+  return (int)(h >> 1);
+}
+
+// one row: iterator loop time, then time and speedup per pool
+template < class Seq , class Par >
+void Row (const char* name, Seq seq, Par par, const std::vector<fsu::ThreadPool*>& pools, size_t reps)
+{
+  double s = fsu::BestOf(seq, reps) * 1.0e-6;
+  std::cout << std::setw(12) << std::left << name << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10) << s;
+  for (size_t i = 0; i < pools.size(); ++i)
+  {
+    double p = fsu::BestOf([&]() { par(pools[i]); }, reps) * 1.0e-6;
+    std::cout << std::setw(10) << p << std::setprecision(2) << std::setw(7) << (p > 0 ? s / p : 0.0)
+              << std::setprecision(1);
+  }
+  std::cout << '\n';
+  std::cout.unsetf(std::ios::fixed);
+}
+
+static void Lookups (MapType& m, fsu::Random_int& ran, size_t probes, size_t reps)
+{
+  // random 32-bit keys: a map of n keys holds any one of them with odds n/2^32
+  const MapType& cm = m;
+  std::vector<uint32_t> absent, present;
+  while (absent.size() < probes)
+  {
+    uint32_t k = (uint32_t)ran(0, INT_MAX) * 2u + (uint32_t)ran(0, 2);
+    if (cm.Includes(k) == cm.End())
+      absent.push_back(k);
+  }
+  for (MapType::ConstIterator i = cm.Begin(); i != cm.End() && present.size() < probes; ++i)
+    present.push_back((*i).key_);
+  for (size_t i = present.size(); i > 1; --i)
+    std::swap(present[i - 1], present[ran(0, (unsigned)i)]);
+
+  size_t found[2][2];
+  double ms[2][2];
+  for (int f = 0; f < 2; ++f)
+  {
+    if (f == 1)
+      m.EnableFilter();
+    const std::vector<uint32_t>* keys[2] = { &absent, &present };
+    for (int p = 0; p < 2; ++p)
+      ms[p][f] = fsu::BestOf([&]()
+        {
+          size_t c = 0;
+          for (size_t i = 0; i < keys[p]->size(); ++i)
+            c += (cm.Includes((*keys[p])[i]) != cm.End());
+          found[p][f] = c;
+        }, reps) * 1.0e-6;
+  }
+
+  size_t fp = 0;
+  for (size_t i = 0; i < absent.size(); ++i)
+    fp += m.Filter()->MayContain(fsu::HashValue(absent[i]));
+  std::cout << "\nlookups, " << probes << " x Includes" << std::setw(14) << "no filter ms" << std::setw(12) << "filter ms"
+            << std::setw(7) << "x" << '\n' << std::fixed;
+  const char* names[2] = { "  absent keys", "  present keys" };
+  for (int p = 0; p < 2; ++p)
+    std::cout << std::setw(25) << std::left << names[p] << std::right << std::setprecision(1)
+              << std::setw(14) << ms[p][0] << std::setw(12) << ms[p][1]
+              << std::setprecision(2) << std::setw(7) << (ms[p][1] > 0 ? ms[p][0] / ms[p][1] : 0.0) << '\n';
+  std::cout << "  filter " << m.Filter()->MemoryUsage() / 1024 << " KiB for capacity " << m.Filter()->Capacity()
+            << ", false positives " << std::setprecision(3) << 100.0 * fp / absent.size() << "%\n";
+  std::cout.unsetf(std::ios::fixed);
+  Check(found[0][0] == 0 && found[0][1] == 0, "absent keys found");
+  Check(found[1][0] == present.size() && found[1][1] == present.size(), "present keys missed");
+  m.DisableFilter();
+}
+
+#ifdef MAP_ADT_DIGEST
+static void Digests (MapType& m, fsu::Random_int& ran, size_t reps)
+{
+  std::cout << "\ncontent digests\n" << std::fixed << std::setprecision(3);
+  double r = fsu::BestOf([&]() { m.Begin(); m.Digest(); }, 1) * 1.0e-6;   // Begin() marks it stale
+  std::cout << "  refresh      " << std::setw(12) << r << " ms\n";
+
+  std::vector<EntryType> all;
+  const MapType& cm = m;
+  for (MapType::ConstIterator i = cm.Begin(); i != cm.End(); ++i)
+    all.push_back(*i);
+  MapType b;
+  for (size_t i = all.size(); i-- > 0; )
+    b.Put(all[i].key_, all[i].data_);
+  std::vector<EntryType>().swap(all);
+  const MapType& cb = b;
+
+  bool walk = false, dig = false;
+  double w = fsu::BestOf([&]() { walk = (cm == cb); }, reps) * 1.0e-6;
+  double g = fsu::BestOf([&]() { dig = (cm.Digest() == cb.Digest()); }, reps) * 1.0e-6;
+  std::cout << "  equal walk   " << std::setw(12) << w << " ms\n"
+            << "  equal digest " << std::setw(12) << g << " ms\n";
+  Check(walk && dig, "equal digests");
+
+  // keys with the low bit set may or may not be in m; either way
+  // data_ = Mix(key_) ^ 1 differs from m
+  std::set<uint32_t> changed;
+  for (size_t d = 1; d <= 1000; d *= 10)
+  {
+    while (changed.size() < d)
+    {
+      uint32_t k = (uint32_t)ran(0, INT_MAX) * 2u + 1u;
+      b.Put(k, Mix(k) ^ 1);
+      changed.insert(k);
+    }
+    std::set<uint32_t> found;
+    size_t n = 0;
+    double t = fsu::BestOf([&]() { found.clear(); n = cb.Diff(cm, [&](uint32_t k) { found.insert(k); }); }, reps) * 1.0e-6;
+    std::cout << "  diff d = " << std::setw(4) << d << std::setw(12) << t << " ms\n";
+    Check(n == d && found == changed, "diff");
+  }
+  std::cout.unsetf(std::ios::fixed);
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+  size_t n     = (argc > 1) ? atol(argv[1]) : 10000000;
+  size_t reps  = (argc > 2) ? atoi(argv[2]) : 3;
+  size_t grain = (argc > 3) ? atol(argv[3]) : 4096;
+  if (n < 16) n = 16;
+  if (reps < 1) reps = 1;
+
+  size_t hw = std::thread::hardware_concurrency();
+  if (hw == 0) hw = 1;
+  std::vector<fsu::ThreadPool*> pools;   // t threads = t - 1 workers + caller
+  for (size_t t = 1; t < hw; t *= 2)
+    pools.push_back(new fsu::ThreadPool(t - 1));
+  pools.push_back(new fsu::ThreadPool(hw - 1));
+
+  MapType m;
+  fsu::Random_int ran;
+  fsu::Timer build;
+  std::vector<uint32_t> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    uint32_t k = (uint32_t)ran(0, INT_MAX) * 2u + (uint32_t)(i & 1);
+    keys.push_back(k);
+    m.Put(k, (int)(k % 1000));
+  }
+  for (size_t i = 0; i < n; i += 10)
+    m.Erase(keys[i]);
+  std::vector<uint32_t>().swap(keys);
+  std::cout << "Map_ADT traversal benchmark, n = " << n << " (every 10th erased), grain = " << grain
+            << ", best of " << reps << ", hardware threads = " << hw << '\n'
+            << "build " << std::fixed << std::setprecision(1) << build.Seconds() << " s, height "
+            << m.Height() << ", live " << m.Size() << '\n';
+  std::cout.unsetf(std::ios::fixed);
+
+  std::cout << '\n' << std::setw(12) << std::left << "aggregate" << std::right << std::setw(10) << "iter ms";
+  for (size_t i = 0; i < pools.size(); ++i)
+    std::cout << std::setw(6) << pools[i]->Concurrency() << "T ms" << std::setw(7) << "x";
+  std::cout << '\n';
+
+  const MapType& cm = m;
+  long long s = 0, p = 0;
+  Row("sum",
+      [&]() { s = 0; for (MapType::ConstIterator i = cm.Begin(); i != cm.End(); ++i) s += (*i).data_; },
+      [&](fsu::ThreadPool* pool)
+      {
+        p = cm.ParallelReduce(0LL, [](const EntryType& e) { return (long long)e.data_; },
+                              [](long long a, long long b) { return a + b; }, grain, pool);
+      }, pools, reps);
+  Check(s == p, "sum");
+
+  Run rs, rp;
+  Row("inorder",
+      [&]() { rs = Run(); for (MapType::ConstIterator i = cm.Begin(); i != cm.End(); ++i) rs = Then(rs, Run((*i).key_)); },
+      [&](fsu::ThreadPool* pool)
+      {
+        rp = cm.ParallelReduce(Run(), [](const EntryType& e) { return Run(e.key_); }, Then, grain, pool);
+      }, pools, reps);
+  Check(rs == rp && rp.sorted && rp.count == m.Size(), "inorder");
+
+  // data_ = Mix(key_) leaves the same map however often it runs
+  Row("transform",
+      [&]() { for (MapType::Iterator i = m.Begin(); i != m.End(); ++i) (*i).data_ = Mix((*i).key_); },
+      [&](fsu::ThreadPool* pool)
+      {
+        m.ParallelForEach([](EntryType& e) { e.data_ = Mix(e.key_); }, grain, pool);
+      }, pools, reps);
+  for (MapType::Iterator i = m.Begin(); i != m.End(); ++i)
+    (*i).data_ = 0;
+  m.ParallelForEach([](EntryType& e) { e.data_ = Mix(e.key_); }, grain, pools.back());
+  bool same = true;
+  for (MapType::ConstIterator i = cm.Begin(); i != cm.End(); ++i)
+    same = same && (*i).data_ == Mix((*i).key_);
+  Check(same, "transform");
+
+  bool okSeq = true, okPar = true;
+  Row("check",
+      [&]() { okSeq = cm.CheckRBLLTFast(0); },
+      [&](fsu::ThreadPool* pool) { okPar = okPar && cm.CheckRBLLTFast(0, true, grain, pool); },
+      pools, reps);
+  Check(okSeq && okPar, "check");
+  fsu::Timer slow;
+  bool okOld = cm.CheckRBLLT(0);
+  std::cout << std::setw(12) << std::left << "CheckRBLLT" << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << slow.Seconds() * 1.0e3 << '\n';
+  std::cout.unsetf(std::ios::fixed);
+  Check(okOld, "CheckRBLLT");
+
+  Lookups(m, ran, n / 10, reps);
+
+#ifdef MAP_ADT_DIGEST
+  Digests(m, ran, reps);
+#endif
+
+  for (size_t i = 0; i < pools.size(); ++i)
+    delete pools[i];
+  std::cout << '\n';
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -43,6 +43,7 @@
 #include <iomanip>
 #include <map_adt.h>
 #include <cmath>
+#include <histogram.h>  // per-operation latency
 
 // choose one from group A 
 
@@ -69,14 +70,19 @@ const long unsigned int reportInterval =    10000;
 const      unsigned int getPercent  =       50;    // to control
 const      unsigned int putPercent  =       50;    // growth rate
 const      unsigned int assignPercent  =    30;    // and volatility
+const      unsigned int erasePercent   =    25;
 // */
 
 // constants for number of containers and operations
 const unsigned int numObj = 3;  // containers x0, x1, x2
-const unsigned int numOps = 6; //  operations 0..5
+const unsigned int numOps = 8; //  operations 0..7
+
+// latency of the map operations, all three containers pooled
+fsu::LatencyHistogram hPut, hGet, hRetrieve, hErase, hIncludes;
 
 template < typename T , class P >
 void WriteReport(fsu::Map_ADT<T,P> x, char n, unsigned long numreports);
+void WriteLatency();
 
 int main(int argc, char* argv[])
 {
@@ -103,6 +109,7 @@ int main(int argc, char* argv[])
   unsigned long numrpts(0); 
   unsigned int option;
   size_t size;
+  fsu::LatencyTimer timer;
 
   std::cout << "\nStarting dynamic random test of OAA < " << vT << " >"
             << "\n\n" << std::flush;
@@ -121,7 +128,9 @@ int main(int argc, char* argv[])
             {
               data = ranint(1,11);
               key = ranobj(data);
+              timer.Start();
               x0.Put(key,data);
+              hPut.Record(timer.ElapsedNs());
             }
             break;
         
@@ -131,7 +140,9 @@ int main(int argc, char* argv[])
             {
               data = ranint(1,11);
               key = ranobj(data);
+              timer.Start();
               x0.Get(key);
+              hGet.Record(timer.ElapsedNs());
             }
             break;
         
@@ -165,7 +176,9 @@ int main(int argc, char* argv[])
             break;
 
           case 4: // Includes
+            timer.Start();
             i0 = x0.Includes(key);
+            hIncludes.Record(timer.ElapsedNs());
             if (i0 != x0.End())
             {
               data = ranint(1,11);
@@ -199,6 +212,22 @@ int main(int argc, char* argv[])
             }
             break;
 
+          case 6:   // Erase (k)
+            option = ranint(0,100);
+            if (option < erasePercent)
+            {
+              timer.Start();
+              x0.Erase(key);
+              hErase.Record(timer.ElapsedNs());
+            }
+            break;
+
+          case 7:   // Retrieve (k,d)
+            timer.Start();
+            x0.Retrieve(key,data);
+            hRetrieve.Record(timer.ElapsedNs());
+            break;
+
           default: std::cout << " ** bad operation number\n";
 
 
@@ -214,7 +243,9 @@ int main(int argc, char* argv[])
             {
               data = ranint(1,11);
               key = ranobj(data);
+              timer.Start();
               x1.Put(key,data);
+              hPut.Record(timer.ElapsedNs());
             }
             break;
         
@@ -224,7 +255,9 @@ int main(int argc, char* argv[])
             {
               data = ranint(1,11);
               key = ranobj(data);
+              timer.Start();
               x1.Get(key);
+              hGet.Record(timer.ElapsedNs());
             }
             break;
         
@@ -258,7 +291,9 @@ int main(int argc, char* argv[])
             break;
 
           case 4: // Includes
+            timer.Start();
             i1 = x1.Includes(key);
+            hIncludes.Record(timer.ElapsedNs());
             if (i1 != x1.End())
             {
               data = ranint(1,11);
@@ -292,6 +327,22 @@ int main(int argc, char* argv[])
             }
             break;
 
+          case 6:   // Erase (k)
+            option = ranint(0,100);
+            if (option < erasePercent)
+            {
+              timer.Start();
+              x1.Erase(key);
+              hErase.Record(timer.ElapsedNs());
+            }
+            break;
+
+          case 7:   // Retrieve (k,d)
+            timer.Start();
+            x1.Retrieve(key,data);
+            hRetrieve.Record(timer.ElapsedNs());
+            break;
+
           default: std::cout << " ** bad operation number\n";
 
         }   // end switch() x1 operations
@@ -306,7 +357,9 @@ int main(int argc, char* argv[])
             {
               data = ranint(1,11);
               key = ranobj(data);
+              timer.Start();
               x2.Put(key,data);
+              hPut.Record(timer.ElapsedNs());
             }
             break;
         
@@ -316,7 +369,9 @@ int main(int argc, char* argv[])
             {
               data = ranint(1,11);
               key = ranobj(data);
+              timer.Start();
               x2.Get(key);
+              hGet.Record(timer.ElapsedNs());
             }
             break;
         
@@ -350,7 +405,9 @@ int main(int argc, char* argv[])
             break;
 
           case 4: // Includes
+            timer.Start();
             i2 = x2.Includes(key);
+            hIncludes.Record(timer.ElapsedNs());
             if (i2 != x2.End())
             {
               data = ranint(1,11);
@@ -384,6 +441,22 @@ int main(int argc, char* argv[])
             }
             break;
 
+          case 6:   // Erase (k)
+            option = ranint(0,100);
+            if (option < erasePercent)
+            {
+              timer.Start();
+              x2.Erase(key);
+              hErase.Record(timer.ElapsedNs());
+            }
+            break;
+
+          case 7:   // Retrieve (k,d)
+            timer.Start();
+            x2.Retrieve(key,data);
+            hRetrieve.Record(timer.ElapsedNs());
+            break;
+
           default: std::cout << " ** bad operation number\n";
 
         }   // end switch() x2 operations
@@ -402,9 +475,11 @@ int main(int argc, char* argv[])
         case 1: WriteReport(x1,'1',numrpts); break;
         case 2: WriteReport(x2,'2',numrpts); break;
       }
+      WriteLatency();
       if (numrpts == maxrpts)
       {
         std::cout << "\nTest Complete\n";
+        FSU_TRACE_DUMP("mmap.trace.json"); // -DFSU_TRACE only
         break;
       }
     }
@@ -423,3 +498,15 @@ void WriteReport(fsu::Map_ADT<T,P> x, char n, unsigned long numrpts)
             << "  x" << n << ".Height()            ==  " << x.Height() << '\n'
             << "  optimal ht (size)      ==  " << (size_t)(floor(log2(size))) << std::endl;
 }
+
+void WriteLatency()
+{
+  std::cout << "  latency, all containers, cumulative:\n";
+  fsu::LatencyHistogram::ReportHeader(std::cout);
+  hPut.Report(std::cout, "Put");
+  hGet.Report(std::cout, "Get");
+  hRetrieve.Report(std::cout, "Retrieve");
+  hErase.Report(std::cout, "Erase");
+  hIncludes.Report(std::cout, "Includes");
+  std::cout << std::flush;
+}
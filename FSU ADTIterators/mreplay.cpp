@@ -0,0 +1,372 @@
+/*
+    mreplay.cpp
+    10/18/26
+
+    Replays an operation log (maplog.h) against several map implementations
+
+    A log recorded by MapRecorder, e.g. with "fmap -r logfile comfile", holds
+    the Put, Get, Erase, Retrieve, Includes, Rehash and Clear calls of a real
+    session. mreplay decodes it once, into an array of operations whose keys
+    are already made, and then drives each backend with exactly that
+    sequence, at full speed:
+
+      Map_ADT               the library map
+      Map_ADT + filter      the same, after EnableFilter() (bloom.h)
+      std::map
+      std::unordered_map
+
+    String keys are fsu::String for Map_ADT and std::string for the std
+    maps. Integer keys are replayed as int64_t or uint64_t, floating keys
+    as double, and data as long (floating data is truncated).
+
+    For each backend it reports
+
+      ms, ops/s     best of reps replays of the whole log, each into a new map
+      mean ns       per operation type, from one more replay that times every
+                    call on a LatencyTimer (which adds its own ~20 ns)
+      size, check   entries at the end and a checksum of every value the log
+                    read back
+
+    The checksums of backends with the same semantics agree. Those of
+    Map_ADT and the std maps differ when the log Gets an erased key:
+    Map_ADT revives the entry with its old data, where operator [] of a
+    std map makes a new one holding long().
+
+    Rehash is a no-op for the std maps. Writes made through the reference
+    that Get or operator [] returned, or through an iterator, are not in
+    the log, so a replay sees only the Put calls of the session.
+
+    usage: mreplay logfile [reps = 3]
+           mreplay -s logfile [n = 200000]   writes a synthetic log of about
+                                             4n operations on Map_ADT<uint32_t,int>
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <type_traits>
+
+#include <bench.h>
+#include <histogram.h>
+#include <map_adt.h>
+#include <maplog.h>
+#include <xstring.h>
+#include <xran.h>
+#include <xstring.cpp>  // in lieu of makefile
+#include <xran.cpp>     // in lieu of makefile
+
+//----------------------------------
+//   the decoded log
+//----------------------------------
+
+struct ReplayOp
+{
+  uint8_t  op;
+  uint32_t key;   // index into the key arrays
+  long     data;
+};
+
+// decoded keys, both as the library and as std would hold them
+template < typename K , typename S >
+struct ReplayKeys
+{
+  std::vector<K> fsu;
+  std::vector<S> std;
+};
+
+template < typename S >
+void LogKey (const fsu::MapLogValue& v, S& s)
+{
+  switch (v.type & 0xF0)
+  {
+    case 0x10: s = (S)v.i; break;
+    case 0x20: s = (S)v.u; break;
+    default:   s = (S)v.f; break;
+  }
+}
+
+void LogKey (const fsu::MapLogValue& v, std::string& s)
+{
+  s.assign(v.s, v.n);
+}
+
+// the library's key for a std key
+template < typename S >
+S FsuKey (const S& s) { return s; }
+
+fsu::String FsuKey (const std::string& s) { return fsu::String(s.c_str()); }
+
+long LogData (const fsu::MapLogValue& v)
+{
+  switch (v.type & 0xF0)
+  {
+    case 0x10: return (long)v.i;
+    case 0x20: return (long)v.u;
+    case 0x30: return (long)v.f;
+    default:   return 0;
+  }
+}
+
+// reads the whole log; each distinct key is made once
+template < typename K , typename S >
+bool Decode (fsu::MapLogReader& log, std::vector<ReplayOp>& ops, ReplayKeys<K,S>& keys)
+{
+  std::unordered_map<S,uint32_t> index;
+  int op;
+  fsu::MapLogValue k, d;
+  while (log.Next(op, k, d))
+  {
+    ReplayOp r;
+    r.op = (uint8_t)op;
+    r.key = 0;
+    r.data = (op == fsu::LOG_PUT) ? LogData(d) : 0;
+    if (op != fsu::LOG_REHASH && op != fsu::LOG_CLEAR)
+    {
+      S s;
+      LogKey(k, s);
+      typename std::unordered_map<S,uint32_t>::iterator i = index.find(s);
+      if (i == index.end())
+      {
+        i = index.insert(std::make_pair(s, (uint32_t)keys.std.size())).first;
+        keys.std.push_back(s);
+        keys.fsu.push_back(FsuKey(s));
+      }
+      r.key = i->second;
+    }
+    ops.push_back(r);
+  }
+  return !log.Bad();
+}
+
+//----------------------------------
+//   backends
+//----------------------------------
+
+template < class M >
+struct ReplayAdapter;
+
+template < typename K , typename D , class P >
+struct ReplayAdapter < fsu::Map_ADT<K,D,P> >
+{
+  typedef fsu::Map_ADT<K,D,P> M;
+  static void Put      (M& m, const K& k, long d) { m.Put(k,d); }
+  static long Get      (M& m, const K& k)         { return m.Get(k); }
+  static void Erase    (M& m, const K& k)         { m.Erase(k); }
+  static bool Retrieve (const M& m, const K& k, long& d) { return m.Retrieve(k,d); }
+  static bool Includes (const M& m, const K& k)   { return m.Includes(k) != m.End(); }
+  static void Rehash   (M& m)                     { m.Rehash(); }
+  static void Clear    (M& m)                     { m.Clear(); }
+  static size_t Size   (const M& m)               { return m.Size(); }
+};
+
+template < class M >
+struct StdReplayAdapter
+{
+  typedef typename M::key_type K;
+  static void Put      (M& m, const K& k, long d) { m[k] = d; }
+  static long Get      (M& m, const K& k)         { return m[k]; }
+  static void Erase    (M& m, const K& k)         { m.erase(k); }
+  static bool Retrieve (const M& m, const K& k, long& d)
+  {
+    typename M::const_iterator i = m.find(k);
+    if (i == m.end()) return 0;
+    d = i->second;
+    return 1;
+  }
+  static bool Includes (const M& m, const K& k)   { return m.find(k) != m.end(); }
+  static void Rehash   (M&)                       {}
+  static void Clear    (M& m)                     { m.clear(); }
+  static size_t Size   (const M& m)               { return m.size(); }
+};
+
+template < typename K , typename D , class C , class A >
+struct ReplayAdapter < std::map<K,D,C,A> > : StdReplayAdapter < std::map<K,D,C,A> > {};
+
+template < typename K , typename D , class H , class E , class A >
+struct ReplayAdapter < std::unordered_map<K,D,H,E,A> > : StdReplayAdapter < std::unordered_map<K,D,H,E,A> > {};
+
+// one call; its contribution to the checksum
+template < class M , typename K >
+uint64_t Apply (M& m, const ReplayOp& r, const std::vector<K>& keys)
+{
+  typedef ReplayAdapter<M> A;
+  long d = 0;
+  switch (r.op)
+  {
+    case fsu::LOG_PUT:      A::Put(m, keys[r.key], r.data); return 0;
+    case fsu::LOG_GET:      return (uint64_t)A::Get(m, keys[r.key]);
+    case fsu::LOG_ERASE:    A::Erase(m, keys[r.key]); return 0;
+    case fsu::LOG_RETRIEVE: return A::Retrieve(m, keys[r.key], d) ? 1 + (uint64_t)d : 0;
+    case fsu::LOG_INCLUDES: return A::Includes(m, keys[r.key]);
+    case fsu::LOG_REHASH:   A::Rehash(m); return 0;
+    case fsu::LOG_CLEAR:    A::Clear(m); return 0;
+    default:                return 0;
+  }
+}
+
+template < class M >
+void Prepare (M&, bool) {}
+
+template < typename K , typename D , class P >
+void Prepare (fsu::Map_ADT<K,D,P>& m, bool filter) { if (filter) m.EnableFilter(); }
+
+template < class M , typename K >
+void Replay (const char* name, const std::vector<ReplayOp>& ops, const std::vector<K>& keys,
+             size_t reps, bool filter = 0)
+{
+  uint64_t check = 0;
+  size_t size = 0;
+  double ns = fsu::BestOf([&]()
+    {
+      M m;
+      Prepare(m, filter);
+      uint64_t c = 0;
+      for (size_t i = 0; i < ops.size(); ++i)
+        c = 31 * c + Apply(m, ops[i], keys);
+      check = c;
+      size = ReplayAdapter<M>::Size(m);
+    }, reps);
+
+  fsu::LatencyHistogram hist[fsu::LOG_NUM_OPS];
+  fsu::LatencyTimer timer;
+  {
+    M m;
+    Prepare(m, filter);
+    uint64_t c = 0;
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+      timer.Start();
+      c += Apply(m, ops[i], keys);
+      hist[ops[i].op].Record(timer.ElapsedNs());
+    }
+    fsu::DoNotOptimize(c);
+  }
+
+  std::cout << "  " << std::setw(18) << std::left << name << std::right
+            << std::fixed << std::setprecision(2)
+            << std::setw(10) << ns / 1e6
+            << std::setw(12) << std::setprecision(0) << (ns > 0 ? ops.size() * 1e9 / ns : 0.0);
+  for (int op = fsu::LOG_PUT; op < fsu::LOG_NUM_OPS; ++op)
+  {
+    if (hist[op].Count())
+      std::cout << std::setw(10) << (uint64_t)hist[op].Mean();
+    else
+      std::cout << std::setw(10) << '-';
+  }
+  std::cout << std::setw(10) << size << "  " << std::hex << check << std::dec << '\n';
+  std::cout.unsetf(std::ios::floatfield);
+}
+
+template < typename K , typename S >
+void RunAll (const std::vector<ReplayOp>& ops, const ReplayKeys<K,S>& keys, size_t reps)
+{
+  std::cout << std::setw(20) << std::left << "  backend" << std::right
+            << std::setw(10) << "ms"
+            << std::setw(12) << "ops/s";
+  for (int op = fsu::LOG_PUT; op < fsu::LOG_NUM_OPS; ++op)
+    std::cout << std::setw(10) << fsu::MapLogOpName(op);
+  std::cout << std::setw(10) << "size" << "  check\n";
+  std::cout << std::setw(42) << "" << "  mean ns per operation\n";
+  Replay< fsu::Map_ADT<K,long> >          ("Map_ADT",            ops, keys.fsu, reps);
+  Replay< fsu::Map_ADT<K,long> >          ("Map_ADT + filter",   ops, keys.fsu, reps, 1);
+  Replay< std::map<S,long> >              ("std::map",           ops, keys.std, reps);
+  Replay< std::unordered_map<S,long> >    ("std::unordered_map", ops, keys.std, reps);
+}
+
+template < typename K , typename S >
+int Run (fsu::MapLogReader& log, size_t reps)
+{
+  std::vector<ReplayOp> ops;
+  ReplayKeys<K,S> keys;
+  if (!Decode(log, ops, keys))
+    std::cout << " ** log damaged after " << ops.size() << " operations; replaying those\n";
+  size_t count[fsu::LOG_NUM_OPS] = { 0 };
+  for (size_t i = 0; i < ops.size(); ++i)
+    ++count[ops[i].op];
+  std::cout << "  " << ops.size() << " operations on " << keys.std.size() << " distinct keys:";
+  for (int op = fsu::LOG_PUT; op < fsu::LOG_NUM_OPS; ++op)
+    if (count[op]) std::cout << ' ' << fsu::MapLogOpName(op) << ' ' << count[op];
+  std::cout << "\n\n";
+  RunAll(ops, keys, reps);
+  return 0;
+}
+
+//----------------------------------
+//   synthetic log
+//----------------------------------
+
+// n Puts of keys below 2n, then 3n mixed calls, with a Rehash every n
+int Synthesize (const char* path, size_t n)
+{
+  fsu::MapRecorder< fsu::Map_ADT<uint32_t,int> > m;
+  if (!m.Record(path))
+  {
+    std::cout << " ** cannot write " << path << '\n';
+    return 1;
+  }
+  fsu::Random_unsigned_int ran;
+  unsigned long range = 2 * n;
+  for (size_t i = 0; i < n; ++i)
+    m.Put(ran(0, range), (int)i);
+  int d;
+  for (size_t i = 0; i < 3 * n; ++i)
+  {
+    uint32_t k = ran(0, range);
+    switch (ran(0, 10))
+    {
+      case 0: case 1:         m.Put(k, (int)i);  break;
+      case 2: case 3:         m.Get(k);          break;
+      case 4:                 m.Erase(k);        break;
+      case 5: case 6: case 7: m.Retrieve(k, d);  break;
+      default:                m.Includes(k);     break;
+    }
+    if (i % n == n - 1)
+      m.Rehash();
+  }
+  m.StopRecording();
+  std::cout << "  " << m.Logged() << " operations written to " << path << '\n';
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cout << " ** command line arguments:\n"
+              << "    1: log file (required)\n"
+              << "    2: repetitions [default = 3]\n"
+              << " ** or: -s logfile [n = 200000] to write a synthetic log\n";
+    return 0;
+  }
+  if (strcmp(argv[1], "-s") == 0)
+  {
+    if (argc < 3) return 1;
+    size_t n = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 200000;
+    return Synthesize(argv[2], n ? n : 1);
+  }
+  size_t reps = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 3;
+  if (reps == 0) reps = 1;
+
+  fsu::MapLogReader log;
+  if (!log.Open(argv[1]))
+  {
+    std::cout << " ** " << argv[1] << " is not a map log\n";
+    return 1;
+  }
+  uint8_t kt = log.KeyType();
+  std::cout << "replay: " << argv[1] << ", <" << fsu::MapLogReader::TypeName(kt) << ','
+            << fsu::MapLogReader::TypeName(log.DataType()) << ">, best of " << reps << '\n';
+  switch (kt & 0xF0)
+  {
+    case 0x10: return Run<int64_t,int64_t>(log, reps);
+    case 0x20: return Run<uint64_t,uint64_t>(log, reps);
+    case 0x30: return Run<double,double>(log, reps);
+    default:   return Run<fsu::String,std::string>(log, reps);
+  }
+}
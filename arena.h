@@ -0,0 +1,251 @@
+/*
+    arena.h
+    10/18/26
+
+    NodeArena: fixed-size blocks carved from large, page-aligned chunks
+
+    classes defined in this file
+    ----------------------------
+
+    NodeArena           blocks of one size, for the nodes of one container
+
+    A descent through a large tree touches one node per level, each on a
+    page of its own, so a map of a few GB misses the data TLB at almost
+    every step when nodes sit on 4 KiB pages. A NodeArena takes its memory
+    from the system in chunks of 2 MiB and up (doubling to 64 MiB), and
+    asks for huge pages for them, so that a TLB entry covers 512 times as
+    many nodes:
+
+      HUGETLB   mmap(MAP_HUGETLB): explicit huge pages, when the system has
+                some reserved (/proc/sys/vm/nr_hugepages)
+      THP       otherwise an anonymous mmap aligned to 2 MiB, with
+                madvise(MADV_HUGEPAGE): transparent huge pages, when
+                /sys/kernel/mm/transparent_hugepage/enabled allows them
+      PAGES     otherwise, or when huge pages are not asked for, a plain
+                anonymous mmap
+      HEAP      off Linux, or when mmap fails: malloc
+
+    Each chunk falls back on its own, and Backing() reports the weakest
+    backing in use. THP is a request: the kernel may still map small pages
+    where it cannot find a free 2 MiB frame (AnonHugePages in /proc/self/
+    smaps_rollup says how much it did map huge).
+
+      Allocate  ()        a block, from the free list or the current chunk;
+                          nullptr if the system refuses memory
+      Free      (p)       returns a block to the free list
+      Release   ()        returns every chunk to the system; no block may be live
+      BlockSize ()        bytes per block: the size asked for, rounded up to its alignment
+      Blocks    ()        blocks allocated and not freed
+      Reserved  ()        bytes taken from the system
+      Slack     ()        Reserved() less the bytes of the live blocks
+      HugePages ()        true if huge pages were asked for
+      Backing   ()        see above
+      Name      (b)       "heap", "4K pages", "THP" or "hugetlb"
+      HugePageSize ()     from /proc/meminfo, 2 MiB if unknown
+
+    A NodeArena is not synchronized, and its memory is not returned until
+    Release() or destruction: freed blocks are reused, LIFO.
+*/
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <cstdio>    // FILE, fscanf
+#include <cstdlib>   // malloc, free
+#include <cstring>   // strcmp
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace fsu
+{
+
+  class NodeArena
+  {
+  public:
+    enum BackingType { HEAP, PAGES, THP, HUGETLB };
+
+    explicit NodeArena (size_t blockSize, size_t align = sizeof(void*), bool hugePages = true)
+      : size_(Round(blockSize < sizeof(void*) ? sizeof(void*) : blockSize, align)), huge_(hugePages),
+        free_(nullptr), next_(nullptr), end_(nullptr), blocks_(0), reserved_(0), backing_(HUGETLB)
+    {}
+
+    ~NodeArena () { Unmap(); }
+
+    void* Allocate ()
+    {
+      void* p = free_;
+      if (p != nullptr)
+        free_ = *(void**)p;
+      else
+      {
+        if ((size_t)(end_ - next_) < size_ && !Grow())
+          return nullptr;
+        p = next_;
+        next_ += size_;
+      }
+      ++blocks_;
+      return p;
+    }
+
+    void Free (void* p)
+    {
+      *(void**)p = free_;
+      free_ = p;
+      --blocks_;
+    }
+
+    void Release ()
+    {
+      if (blocks_ == 0)
+        Unmap();
+    }
+
+    size_t      BlockSize () const { return size_; }
+    size_t      Blocks    () const { return blocks_; }
+    size_t      Reserved  () const { return reserved_; }
+    size_t      Slack     () const { return reserved_ - blocks_ * size_; }
+    bool        HugePages () const { return huge_; }
+    BackingType Backing   () const { return chunks_.empty() ? (huge_ ? THP : PAGES) : backing_; }
+
+    static const char* Name (BackingType b)
+    {
+      static const char* names[] = { "heap", "4K pages", "THP", "hugetlb" };
+      return names[b];
+    }
+
+    static size_t HugePageSize ()
+    {
+      static size_t bytes = 0;
+      if (bytes == 0)
+      {
+        bytes = 2 << 20;
+#if defined(__linux__)
+        FILE* f = fopen("/proc/meminfo", "r");
+        if (f)
+        {
+          char name[64];
+          unsigned long kb;
+          while (fscanf(f, "%63s %lu%*[^\n]", name, &kb) == 2)
+            if (strcmp(name, "Hugepagesize:") == 0)
+            {
+              bytes = kb << 10;
+              break;
+            }
+          fclose(f);
+        }
+#endif
+      }
+      return bytes;
+    }
+
+  private:
+    struct Chunk
+    {
+      char*       base;
+      size_t      bytes;
+      BackingType backing;
+    } ;
+
+    enum { minChunk = 2 << 20, maxChunk = 64 << 20 };
+
+    size_t             size_;
+    bool               huge_;
+    void*              free_;     // free list, linked through each block's first word
+    char*              next_;     // the unused end of the newest chunk
+    char*              end_;
+    size_t             blocks_;
+    size_t             reserved_;
+    BackingType        backing_;  // the weakest backing among the chunks
+    std::vector<Chunk> chunks_;
+
+    NodeArena (const NodeArena&);
+    NodeArena& operator = (const NodeArena&);
+
+    static size_t Round (size_t n, size_t m) { return (n + m - 1) / m * m; }
+
+    bool Grow ()
+    {
+      size_t bytes = chunks_.empty() ? (size_t)minChunk : chunks_.back().bytes * 2;
+      if (bytes > (size_t)maxChunk) bytes = maxChunk;
+      if (bytes < size_) bytes = Round(size_, minChunk);
+      Chunk c = { nullptr, bytes, HEAP };
+      Map(c);
+      if (c.base == nullptr)
+        return 0;
+      chunks_.push_back(c);
+      reserved_ += c.bytes;
+      if (c.backing < backing_) backing_ = c.backing;
+      next_ = c.base;
+      end_ = c.base + c.bytes;
+      return 1;
+    }
+
+    void Map (Chunk& c)
+    {
+#if defined(__linux__)
+#ifdef MAP_HUGETLB
+      if (huge_ && c.bytes % HugePageSize() == 0)
+      {
+        void* p = mmap(nullptr, c.bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+          c.base = (char*)p;
+          c.backing = HUGETLB;
+          return;
+        }
+      }
+#endif
+      size_t align = huge_ ? HugePageSize() : 0; // over-map, then trim to a huge page boundary
+      void* p = mmap(nullptr, c.bytes + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p != MAP_FAILED)
+      {
+        char* base = (char*)p;
+        if (align)
+        {
+          char* top = (char*)Round((uintptr_t)base, align);
+          if (top > base) munmap(base, top - base);
+          if (base + align > top) munmap(top + c.bytes, base + align - top);
+          base = top;
+        }
+        c.base = base;
+        c.backing = PAGES;
+#ifdef MADV_HUGEPAGE
+        if (huge_ && madvise(base, c.bytes, MADV_HUGEPAGE) == 0)
+          c.backing = THP;
+#endif
+        return;
+      }
+#endif
+      c.base = (char*)malloc(c.bytes);
+      c.backing = HEAP;
+    }
+
+    void Unmap ()
+    {
+      for (size_t i = 0; i < chunks_.size(); ++i)
+      {
+#if defined(__linux__)
+        if (chunks_[i].backing != HEAP)
+        {
+          munmap(chunks_[i].base, chunks_[i].bytes);
+          continue;
+        }
+#endif
+        free(chunks_[i].base);
+      }
+      chunks_.clear();
+      free_ = nullptr;
+      next_ = end_ = nullptr;
+      reserved_ = 0;
+      backing_ = HUGETLB;
+    }
+  } ;
+
+} // namespace fsu
+
+#endif
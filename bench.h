@@ -0,0 +1,203 @@
+/*
+    bench.h
+    10/18/26
+
+    Lightweight benchmark harness shared by the *bench drivers
+
+    classes/functions defined in this file
+    --------------------------------------
+
+    class Timer               // stopwatch on std::chrono::steady_clock
+    class BenchTable          // column-aligned report writer
+    BestOf (f, reps)          // minimum elapsed ns over reps calls of f()
+    BestOf (f, reps, sample)  // same, plus hardware counters of that fastest call
+    BenchCounters ()          // the process-wide PerfCounters used by BestOf
+    DoNotOptimize (t)         // keeps the optimizer from discarding a result
+
+    Timing is wall clock, best of several repetitions, which is the usual
+    choice for short deterministic workloads: the minimum is the run least
+    disturbed by the rest of the machine.
+
+    Ratio columns are always fsu / std, so a ratio above 1.00 means the fsu
+    container is slower (or larger) than its standard counterpart.
+
+    Where perf_event_open is permitted (see perfcount.h), BenchTable::Counters()
+    follows a row with cache, branch and TLB misses per operation for both
+    sides; elsewhere it prints nothing and the tables look as before.
+    BenchTable::Heap() does the same for allocations per operation and peak
+    heap, given a driver that installs the memtrack.h operators.
+*/
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <cstddef>   // size_t
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <perfcount.h>
+
+namespace fsu
+{
+
+  //--------------------
+  //    class Timer
+  //--------------------
+
+  class Timer
+  {
+  public:
+    Timer () : start_(Clock::now()) {}
+    void   Start       () { start_ = Clock::now(); }
+    double Nanoseconds () const
+    {
+      return std::chrono::duration<double, std::nano>(Clock::now() - start_).count();
+    }
+    double Seconds     () const { return 1.0e-9 * Nanoseconds(); }
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start_;
+  } ;
+
+  // returns the smallest elapsed time, in ns, among reps calls of f()
+  template < class F >
+  double BestOf (F f, size_t reps = 3)
+  {
+    double best = 0.0;
+    for (size_t i = 0; i < reps; ++i)
+    {
+      Timer t;
+      f();
+      double ns = t.Nanoseconds();
+      if (i == 0 || ns < best)
+        best = ns;
+    }
+    return best;
+  }
+
+  // counters are opened once per process and shared by every region
+  inline PerfCounters& BenchCounters ()
+  {
+    static PerfCounters counters;
+    return counters;
+  }
+
+  // as above; sample receives the counter readings of the fastest call
+  template < class F >
+  double BestOf (F f, size_t reps, PerfSample& sample)
+  {
+    PerfCounters& pc = BenchCounters();
+    double best = 0.0;
+    for (size_t i = 0; i < reps; ++i)
+    {
+      pc.Start();
+      Timer t;
+      f();
+      double ns = t.Nanoseconds();
+      PerfSample s = pc.Stop();
+      if (i == 0 || ns < best)
+      {
+        best = ns;
+        sample = s;
+      }
+    }
+    return best;
+  }
+
+  // forces t to be materialized; cheaper and more portable than a volatile sink
+  template < typename T >
+  inline void DoNotOptimize (const T& t)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&t) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &t;
+#endif
+  }
+
+  //-------------------------
+  //    class BenchTable
+  //-------------------------
+
+  class BenchTable
+  {
+  public:
+    explicit BenchTable (std::ostream& os = std::cout) : os_(os) {}
+
+    void Title (const char* title)
+    {
+      os_ << '\n' << title << '\n';
+      for (const char* p = title; *p; ++p) os_ << '-';
+      os_ << '\n'
+          << std::setw(28) << std::left << "workload" << std::right
+          << std::setw(12) << "fsu ns/op"
+          << std::setw(12) << "std ns/op"
+          << std::setw(8)  << "ratio"
+          << std::setw(12) << "fsu B/elt"
+          << std::setw(12) << "std B/elt"
+          << std::setw(8)  << "ratio" << '\n';
+    }
+
+    // times are per operation; byte counts are per element (pass 0 if not measured)
+    void Row (const char* name, double fsuNs, double stdNs, double fsuBytes = 0, double stdBytes = 0)
+    {
+      os_ << std::setw(28) << std::left << name << std::right
+          << std::fixed << std::setprecision(1)
+          << std::setw(12) << fsuNs
+          << std::setw(12) << stdNs
+          << std::setprecision(2)
+          << std::setw(8)  << Ratio(fsuNs, stdNs);
+      if (fsuBytes > 0 || stdBytes > 0)
+      {
+        os_ << std::setprecision(1)
+            << std::setw(12) << fsuBytes
+            << std::setw(12) << stdBytes
+            << std::setprecision(2)
+            << std::setw(8)  << Ratio(fsuBytes, stdBytes);
+      }
+      os_ << '\n';
+      os_.unsetf(std::ios::fixed);
+    }
+
+    // misses per operation, fsu / std, for the row just written; silent without counters
+    void Counters (const PerfSample& fsu, const PerfSample& std, double fsuOps, double stdOps)
+    {
+      if (!fsu.Any() && !std.Any())
+        return;
+      os_ << "    per op:" << std::fixed;
+      for (size_t e = PerfCounters::l1dMisses; e < PerfCounters::numEvents; ++e)
+      {
+        if (!fsu.Valid(e) && !std.Valid(e)) continue;
+        os_ << "  " << PerfCounters::Name(e) << ' ' << std::setprecision(2)
+            << fsu.PerOp(e, fsuOps) << '/' << std.PerOp(e, stdOps);
+      }
+      if (fsu.Ipc() > 0 || std.Ipc() > 0)
+        os_ << "  IPC " << fsu.Ipc() << '/' << std.Ipc();
+      os_ << '\n';
+      os_.unsetf(std::ios::fixed);
+    }
+
+    // allocation profile, fsu / std, for the row just written (see memtrack.h)
+    void Heap (double fsuAllocs, double stdAllocs, double fsuPeak, double stdPeak, double fsuOwned = 0)
+    {
+      if (fsuAllocs <= 0 && stdAllocs <= 0)
+        return;
+      os_ << "    heap:  " << std::fixed << std::setprecision(2)
+          << "allocs/op " << fsuAllocs << '/' << stdAllocs << std::setprecision(1)
+          << "  peak B/elt " << fsuPeak << '/' << stdPeak;
+      if (fsuOwned > 0)
+        os_ << "  MemoryUsage() B/elt " << fsuOwned;
+      os_ << '\n';
+      os_.unsetf(std::ios::fixed);
+    }
+
+  private:
+    static double Ratio (double a, double b) { return (b > 0) ? a / b : 0.0; }
+    std::ostream& os_;
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,171 @@
+/*
+    bloom.h
+    10/18/26
+
+    BloomFilter: a blocked Bloom filter over 64-bit hash values
+
+    A set that answers "certainly absent" or "possibly present". Map_ADT
+    puts one in front of Includes() and Retrieve() (Map_ADT::EnableFilter),
+    so most lookups of absent keys end after one cache line instead of a
+    full descent with key compares.
+
+      Insert     (h)         O(1)  add hash value h; true if it was not
+                                   already reported present
+      MayContain (h)         O(1)  false: h was never inserted
+                                   true:  h was inserted, or a false positive
+      Clear      ()                remove everything, keep the size
+      Reset      (capacity)        remove everything, resize for capacity keys
+      Count      ()                insertions that returned true
+      Capacity   ()                keys the filter was sized for
+
+    Layout: the bits form 512-bit blocks, each on its own 64-byte cache
+    line. The high 32 bits of h choose the block. The low 32 bits, multiplied
+    by eight odd constants, choose one bit in each of the block's eight
+    64-bit words. A probe therefore touches one cache line and sets or tests
+    8 bits, and the test has no data-dependent branches.
+
+    At the default 10 bits per key, a filter holding Capacity() keys
+    answers about 1% of absent keys with a false positive. The rate rises
+    as Count() goes past Capacity(). The owner should then Reset() to a
+    larger capacity and insert its keys again. Bits cannot be removed, so
+    erased keys stay "possibly present" until the next rebuild.
+
+    The hash values should already be well mixed (hashval.h).
+*/
+
+#ifndef _BLOOM_H
+#define _BLOOM_H
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <cstring>   // memset, memcpy
+
+namespace fsu
+{
+
+  class BloomFilter
+  {
+  public:
+    explicit BloomFilter (size_t capacity = 0, size_t bitsPerKey = 10)
+      : raw_(nullptr), bits_(nullptr), blocks_(0), capacity_(0), count_(0),
+        bitsPerKey_(bitsPerKey ? bitsPerKey : 1)
+    {
+      Reset(capacity);
+    }
+
+    BloomFilter (const BloomFilter& b)
+      : raw_(nullptr), bits_(nullptr), blocks_(0), capacity_(0), count_(0), bitsPerKey_(b.bitsPerKey_)
+    {
+      Copy(b);
+    }
+
+    BloomFilter& operator = (const BloomFilter& b)
+    {
+      if (this != &b)
+      {
+        bitsPerKey_ = b.bitsPerKey_;
+        Copy(b);
+      }
+      return *this;
+    }
+
+    ~BloomFilter ()
+    {
+      delete [] raw_;
+    }
+
+    bool Insert (uint64_t h)
+    {
+      uint64_t* b = Block(h);
+      uint64_t fresh = 0;
+      for (size_t i = 0; i < 8; ++i)
+      {
+        uint64_t m = Mask(h, i);
+        fresh |= ~b[i] & m;
+        b[i] |= m;
+      }
+      if (fresh == 0)
+        return 0;
+      ++count_;
+      return 1;
+    }
+
+    bool MayContain (uint64_t h) const
+    {
+      const uint64_t* b = Block(h);
+      uint64_t missing = 0;
+      for (size_t i = 0; i < 8; ++i)
+        missing |= ~b[i] & Mask(h, i);
+      return missing == 0;
+    }
+
+    void Clear ()
+    {
+      memset(bits_, 0, blocks_ * sizeof(uint64_t) * 8);
+      count_ = 0;
+    }
+
+    void Reset (size_t capacity)
+    {
+      size_t blocks = (capacity * bitsPerKey_ + 511) / 512;
+      if (blocks == 0) blocks = 1;
+      if (blocks != blocks_)
+      {
+        delete [] raw_;
+        raw_ = new uint64_t [blocks * 8 + 7];  // 7 spare words to align on 64 bytes
+        bits_ = Align(raw_);
+        blocks_ = blocks;
+      }
+      capacity_ = capacity;
+      Clear();
+    }
+
+    size_t Count       () const { return count_; }
+    size_t Capacity    () const { return capacity_; }
+    size_t BitsPerKey  () const { return bitsPerKey_; }
+    size_t MemoryUsage () const { return sizeof(*this) + (blocks_ * 8 + 7) * sizeof(uint64_t); }
+
+  private:
+    uint64_t* raw_;      // as allocated
+    uint64_t* bits_;     // raw_ rounded up to a 64-byte boundary
+    size_t    blocks_;
+    size_t    capacity_;
+    size_t    count_;
+    size_t    bitsPerKey_;
+
+    uint64_t* Block (uint64_t h) const
+    {
+      return bits_ + 8 * (((h >> 32) * blocks_) >> 32);
+    }
+
+    static uint64_t Mask (uint64_t h, size_t i)
+    {
+      static const uint32_t salt[8] =
+        { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+          0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+      return uint64_t(1) << (((uint32_t)h * salt[i]) >> 26);
+    }
+
+    static uint64_t* Align (uint64_t* p)
+    {
+      return (uint64_t*)(((uintptr_t)p + 63) & ~(uintptr_t)63);
+    }
+
+    void Copy (const BloomFilter& b)
+    {
+      if (blocks_ != b.blocks_)
+      {
+        delete [] raw_;
+        raw_ = new uint64_t [b.blocks_ * 8 + 7];
+        bits_ = Align(raw_);
+        blocks_ = b.blocks_;
+      }
+      memcpy(bits_, b.bits_, blocks_ * sizeof(uint64_t) * 8);
+      capacity_ = b.capacity_;
+      count_ = b.count_;
+    }
+  } ;
+
+} // namespace fsu
+
+#endif
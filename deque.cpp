@@ -169,6 +169,20 @@ size_t Deque<T>::Size() const
   return contentSize_ + end_ - beg_;
 }
 
+template <typename T>
+size_t Deque<T>::MemoryUsage() const
+// the circular content_ array is owned whole, used or not
+{
+  size_t bytes = sizeof(*this);
+  if (content_ != 0)
+  {
+    bytes += contentSize_ * sizeof(T);
+    for (size_t i = 0; i < contentSize_; ++i)
+      bytes += HeapUsage(content_[i]);
+  }
+  return bytes;
+}
+
 template <typename T>
 bool Deque<T>::PushFront(const T& Tval)
 {
@@ -38,6 +38,7 @@
 
 #include <iostream>
 #include <cstdlib> // size_t
+#include <memtrack.h> // HeapUsage()
 
 namespace fsu
 {
@@ -85,6 +86,7 @@ namespace fsu
     // Container class protocol
     bool      Empty       () const;
     size_t    Size        () const;
+    size_t    MemoryUsage () const;   // bytes owned, including unused slots
     bool      PushFront   (const T&);
     bool      PopFront    ();
     bool      PushBack    (const T&);
@@ -126,6 +128,9 @@ namespace fsu
   template < class T >
   bool     operator != (const Deque<T>&, const Deque<T>&); 
 
+  template < class T >
+  size_t HeapUsage (const Deque<T>& d) { return d.MemoryUsage() - sizeof(d); }
+
   //----------------------------------
   //     DequeIterator<T>
   //----------------------------------
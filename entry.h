@@ -49,9 +49,9 @@ namespace fsu
             DataType data_;  // default & copy constructor required
 
              Entry  ();
-    explicit Entry  (K k);
+    explicit Entry  (const K& k);
              Entry  (const Pair<K,D>& p); // converts Pair to Entry - may be implicit
-             Entry  (K k, D d);
+             Entry  (const K& k, const D& d);
              Entry  (const Entry& e);
     Entry&   operator =  (const Entry& e);
     bool     operator == (const Entry e2) const;
@@ -103,11 +103,11 @@ namespace fsu
   {}
 
   template <typename K, typename D>
-  Entry<K,D>::Entry(K k) : key_(k), data_()
+  Entry<K,D>::Entry(const K& k) : key_(k), data_()
   {}
 
   template <typename K, typename D>
-  Entry<K,D>::Entry(K k, D d) : key_(k), data_(d)
+  Entry<K,D>::Entry(const K& k, const D& d) : key_(k), data_(d)
   {}
 
   template <typename K, typename D>
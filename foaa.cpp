@@ -3,6 +3,10 @@
     03/13/15
 
     DumpBW now supported
+
+    foaa              commands from the keyboard
+    foaa comfile      commands from comfile, echoed
+    foaa -b comfile   commands from comfile, silent and timed (scriptbench.h)
 */
 
 #include <map_adt.h>
@@ -10,10 +14,14 @@
 #include <fstream>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>  // EXIT_FAILURE
+#include <scriptbench.h>
 
 // <String, int>
 #include <xstring.h>
 #include <xstring.cpp>  // in lieu of makefile
+#include <tableload.h>
 typedef fsu::String KeyType;
 typedef int         DataType;
 const char fill = '-';
@@ -36,6 +44,22 @@ int CorrectDataWidth(const fsu::String& t, int dw)
   return dw;
 }
 
+// the command type a bench run files each command under
+
+fsu::ScriptBench::Op BenchOp (char command)
+{
+  switch (command)
+  {
+    case '1':                               return fsu::ScriptBench::PUT;
+    case '2': case '[':                     return fsu::ScriptBench::GET;
+    case 'e': case 'E':                     return fsu::ScriptBench::ERASE;
+    case 't': case 'T': case 'd': case 'D': return fsu::ScriptBench::TRAVERSAL;
+    case 'h': case 'H':                     return fsu::ScriptBench::REHASH;
+    case 'l': case 'L':                     return fsu::ScriptBench::LOAD;
+    default:                                return fsu::ScriptBench::OTHER;
+  }
+}
+
 void DisplayMenu(std::ostream& os = std::cout);
 
 // copy test
@@ -121,17 +145,33 @@ int main(int argc, char* argv[])
   KeyType     key;
   DataType    data;
   char        command;
-  size_t      size, numnodes, nsize, digits, ndigits;
+  size_t      size, numnodes;
   int dw1 = 1, dw2 = 1;
   std::ifstream com;
-  std::ifstream ifs;
+  fsu::TableLoadInfo info;
   std::istream * inptr = &std::cin;
-  bool BATCH = 0;
-  if (argc > 1)
+  bool BATCH = 0, BENCH = 0;
+  fsu::ScriptBench bench;
+  if (argc > 2 && strcmp(argv[1], "-b") == 0)
+  {
+    BATCH = BENCH = 1;
+    if (!bench.Open(argv[2]))
+    {
+      std::cerr << " ** cannot read script file " << argv[2] << '\n';
+      return EXIT_FAILURE;
+    }
+    inptr = &bench.Script();
+    bench.Begin();
+  }
+  else if (argc > 1)
   {
     BATCH = 1;
     com.open(argv[1]);
-    if (com.fail()) return 0;
+    if (com.fail())
+    {
+      std::cerr << " ** cannot open command file " << argv[1] << '\n';
+      return EXIT_FAILURE;
+    }
     inptr = &com;
   }
   if (!BATCH) DisplayMenu();
@@ -139,6 +179,8 @@ int main(int argc, char* argv[])
   {
     std::cout << "command ('M' for menu, 'Q' to quit): ";
     *inptr >> command;
+    if (BENCH && inptr->fail()) break; // script ended without Q
+    if (BENCH) bench.Start(BenchOp(command));
     if (BATCH) std::cout << command;
     switch(command)
     {
@@ -250,11 +292,12 @@ int main(int argc, char* argv[])
       if (BATCH) std::cout << '\n';
       std::cout << std::setw (3+dw1) << "key" << std::setw(3+dw2) << "data" << '\n';
       std::cout << std::setw (3+dw1) << "---" << std::setw(3+dw2) << "----" << '\n';
-      aa.Display(std::cout,3+dw1,3+dw2);
+      for (fsu::Map_ADT<KeyType,DataType>::ConstIterator i = aa.Begin(); i != aa.End(); ++i)
+        std::cout << std::setw (3+dw1) << (*i).key_ << std::setw(3+dw2) << (*i).data_ << '\n';
       std::cout << '\n';
       break;
     case 'x': case 'X':
-      if (BATCH)
+      if (BATCH && !BENCH)
       {
         std::cout << '\n';
         inptr = &std::cin;
@@ -276,28 +319,13 @@ int main(int argc, char* argv[])
     case 'l': case 'L':
       *inptr >> key;
       if (BATCH) std::cout << ' ' << key << '\n';
-      ifs.open(key.Cstr());
-      if (ifs.fail())
+      if (!fsu::LoadTable(key.Cstr(), aa, info))
       {
         std::cout << "  ** Unable to open file " << key << '\n';
-        ifs.clear();
         break;
       }
-      size = 0;
-      digits = 0;
-      while (ifs >> key >> data)
-      {
-        aa[key] = data;
-        // aa[key] += data;
-        nsize = key.Size();
-        ndigits = 1 + (size_t)log10(data);
-        if (size < nsize) size = nsize;
-        if (digits < ndigits) digits = ndigits;
-      }
-      if (dw1 < (int)size)   dw1 = size;
-      if (dw2 < (int)digits) dw2 = digits;
-      ifs.clear();
-      ifs.close();
+      if (dw1 < (int)info.keyWidth)  dw1 = info.keyWidth;
+      if (dw2 < (int)info.dataWidth) dw2 = info.dataWidth;
       std::cout << "  ** table data read and stored\n";
       break;
     case 'H': case 'h':
@@ -322,8 +350,10 @@ int main(int argc, char* argv[])
       // while (command != '\n')
       //   command = *inptr.get(); 
     }
+    if (BENCH) bench.Stop();
   }
   while (command != 'q');
+  if (BENCH) bench.Report(std::cout);
 }
 
 void DisplayMenu(std::ostream& os)
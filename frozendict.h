@@ -0,0 +1,452 @@
+/*
+    frozendict.h
+    10/18/26
+
+    FrozenHashDict < D >: an immutable String -> D dictionary on a minimal
+    perfect hash function
+
+    Built once from a Map_ADT<String,D> or from a list of keys, then only
+    read. A lookup costs one string hash, three or four cache lines, and at
+    most one key comparison. The whole dictionary is one contiguous image,
+    so Save() writes it to a file as-is and Load() maps that file into
+    memory with mmap, with no parsing and no allocation.
+
+      Build     (map)          O(n)  live entries of a Map_ADT<String,D,P>
+      BuildKeys (beg, end)     O(n)  keys from a range of String, data D()
+      Find      (key)          O(1)  pointer to the key's data, or nullptr
+      Includes  (key)          O(1)
+      Retrieve  (key, d)       O(1)  as in Map_ADT
+      Save      (path)               write the image; false on failure
+      Load      (path)               mmap an image written by Save; false if the
+                                     file is missing, damaged, or built for
+                                     another D. The current contents stay.
+      IsImage   (path)               true if the file starts as Save writes one,
+                                     whether or not Load would accept it
+      Size, Clear, Mapped, MemoryUsage
+      Key (i), Data (i)              slot i, 0 <= i < Size(), in hash order
+
+    The hash function is "hash and displace" (CHD, PTHash), with n slots
+    for n keys. The keys are split into about n/4 buckets by hash. Buckets
+    are placed largest first. For each bucket the builder searches for a
+    32-bit pilot value that sends all its keys to free slots. The key is
+    then stored in its slot. A lookup hashes the key, reads its bucket's
+    pilot, computes the slot, and compares the key stored there: an absent
+    key fails that single comparison. The pilots take 8 bits per key and
+    the slot offsets 32 bits per key.
+
+    image layout (every section starts on an 8-byte boundary)
+    ------------
+
+      Header                 magic, version, sizeof(D), byte order, n, buckets,
+                             seed, total bytes
+      uint32_t  pilot [buckets]
+      uint32_t  offset [n + 1]   key i is keys[offset[i] .. offset[i+1]-1), NUL included
+      D         data [n]
+      char      keys [..]
+
+    D must be trivially copyable and at most 8-byte aligned. A file can
+    only be read on a machine with the same byte order, which Load()
+    checks.
+*/
+
+#ifndef _FROZENDICT_H
+#define _FROZENDICT_H
+
+#include <cstddef>     // size_t
+#include <cstdint>
+#include <cstring>     // memcpy, memcmp, strlen
+#include <fstream>
+#include <vector>
+#include <type_traits>
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <xstring.h>
+#include <hashval.h>
+#include <map_adt.h>
+
+namespace fsu
+{
+
+  template < typename D >
+  class FrozenHashDict
+  {
+    static_assert(std::is_trivially_copyable<D>::value, "FrozenHashDict: D must be trivially copyable");
+    static_assert(alignof(D) <= 8, "FrozenHashDict: D must be at most 8-byte aligned");
+
+  public:
+    typedef String KeyType;
+    typedef D      DataType;
+
+    FrozenHashDict  () : image_(nullptr), bytes_(0), mapped_(0)
+    {
+      Attach();
+    }
+
+    ~FrozenHashDict ()
+    {
+      Clear();
+    }
+
+    template < class P >
+    bool Build (const Map_ADT<String,D,P>& m);
+
+    template < class I >
+    bool BuildKeys (I beg, I end)
+    {
+      Map_ADT<String,D> m;   // removes duplicates
+      for ( ; beg != end; ++beg)
+        m.Put(*beg, D());
+      return Build(m);
+    }
+
+    const D* Find (const char* key, size_t len) const
+    {
+      if (size_ == 0)
+        return nullptr;
+      uint64_t h = Hash(key, len, header_->seed);
+      size_t   s = Slot(h, pilot_[Bucket(h, header_->buckets)], size_);
+      if (offset_[s + 1] - offset_[s] - 1 != len || memcmp(keys_ + offset_[s], key, len) != 0)
+        return nullptr;
+      return data_ + s;
+    }
+
+    const D* Find (const String& key) const
+    {
+      const char* p = key.Cstr();
+      return p ? Find(p, strlen(p)) : Find("", 0);
+    }
+
+    bool Includes (const String& key) const
+    {
+      return Find(key) != nullptr;
+    }
+
+    bool Retrieve (const String& key, D& d) const
+    {
+      const D* p = Find(key);
+      if (p == nullptr)
+        return 0;
+      d = *p;
+      return 1;
+    }
+
+    size_t      Size        () const { return size_; }
+    bool        Empty       () const { return size_ == 0; }
+    bool        Mapped      () const { return mapped_; }
+    size_t      MemoryUsage () const { return sizeof(*this) + bytes_; }  // mapped bytes included
+    const char* Key         (size_t i) const { return keys_ + offset_[i]; }
+    const D&    Data        (size_t i) const { return data_[i]; }
+
+    void Clear ()
+    {
+      if (mapped_)
+        munmap(image_, bytes_);
+      else
+        delete [] image_;
+      image_  = nullptr;
+      bytes_  = 0;
+      mapped_ = 0;
+      Attach();
+    }
+
+    bool Save (const char* path) const
+    {
+      if (image_ == nullptr)
+        return 0;
+      std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!out)
+        return 0;
+      out.write(image_, bytes_);
+      out.close();
+      return !out.fail();
+    }
+
+    bool Load (const char* path);
+
+    static bool IsImage (const char* path)
+    {
+      Header want;
+      Stamp(want);
+      char magic[8];
+      std::ifstream in(path, std::ios::binary);
+      return in.read(magic, 8) && memcmp(magic, want.magic, 8) == 0;
+    }
+
+  private:
+    struct Header
+    {
+      char     magic [8];
+      uint32_t version;
+      uint32_t dataSize;   // sizeof(D)
+      uint32_t order;      // 0x01020304 as written
+      uint32_t unused;
+      uint64_t size;       // n
+      uint64_t buckets;
+      uint64_t seed;
+      uint64_t bytes;      // whole image
+    } ;
+
+    char*           image_;
+    size_t          bytes_;
+    bool            mapped_;
+    // views into image_
+    const Header*   header_;
+    size_t          size_;
+    const uint32_t* pilot_;
+    const uint32_t* offset_;
+    const D*        data_;
+    const char*     keys_;
+
+    static size_t Pad8 (size_t b) { return (b + 7) & ~(size_t)7; }
+
+    static uint64_t Hash (const char* key, size_t len, uint64_t seed)
+    {
+      return HashMix(HashBytes(key, len) + seed);
+    }
+
+    static size_t Bucket (uint64_t h, uint64_t buckets)
+    {
+      return (size_t)(((h >> 32) * buckets) >> 32);
+    }
+
+    static size_t Slot (uint64_t h, uint32_t pilot, size_t n)
+    {
+      uint64_t x = HashMix(h ^ (pilot * 0x9E3779B97F4A7C15ULL));
+      return (size_t)(((x >> 32) * n) >> 32);
+    }
+
+    // offsets of the sections after the header
+    static void Layout (uint64_t n, uint64_t buckets, size_t& pilot, size_t& offset, size_t& data, size_t& keys)
+    {
+      pilot  = Pad8(sizeof(Header));
+      offset = pilot + Pad8(buckets * sizeof(uint32_t));
+      data   = offset + Pad8((n + 1) * sizeof(uint32_t));
+      keys   = data + Pad8(n * sizeof(D));
+    }
+
+    void Attach ()
+    {
+      header_ = (const Header*)image_;
+      size_   = image_ ? (size_t)header_->size : 0;
+      if (image_ == nullptr)
+      {
+        pilot_ = offset_ = nullptr;
+        data_ = nullptr;
+        keys_ = nullptr;
+        return;
+      }
+      size_t p, o, d, k;
+      Layout(header_->size, header_->buckets, p, o, d, k);
+      pilot_  = (const uint32_t*)(image_ + p);
+      offset_ = (const uint32_t*)(image_ + o);
+      data_   = (const D*)(image_ + d);
+      keys_   = image_ + k;
+    }
+
+    static void Stamp (Header& h)
+    {
+      memcpy(h.magic, "FSUFHD1", 8);
+      h.version  = 1;
+      h.dataSize = sizeof(D);
+      h.order    = 0x01020304;
+      h.unused   = 0;
+    }
+
+    // pilot search over one seed; false if some bucket found no pilot
+    static bool Place (const std::vector<uint64_t>& hash, uint64_t buckets,
+                       std::vector<uint32_t>& pilot, std::vector<uint32_t>& slot);
+
+    FrozenHashDict (const FrozenHashDict&);
+    FrozenHashDict& operator = (const FrozenHashDict&);
+  } ;
+
+  template < typename D >
+  bool FrozenHashDict<D>::Place (const std::vector<uint64_t>& hash, uint64_t buckets,
+                                 std::vector<uint32_t>& pilot, std::vector<uint32_t>& slot)
+  {
+    size_t n = hash.size();
+    // group the keys by bucket (counting sort), then order buckets by size, largest first
+    std::vector<uint32_t> start(buckets + 1, 0), member(n);
+    for (size_t i = 0; i < n; ++i)
+      ++start[Bucket(hash[i], buckets) + 1];
+    size_t maxSize = 0;
+    for (size_t b = 0; b < buckets; ++b)
+      if (maxSize < start[b + 1]) maxSize = start[b + 1];
+    std::vector<uint32_t> bySize(maxSize + 2, 0), order(buckets);
+    for (size_t b = 0; b < buckets; ++b)
+      ++bySize[maxSize - start[b + 1] + 1];
+    for (size_t s = 1; s < bySize.size(); ++s)
+      bySize[s] += bySize[s - 1];
+    for (size_t b = 0; b < buckets; ++b)
+      order[bySize[maxSize - start[b + 1]]++] = (uint32_t)b;
+    for (size_t b = 0; b < buckets; ++b)
+      start[b + 1] += start[b];
+    std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < n; ++i)
+      member[fill[Bucket(hash[i], buckets)]++] = (uint32_t)i;
+
+    // a bucket of one needs about n / (free slots) tries; this bound is
+    // reached with odds far below those of a hardware fault
+    uint64_t limit = 64 * (uint64_t)n + 1024;
+    if (limit > UINT32_MAX) limit = UINT32_MAX;
+    std::vector<uint8_t> taken(n, 0);
+    pilot.assign(buckets, 0);
+    slot.assign(n, 0);
+    for (size_t o = 0; o < buckets; ++o)
+    {
+      size_t b = order[o], lo = start[b], hi = start[b + 1];
+      if (lo == hi)
+        break;                      // the rest are empty
+      uint64_t p = 0;
+      for ( ; p < limit; ++p)
+      {
+        size_t j = lo;
+        for ( ; j < hi; ++j)
+        {
+          size_t s = Slot(hash[member[j]], (uint32_t)p, n);
+          if (taken[s])
+            break;
+          taken[s] = 1;             // also catches two keys of the bucket in one slot
+          slot[member[j]] = (uint32_t)s;
+        }
+        if (j == hi)
+          break;
+        while (j-- > lo)
+          taken[slot[member[j]]] = 0;
+      }
+      if (p == limit)
+        return 0;
+      pilot[b] = (uint32_t)p;
+    }
+    return 1;
+  }
+
+  template < typename D >
+  template < class P >
+  bool FrozenHashDict<D>::Build (const Map_ADT<String,D,P>& m)
+  {
+    std::vector<const char*> key;
+    std::vector<uint32_t>    len;
+    std::vector<D>           data;
+    size_t keyBytes = 0;
+    for (typename Map_ADT<String,D,P>::ConstIterator i = m.Begin(); i != m.End(); ++i)
+    {
+      const char* p = (*i).key_.Cstr();
+      if (p == nullptr) p = "";
+      key.push_back(p);
+      len.push_back((uint32_t)strlen(p));
+      data.push_back((*i).data_);
+      keyBytes += len.back() + 1;
+    }
+    size_t n = key.size();
+    if (n >= UINT32_MAX || keyBytes > UINT32_MAX)
+      return 0;
+
+    uint64_t buckets = n / 4 + 1;
+    std::vector<uint64_t> hash(n);
+    std::vector<uint32_t> pilot, slot;
+    uint64_t seed = 0;
+    for (;; ++seed)
+    {
+      if (seed == 16)
+        return 0;                   // sixteen failed seeds: not a sane key set
+      for (size_t i = 0; i < n; ++i)
+        hash[i] = Hash(key[i], len[i], seed);
+      if (Place(hash, buckets, pilot, slot))
+        break;
+    }
+
+    size_t po, oo, dd, kk;
+    Layout(n, buckets, po, oo, dd, kk);
+    size_t bytes = kk + keyBytes;
+    char* image = new char [bytes];
+    memset(image, 0, kk);
+    Header h;
+    Stamp(h);
+    h.size    = n;
+    h.buckets = buckets;
+    h.seed    = seed;
+    h.bytes   = bytes;
+    memcpy(image, &h, sizeof(h));
+    memcpy(image + po, pilot.data(), buckets * sizeof(uint32_t));
+
+    // keys and data go to their slots; the offsets are a prefix sum of lengths
+    std::vector<uint32_t> at(n);
+    for (size_t i = 0; i < n; ++i)
+      at[slot[i]] = (uint32_t)i;
+    uint32_t* offset = (uint32_t*)(image + oo);
+    D*        d      = (D*)(image + dd);
+    char*     k      = image + kk;
+    uint32_t  off    = 0;
+    for (size_t s = 0; s < n; ++s)
+    {
+      size_t i = at[s];
+      offset[s] = off;
+      memcpy(k + off, key[i], len[i] + 1);
+      off += len[i] + 1;
+      memcpy((void*)(d + s), (const void*)&data[i], sizeof(D));
+    }
+    offset[n] = off;
+
+    Clear();
+    image_ = image;
+    bytes_ = bytes;
+    Attach();
+    return 1;
+  }
+
+  template < typename D >
+  bool FrozenHashDict<D>::Load (const char* path)
+  {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+      return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header))
+    {
+      close(fd);
+      return 0;
+    }
+    size_t bytes = (size_t)st.st_size;
+    void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);              // the mapping stays valid
+    if (p == MAP_FAILED)
+      return 0;
+
+    Header want, h;
+    Stamp(want);
+    memcpy(&h, p, sizeof(h));
+    bool ok = memcmp(h.magic, want.magic, 8) == 0 && h.version == want.version
+              && h.dataSize == want.dataSize && h.order == want.order
+              && h.bytes == bytes && h.size < UINT32_MAX && h.buckets == h.size / 4 + 1;
+    if (ok)
+    {
+      size_t po, oo, dd, kk;
+      Layout(h.size, h.buckets, po, oo, dd, kk);
+      const uint32_t* offset = (const uint32_t*)((const char*)p + oo);
+      ok = kk <= bytes && offset[0] == 0 && kk + offset[h.size] == bytes;
+      // each key takes its length and a NUL, so the offsets rise, and Find
+      // and Key() stay inside the keys
+      const char* k = (const char*)p + kk;
+      for (size_t s = 0; ok && s < h.size; ++s)
+        ok = offset[s] < offset[s + 1] && offset[s + 1] <= offset[h.size] && k[offset[s + 1] - 1] == '\0';
+    }
+    if (!ok)
+    {
+      munmap(p, bytes);
+      return 0;
+    }
+    Clear();
+    image_  = (char*)p;
+    bytes_  = bytes;
+    mapped_ = 1;
+    Attach();
+    return 1;
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,94 @@
+/*
+    gbsearch.h
+    10/18/26
+
+    Generic binary search
+
+    I     random access iterator class (raw pointer, Deque<T>::Iterator)
+    T     ValueType
+    P     order predicate class; the range must be sorted by P
+
+    g_lower_bound   (beg, end, t [, p])  // first position not before t
+    g_upper_bound   (beg, end, t [, p])  // first position after t
+    g_binary_search (beg, end, t [, p])  // true iff some element is equivalent to t
+
+    [g_lower_bound, g_upper_bound) is the run of elements equivalent to t
+    (neither p(x,t) nor p(t,x)); both are O(log n) comparisons. The forms
+    without a predicate use LessThan<T>, so a range sorted with
+    g_sort(beg, end, GreaterThan<T>()) is searched with the same predicate.
+*/
+
+#ifndef _GBSEARCH_H
+#define _GBSEARCH_H
+
+#include <compare.h>  // LessThan
+
+namespace fsu
+{
+
+  template <class I, typename T, class P>
+  I g_lower_bound (I beg, I end, const T& t, const P& p)
+  {
+    long n = end - beg;
+    while (n > 0)
+    {
+      long half = n / 2;
+      I mid = beg + half;
+      if (p(*mid, t))
+      {
+        beg = mid + 1;
+        n -= half + 1;
+      }
+      else
+        n = half;
+    }
+    return beg;
+  }
+
+  template <class I, typename T>
+  I g_lower_bound (I beg, I end, const T& t)
+  {
+    return g_lower_bound(beg, end, t, LessThan<T>());
+  }
+
+  template <class I, typename T, class P>
+  I g_upper_bound (I beg, I end, const T& t, const P& p)
+  {
+    long n = end - beg;
+    while (n > 0)
+    {
+      long half = n / 2;
+      I mid = beg + half;
+      if (!p(t, *mid))
+      {
+        beg = mid + 1;
+        n -= half + 1;
+      }
+      else
+        n = half;
+    }
+    return beg;
+  }
+
+  template <class I, typename T>
+  I g_upper_bound (I beg, I end, const T& t)
+  {
+    return g_upper_bound(beg, end, t, LessThan<T>());
+  }
+
+  template <class I, typename T, class P>
+  bool g_binary_search (I beg, I end, const T& t, const P& p)
+  {
+    I i = g_lower_bound(beg, end, t, p);
+    return i != end && !p(t, *i);
+  }
+
+  template <class I, typename T>
+  bool g_binary_search (I beg, I end, const T& t)
+  {
+    return g_binary_search(beg, end, t, LessThan<T>());
+  }
+
+} // namespace fsu
+
+#endif
@@ -10,34 +10,180 @@
     P     predicate class (may be unary or binary, depending on context)
     F     function class  (context determined)
 
+    g_fill, g_fill_n and g_copy dispatch at compile time on the iterator
+    and value types (10/18/26):
+
+      raw pointers, trivially copyable T    g_copy  -> memmove
+      raw pointers, byte-sized T            g_fill  -> memset
+      raw pointers, other trivially copyable T      -> indexed loop on a
+                                               local copy of t, which the
+                                               compiler vectorizes
+      anything else (List, Deque, Map iterators, class types with their
+      own operator =)                               -> the element loop
+
+    As with std::copy, g_copy's destination must not start inside
+    (source_beg, source_end); every other overlap copies correctly.
+
+    g_find and the predicate-free g_min_element, g_max_element take the
+    vector kernels in gsimd.h for raw pointers to arithmetic types (t of
+    the element type, for g_find); results are those of the loops below.
+
     Copyright 2009 - 2011, R.C. Lacher
 */
 
 #ifndef _GENALG_H
 #define _GENALG_H
 
+#include <cstddef>      // size_t
+#include <cstring>      // memmove, memset
+#include <type_traits>
+#include <gsimd.h>      // vector find, min, max
+
 namespace fsu
 {
 
+  namespace genalg
+  {
+    // the value type behind a raw pointer, or void for anything else
+    template <class I> struct Pointee      { typedef void type; } ;
+    template <class T> struct Pointee <T*> { typedef T    type; } ;
+
+    // I -> J copy may be a memmove: both raw pointers to the same trivially copyable T
+    template <class I, class J>
+    struct IsBlockCopy : std::integral_constant < bool,
+      std::is_pointer<I>::value && std::is_pointer<J>::value &&
+      !std::is_volatile<typename Pointee<I>::type>::value &&
+      std::is_same < typename std::remove_cv<typename Pointee<I>::type>::type,
+                     typename Pointee<J>::type >::value &&
+      std::is_trivially_copyable<typename Pointee<J>::type>::value > {} ;
+
+    // fill through I may skip the element loop: raw pointer to a trivially copyable T
+    template <class I, typename T>
+    struct IsBlockFill : std::integral_constant < bool,
+      std::is_pointer<I>::value &&
+      !std::is_const<typename Pointee<I>::type>::value &&
+      !std::is_volatile<typename Pointee<I>::type>::value &&
+      std::is_trivially_copyable<typename Pointee<I>::type>::value &&
+      std::is_convertible<T, typename Pointee<I>::type>::value > {} ;
+
+    template <class I, typename T>
+    void FillN (I beg, size_t n, const T& t, std::false_type)
+    {
+      while (n-- > 0)
+        *beg++ = t;
+    }
+
+    template <typename U, typename T>
+    void FillN (U* beg, size_t n, const T& t, std::true_type)
+    {
+      const U u = t;  // a local copy cannot alias the range, so the loop vectorizes
+      if (sizeof(U) == 1)
+      {
+        memset(beg, *(const unsigned char*)&u, n);
+        return;
+      }
+      for (size_t i = 0; i < n; ++i)
+        beg[i] = u;
+    }
+
+    template <class I, typename T>
+    void Fill (I beg, I end, const T& t, std::false_type)
+    {
+      while (beg != end)
+        *beg++ = t;
+    }
+
+    template <typename U, typename T>
+    void Fill (U* beg, U* end, const T& t, std::true_type)
+    {
+      if (end > beg)
+        FillN(beg, (size_t)(end - beg), t, std::true_type());
+    }
+
+    template <class I, class J>
+    void Copy (I source_beg, I source_end, J dest_beg, std::false_type)
+    {
+      while (source_beg != source_end) 
+        *dest_beg++ = *source_beg++;
+    }
+
+    template <typename S, typename U>
+    void Copy (S* source_beg, S* source_end, U* dest_beg, std::true_type)
+    {
+      if (source_end > source_beg)
+        memmove(dest_beg, source_beg, (size_t)(source_end - source_beg) * sizeof(U));
+    }
+
+    // element type of raw pointer I, if gsimd has kernels for it
+    template <class I>
+    struct SimdElement : std::remove_cv<typename Pointee<I>::type> {} ;
+
+    template <class I, typename T>
+    struct IsSimdFind : std::integral_constant < bool,
+      std::is_pointer<I>::value &&
+      !std::is_volatile<typename Pointee<I>::type>::value &&
+      std::is_same<typename SimdElement<I>::type, T>::value &&
+      gsimd::Kind<T>::find > {} ;
+
+    template <class I>
+    struct IsSimdExtreme : std::integral_constant < bool,
+      std::is_pointer<I>::value &&
+      !std::is_volatile<typename Pointee<I>::type>::value &&
+      gsimd::Kind<typename SimdElement<I>::type>::extreme > {} ;
+
+    template <class I, typename T>
+    I Find (I beg, I end, const T& t, std::false_type)
+    {
+      for ( ; beg != end; ++beg)
+        if (t == *beg)
+          return beg;
+      return end;
+    }
+
+    template <typename U, typename T>
+    U* Find (U* beg, U* end, const T& t, std::true_type)
+    {
+      if (end <= beg) return end;
+      return beg + gsimd::Find<T>(beg, (size_t)(end - beg), t);
+    }
+
+    template <bool Max, class I>
+    I Extreme (I beg, I end, std::false_type)
+    {
+      if (beg == end)
+        return beg;
+      I e (beg);
+      while (++beg != end)
+        if (Max ? *e < *beg : *beg < *e)
+          e = beg;
+      return e;
+    }
+
+    template <bool Max, typename U>
+    U* Extreme (U* beg, U* end, std::true_type)
+    {
+      if (end <= beg) return beg;
+      typedef typename std::remove_cv<U>::type E;
+      return beg + gsimd::Extreme<Max,E>(beg, (size_t)(end - beg));
+    }
+  } // namespace genalg
+
   template <class I, typename T>
   void g_fill (I beg, I end, const T& t)
   {
-    while (beg != end)
-      *beg++ = t;
+    genalg::Fill(beg, end, t, genalg::IsBlockFill<I,T>());
   }
 
   template <class I, typename T>
   void g_fill_n (I beg, unsigned int n, const T& t)
   {
-    while (n-- > 0)
-      *beg++ = t;
+    genalg::FillN(beg, n, t, genalg::IsBlockFill<I,T>());
   }
 
   template <class I, class J>
   void g_copy (I source_beg, I source_end, J dest_beg)
   {
-    while (source_beg != source_end) 
-      *dest_beg++ = *source_beg++;
+    genalg::Copy(source_beg, source_end, dest_beg, genalg::IsBlockCopy<I,J>());
   }
 
   template <class I, class J>
@@ -50,13 +196,7 @@ namespace fsu
   template <class I>
   I g_min_element (I beg, I end)
   {
-    if (beg == end)
-      return beg;
-    I min (beg);  
-    while (++beg != end)
-      if (*beg < *min)
-	min = beg;
-    return min;
+    return genalg::Extreme<false>(beg, end, genalg::IsSimdExtreme<I>());
   }
 
   template <class I, class P>
@@ -74,13 +214,7 @@ namespace fsu
   template <class I>
   I g_max_element (I beg, I end)
   {
-    if (beg == end)
-      return beg;
-    I max (beg);  
-    while (++beg != end)
-      if (*max < *beg)
-	max = beg;
-    return max;
+    return genalg::Extreme<true>(beg, end, genalg::IsSimdExtreme<I>());
   }
 
   template <class I, class P>
@@ -99,10 +233,7 @@ namespace fsu
   template <class I, typename T>
   I g_find (I beg, I end, const T& t)
   {
-    for ( ; beg != end; ++beg)
-      if (t == *beg)
-	return beg;
-    return end;
+    return genalg::Find(beg, end, t, genalg::IsSimdFind<I,T>());
   }
 
   template <class I, class P>
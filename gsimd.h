@@ -0,0 +1,471 @@
+/*
+    gsimd.h
+    10/18/26
+
+    Vector kernels behind g_find, g_min_element and g_max_element
+
+    genalg.h sends these calls here when the iterators are raw pointers
+    (Vector<T>::Iterator) and the element type is arithmetic:
+
+      g_find          1-byte integers              memchr
+                      4- and 8-byte integers,      vector compare
+                      float, double
+      g_min_element   4-byte integers,             vector min/max
+      g_max_element   float, double
+
+    On x86-64 there are two kernel widths. AVX2 (256 bits) is chosen at
+    run time when the CPU supports it. SSE2 (128 bits) is part of every
+    x86-64 CPU and is used otherwise. On other targets, or when
+    FSU_NO_SIMD is defined, the scalar loops run.
+
+    Results are the same as the scalar loops in genalg.h:
+
+      g_find          the first i with t == *i (floating point: -0.0
+                      equals 0.0, and a NaN never matches)
+      g_min/max       the first extreme element: one vector pass finds
+                      the extreme value, a vector g_find locates it
+
+    A float range that contains a NaN goes back to the scalar loop.
+    With NaNs the scalar answer depends on where they are, and the
+    vector min/max instructions cannot reproduce that.
+
+    SetLevel() caps the kernel width for testing (gbench checks every
+    level against the scalar loops). It is not synchronized: call it
+    only while no other thread is searching.
+
+      fsu::gsimd::SetLevel(fsu::gsimd::sse2);  // never use AVX2
+      fsu::gsimd::LevelName()                  // "avx2", "sse2" or "scalar"
+*/
+
+#ifndef _GSIMD_H
+#define _GSIMD_H
+
+#include <cstddef>      // size_t
+#include <cstdint>
+#include <cstring>      // memchr
+#include <type_traits>
+
+#if !defined(FSU_NO_SIMD) && defined(__x86_64__) && defined(__GNUC__)
+#  define FSU_GSIMD_X86
+#  include <immintrin.h>
+#  define FSU_GSIMD_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace fsu
+{
+
+  namespace gsimd
+  {
+    enum { scalar = 0, sse2 = 1, avx2 = 2 };
+
+    // the widest level this CPU runs
+    inline int Detect ()
+    {
+#ifdef FSU_GSIMD_X86
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? avx2 : sse2;
+#else
+      return scalar;
+#endif
+    }
+
+    inline int& LevelRef () { static int level = Detect(); return level; }
+    inline int  Level    () { return LevelRef(); }
+
+    // caps the level in use at l (never above Detect()); returns the previous level
+    inline int SetLevel (int l)
+    {
+      int old = LevelRef();
+      int hw  = Detect();
+      LevelRef() = (l < hw) ? l : hw;
+      return old;
+    }
+
+    inline const char* LevelName (int l)
+    {
+      return (l == avx2) ? "avx2" : (l == sse2) ? "sse2" : "scalar";
+    }
+    inline const char* LevelName () { return LevelName(Level()); }
+
+    // which element types the kernels take
+    template <typename U>
+    struct Kind
+    {
+      static const bool integral = std::is_integral<U>::value && !std::is_same<U,bool>::value;
+      static const bool floating = std::is_same<U,float>::value || std::is_same<U,double>::value;
+      static const bool find     = floating || (integral && (sizeof(U) == 1 || sizeof(U) == 4 || sizeof(U) == 8));
+      static const bool extreme  = floating || (integral && sizeof(U) == 4);
+    } ;
+
+    template <>
+    struct Kind <void>   // not a raw pointer
+    {
+      static const bool integral = false, floating = false, find = false, extreme = false;
+    } ;
+
+#ifdef FSU_GSIMD_X86
+
+    //--------------------------------
+    //   lane traits: SSE2, 128 bits
+    //--------------------------------
+
+    // Eq() returns one mask bit per lane; Clean() starts a NaN accumulator
+    // and Unord() adds the lanes of x that are NaN to it
+
+    struct SseI32
+    {
+      typedef int32_t E;
+      typedef __m128i V;
+      enum { lanes = 4 };
+      static V    Load  (const void* p) { return _mm_loadu_si128((const __m128i*)p); }
+      static V    Splat (E e)           { return _mm_set1_epi32(e); }
+      static int  Eq    (V a, V b)      { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+      static V    Min   (V a, V b)      { V m = _mm_cmpgt_epi32(a, b); return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a)); }
+      static V    Max   (V a, V b)      { V m = _mm_cmpgt_epi32(a, b); return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+      static V    Clean ()              { return _mm_setzero_si128(); }
+      static V    Unord (V acc, V)      { return acc; }
+      static bool Any   (V)             { return false; }
+      static void Store (E* p, V v)     { _mm_storeu_si128((__m128i*)p, v); }
+    } ;
+
+    struct SseU32 : SseI32   // compares with the sign bit flipped
+    {
+      typedef uint32_t E;
+      static V    Splat (E e)      { return _mm_set1_epi32((int32_t)e); }
+      static V    Bias  (V a)      { return _mm_xor_si128(a, _mm_set1_epi32(INT32_MIN)); }
+      static V    Min   (V a, V b) { V m = _mm_cmpgt_epi32(Bias(a), Bias(b)); return _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a)); }
+      static V    Max   (V a, V b) { V m = _mm_cmpgt_epi32(Bias(a), Bias(b)); return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+      static void Store (E* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+    } ;
+
+    struct SseI64   // find only
+    {
+      typedef int64_t E;
+      typedef __m128i V;
+      enum { lanes = 2 };
+      static V   Load  (const void* p) { return _mm_loadu_si128((const __m128i*)p); }
+      static V   Splat (E e)           { return _mm_set1_epi64x(e); }
+      static int Eq    (V a, V b)
+      {
+        V c = _mm_cmpeq_epi32(a, b);   // both halves of a lane must match
+        c = _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2,3,0,1)));
+        return _mm_movemask_pd(_mm_castsi128_pd(c));
+      }
+    } ;
+
+    struct SseF32
+    {
+      typedef float E;
+      typedef __m128 V;
+      enum { lanes = 4 };
+      static V    Load  (const void* p) { return _mm_loadu_ps((const float*)p); }
+      static V    Splat (E e)           { return _mm_set1_ps(e); }
+      static int  Eq    (V a, V b)      { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+      static V    Min   (V a, V b)      { return _mm_min_ps(a, b); }
+      static V    Max   (V a, V b)      { return _mm_max_ps(a, b); }
+      static V    Clean ()              { return _mm_setzero_ps(); }
+      static V    Unord (V acc, V x)    { return _mm_or_ps(acc, _mm_cmpunord_ps(x, x)); }
+      static bool Any   (V v)           { return _mm_movemask_ps(v) != 0; }
+      static void Store (E* p, V v)     { _mm_storeu_ps(p, v); }
+    } ;
+
+    struct SseF64
+    {
+      typedef double E;
+      typedef __m128d V;
+      enum { lanes = 2 };
+      static V    Load  (const void* p) { return _mm_loadu_pd((const double*)p); }
+      static V    Splat (E e)           { return _mm_set1_pd(e); }
+      static int  Eq    (V a, V b)      { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+      static V    Min   (V a, V b)      { return _mm_min_pd(a, b); }
+      static V    Max   (V a, V b)      { return _mm_max_pd(a, b); }
+      static V    Clean ()              { return _mm_setzero_pd(); }
+      static V    Unord (V acc, V x)    { return _mm_or_pd(acc, _mm_cmpunord_pd(x, x)); }
+      static bool Any   (V v)           { return _mm_movemask_pd(v) != 0; }
+      static void Store (E* p, V v)     { _mm_storeu_pd(p, v); }
+    } ;
+
+    //--------------------------------
+    //   lane traits: AVX2, 256 bits
+    //--------------------------------
+
+    struct AvxI32
+    {
+      typedef int32_t E;
+      typedef __m256i V;
+      enum { lanes = 8 };
+      FSU_GSIMD_AVX2 static V    Load  (const void* p) { return _mm256_loadu_si256((const __m256i*)p); }
+      FSU_GSIMD_AVX2 static V    Splat (E e)           { return _mm256_set1_epi32(e); }
+      FSU_GSIMD_AVX2 static int  Eq    (V a, V b)      { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+      FSU_GSIMD_AVX2 static V    Min   (V a, V b)      { return _mm256_min_epi32(a, b); }
+      FSU_GSIMD_AVX2 static V    Max   (V a, V b)      { return _mm256_max_epi32(a, b); }
+      FSU_GSIMD_AVX2 static V    Clean ()              { return _mm256_setzero_si256(); }
+      FSU_GSIMD_AVX2 static V    Unord (V acc, V)      { return acc; }
+      FSU_GSIMD_AVX2 static bool Any   (V)             { return false; }
+      FSU_GSIMD_AVX2 static void Store (E* p, V v)     { _mm256_storeu_si256((__m256i*)p, v); }
+    } ;
+
+    struct AvxU32 : AvxI32
+    {
+      typedef uint32_t E;
+      FSU_GSIMD_AVX2 static V    Splat (E e)       { return _mm256_set1_epi32((int32_t)e); }
+      FSU_GSIMD_AVX2 static V    Min   (V a, V b)  { return _mm256_min_epu32(a, b); }
+      FSU_GSIMD_AVX2 static V    Max   (V a, V b)  { return _mm256_max_epu32(a, b); }
+      FSU_GSIMD_AVX2 static void Store (E* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+    } ;
+
+    struct AvxI64
+    {
+      typedef int64_t E;
+      typedef __m256i V;
+      enum { lanes = 4 };
+      FSU_GSIMD_AVX2 static V   Load  (const void* p) { return _mm256_loadu_si256((const __m256i*)p); }
+      FSU_GSIMD_AVX2 static V   Splat (E e)           { return _mm256_set1_epi64x(e); }
+      FSU_GSIMD_AVX2 static int Eq    (V a, V b)      { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))); }
+    } ;
+
+    struct AvxF32
+    {
+      typedef float E;
+      typedef __m256 V;
+      enum { lanes = 8 };
+      FSU_GSIMD_AVX2 static V    Load  (const void* p) { return _mm256_loadu_ps((const float*)p); }
+      FSU_GSIMD_AVX2 static V    Splat (E e)           { return _mm256_set1_ps(e); }
+      FSU_GSIMD_AVX2 static int  Eq    (V a, V b)      { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+      FSU_GSIMD_AVX2 static V    Min   (V a, V b)      { return _mm256_min_ps(a, b); }
+      FSU_GSIMD_AVX2 static V    Max   (V a, V b)      { return _mm256_max_ps(a, b); }
+      FSU_GSIMD_AVX2 static V    Clean ()              { return _mm256_setzero_ps(); }
+      FSU_GSIMD_AVX2 static V    Unord (V acc, V x)    { return _mm256_or_ps(acc, _mm256_cmp_ps(x, x, _CMP_UNORD_Q)); }
+      FSU_GSIMD_AVX2 static bool Any   (V v)           { return _mm256_movemask_ps(v) != 0; }
+      FSU_GSIMD_AVX2 static void Store (E* p, V v)     { _mm256_storeu_ps(p, v); }
+    } ;
+
+    struct AvxF64
+    {
+      typedef double E;
+      typedef __m256d V;
+      enum { lanes = 4 };
+      FSU_GSIMD_AVX2 static V    Load  (const void* p) { return _mm256_loadu_pd((const double*)p); }
+      FSU_GSIMD_AVX2 static V    Splat (E e)           { return _mm256_set1_pd(e); }
+      FSU_GSIMD_AVX2 static int  Eq    (V a, V b)      { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+      FSU_GSIMD_AVX2 static V    Min   (V a, V b)      { return _mm256_min_pd(a, b); }
+      FSU_GSIMD_AVX2 static V    Max   (V a, V b)      { return _mm256_max_pd(a, b); }
+      FSU_GSIMD_AVX2 static V    Clean ()              { return _mm256_setzero_pd(); }
+      FSU_GSIMD_AVX2 static V    Unord (V acc, V x)    { return _mm256_or_pd(acc, _mm256_cmp_pd(x, x, _CMP_UNORD_Q)); }
+      FSU_GSIMD_AVX2 static bool Any   (V v)           { return _mm256_movemask_pd(v) != 0; }
+      FSU_GSIMD_AVX2 static void Store (E* p, V v)     { _mm256_storeu_pd(p, v); }
+    } ;
+
+    // lane traits for element type U at each width
+    template <typename U, bool F = std::is_floating_point<U>::value, size_t B = sizeof(U)> struct Lanes;
+    template <typename U> struct Lanes <U, true,  4> { typedef SseF32 Sse; typedef AvxF32 Avx; } ;
+    template <typename U> struct Lanes <U, true,  8> { typedef SseF64 Sse; typedef AvxF64 Avx; } ;
+    template <typename U> struct Lanes <U, false, 8> { typedef SseI64 Sse; typedef AvxI64 Avx; } ;
+    template <typename U> struct Lanes <U, false, 4>
+    {
+      typedef typename std::conditional<std::is_signed<U>::value, SseI32, SseU32>::type Sse;
+      typedef typename std::conditional<std::is_signed<U>::value, AvxI32, AvxU32>::type Avx;
+    } ;
+
+    //----------------------------------
+    //   kernels; both require n >= lanes
+    //----------------------------------
+
+    // The last vector is loaded at p + n - lanes, overlapping the one
+    // before it, so no element is read through a scalar pointer. The
+    // overlap is harmless: for find, the lanes it repeats held no match;
+    // for min/max, a repeated lane cannot change the result.
+
+    template <class S>
+    size_t FindSse (const void* v, size_t n, typename S::E t)
+    {
+      const char* p = (const char*)v;
+      const size_t w = S::lanes, sz = sizeof(typename S::E);
+      typename S::V key = S::Splat(t);
+      size_t i = 0;
+      for (; i + 4 * w <= n; i += 4 * w)
+      {
+        unsigned m = (unsigned)S::Eq(S::Load(p + i * sz), key)
+                   | (unsigned)S::Eq(S::Load(p + (i + w) * sz), key) << w
+                   | (unsigned)S::Eq(S::Load(p + (i + 2 * w) * sz), key) << (2 * w)
+                   | (unsigned)S::Eq(S::Load(p + (i + 3 * w) * sz), key) << (3 * w);
+        if (m) return i + (size_t)__builtin_ctz(m);
+      }
+      for (; i < n; i += w)
+      {
+        if (i + w > n) i = n - w;
+        unsigned m = (unsigned)S::Eq(S::Load(p + i * sz), key);
+        if (m) return i + (size_t)__builtin_ctz(m);
+      }
+      return n;
+    }
+
+    // the extreme value of [p, p+n) into out; false if a NaN was seen
+    template <class S, bool Max>
+    bool ExtremeSse (const void* v, size_t n, typename S::E& out)
+    {
+      typedef typename S::V V;
+      const char* p = (const char*)v;
+      const size_t w = S::lanes, sz = sizeof(typename S::E);
+      V a0 = S::Load(p), a1 = a0, a2 = a0, a3 = a0;
+      V bad = S::Unord(S::Clean(), a0);
+      size_t i = w;
+      for (; i + 4 * w <= n; i += 4 * w)
+      {
+        V x0 = S::Load(p + i * sz), x1 = S::Load(p + (i + w) * sz);
+        V x2 = S::Load(p + (i + 2 * w) * sz), x3 = S::Load(p + (i + 3 * w) * sz);
+        a0 = Max ? S::Max(a0, x0) : S::Min(a0, x0);
+        a1 = Max ? S::Max(a1, x1) : S::Min(a1, x1);
+        a2 = Max ? S::Max(a2, x2) : S::Min(a2, x2);
+        a3 = Max ? S::Max(a3, x3) : S::Min(a3, x3);
+        bad = S::Unord(S::Unord(bad, x0), x1);
+        bad = S::Unord(S::Unord(bad, x2), x3);
+      }
+      for (; i < n; i += w)
+      {
+        if (i + w > n) i = n - w;
+        V x = S::Load(p + i * sz);
+        a0 = Max ? S::Max(a0, x) : S::Min(a0, x);
+        bad = S::Unord(bad, x);
+      }
+      if (S::Any(bad)) return false;
+      a0 = Max ? S::Max(S::Max(a0, a1), S::Max(a2, a3)) : S::Min(S::Min(a0, a1), S::Min(a2, a3));
+      typename S::E lane[S::lanes];
+      S::Store(lane, a0);
+      out = lane[0];
+      for (size_t k = 1; k < w; ++k)
+        if (Max ? out < lane[k] : lane[k] < out)
+          out = lane[k];
+      return true;
+    }
+
+    template <class S>
+    FSU_GSIMD_AVX2 size_t FindAvx (const void* v, size_t n, typename S::E t)
+    {
+      const char* p = (const char*)v;
+      const size_t w = S::lanes, sz = sizeof(typename S::E);
+      typename S::V key = S::Splat(t);
+      size_t i = 0;
+      for (; i + 4 * w <= n; i += 4 * w)
+      {
+        unsigned m = (unsigned)S::Eq(S::Load(p + i * sz), key)
+                   | (unsigned)S::Eq(S::Load(p + (i + w) * sz), key) << w
+                   | (unsigned)S::Eq(S::Load(p + (i + 2 * w) * sz), key) << (2 * w)
+                   | (unsigned)S::Eq(S::Load(p + (i + 3 * w) * sz), key) << (3 * w);
+        if (m) return i + (size_t)__builtin_ctz(m);
+      }
+      for (; i < n; i += w)
+      {
+        if (i + w > n) i = n - w;
+        unsigned m = (unsigned)S::Eq(S::Load(p + i * sz), key);
+        if (m) return i + (size_t)__builtin_ctz(m);
+      }
+      return n;
+    }
+
+    template <class S, bool Max>
+    FSU_GSIMD_AVX2 bool ExtremeAvx (const void* v, size_t n, typename S::E& out)
+    {
+      typedef typename S::V V;
+      const char* p = (const char*)v;
+      const size_t w = S::lanes, sz = sizeof(typename S::E);
+      V a0 = S::Load(p), a1 = a0, a2 = a0, a3 = a0;
+      V bad = S::Unord(S::Clean(), a0);
+      size_t i = w;
+      for (; i + 4 * w <= n; i += 4 * w)
+      {
+        V x0 = S::Load(p + i * sz), x1 = S::Load(p + (i + w) * sz);
+        V x2 = S::Load(p + (i + 2 * w) * sz), x3 = S::Load(p + (i + 3 * w) * sz);
+        a0 = Max ? S::Max(a0, x0) : S::Min(a0, x0);
+        a1 = Max ? S::Max(a1, x1) : S::Min(a1, x1);
+        a2 = Max ? S::Max(a2, x2) : S::Min(a2, x2);
+        a3 = Max ? S::Max(a3, x3) : S::Min(a3, x3);
+        bad = S::Unord(S::Unord(bad, x0), x1);
+        bad = S::Unord(S::Unord(bad, x2), x3);
+      }
+      for (; i < n; i += w)
+      {
+        if (i + w > n) i = n - w;
+        V x = S::Load(p + i * sz);
+        a0 = Max ? S::Max(a0, x) : S::Min(a0, x);
+        bad = S::Unord(bad, x);
+      }
+      if (S::Any(bad)) return false;
+      a0 = Max ? S::Max(S::Max(a0, a1), S::Max(a2, a3)) : S::Min(S::Min(a0, a1), S::Min(a2, a3));
+      typename S::E lane[S::lanes];
+      S::Store(lane, a0);
+      out = lane[0];
+      for (size_t k = 1; k < w; ++k)
+        if (Max ? out < lane[k] : lane[k] < out)
+          out = lane[k];
+      return true;
+    }
+
+#endif // FSU_GSIMD_X86
+
+    //----------------------------------
+    //   entry points, called by genalg.h
+    //----------------------------------
+
+    template <typename U>
+    size_t Find (const U* p, size_t n, const U& t, std::true_type)   // bytes
+    {
+      const void* f = memchr(p, *(const unsigned char*)&t, n);
+      return f ? (size_t)((const U*)f - p) : n;
+    }
+
+    template <typename U>
+    size_t Find (const U* p, size_t n, const U& t, std::false_type)
+    {
+#ifdef FSU_GSIMD_X86
+      if (n >= 16)
+      {
+        typedef typename Lanes<U>::Sse S;
+        typedef typename Lanes<U>::Avx A;
+        int level = Level();
+        if (level == avx2) return FindAvx<A>(p, n, (typename A::E)t);
+        if (level == sse2) return FindSse<S>(p, n, (typename S::E)t);
+      }
+#endif
+      for (size_t i = 0; i < n; ++i)
+        if (t == p[i])
+          return i;
+      return n;
+    }
+
+    // index of the first t in [p, p+n), n if there is none; Kind<U>::find
+    template <typename U>
+    size_t Find (const U* p, size_t n, const U& t)
+    {
+      static_assert(Kind<U>::find, "gsimd::Find: unsupported element type");
+      return Find(p, n, t, std::integral_constant<bool, sizeof(U) == 1>());
+    }
+
+    // index of the first extreme element of [p, p+n), n > 0; Kind<U>::extreme
+    template <bool Max, typename U>
+    size_t Extreme (const U* p, size_t n)
+    {
+      static_assert(Kind<U>::extreme, "gsimd::Extreme: unsupported element type");
+#ifdef FSU_GSIMD_X86
+      if (n >= 64)
+      {
+        typedef typename Lanes<U>::Sse S;
+        typedef typename Lanes<U>::Avx A;
+        int level = Level();
+        typename S::E v;
+        if (level == avx2 && ExtremeAvx<A,Max>(p, n, v)) return Find(p, n, (U)v);
+        if (level == sse2 && ExtremeSse<S,Max>(p, n, v)) return Find(p, n, (U)v);
+      }
+#endif
+      size_t b = 0;
+      for (size_t i = 1; i < n; ++i)
+        if (Max ? p[b] < p[i] : p[i] < p[b])
+          b = i;
+      return b;
+    }
+
+  } // namespace gsimd
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,344 @@
+/*
+    gsort.h
+    10/18/26
+
+    Generic sort algorithms
+
+    I     random access iterator class: raw pointers (Vector<T>::Iterator),
+          Deque<T>::Iterator; only ++, --, +n, -n, difference, * are used
+    T     ValueType
+    P     order predicate class, e.g. LessThan<T>, GreaterThan<T>
+
+    g_sort        (beg, end [, p])  // introsort: O(n log n) worst case, not stable
+    g_stable_sort (beg, end [, p])  // merge sort, n/2 element buffer
+    g_nth_element (beg, nth, end [, p]) // introselect: *nth as if sorted,
+                                        // nothing after it precedes it
+    g_radix_sort  (beg, end)        // value type unsigned integral: LSD, 8 bits/pass
+                                    // value type fsu::String: MSD by character
+
+    g_sort partitions around a median of three (Hoare scheme) until a
+    range is 16 elements or fewer, then finishes with one insertion sort
+    pass. When recursion passes 2 log2(n) levels it switches to heap sort,
+    which bounds the worst case. The forms without a predicate use
+    LessThan<T>.
+
+    g_radix_sort orders Strings exactly as String's operator < does (signed
+    char comparison, embedded '\0' ends the string). It sorts pointers and
+    then writes each String once, so it pays 2n String copies rather than
+    O(n log n) swaps. Buckets under 32 entries fall back to insertion sort.
+
+    See also gbsearch.h (binary search on a sorted range).
+*/
+
+#ifndef _GSORT_H
+#define _GSORT_H
+
+#include <cstddef>    // size_t
+#include <climits>    // CHAR_MIN
+#include <utility>    // std::swap, std::move
+#include <type_traits>
+#include <compare.h>  // LessThan
+#include <vector.h>   // buffers
+
+namespace fsu
+{
+
+  class String;
+
+  namespace gsort
+  {
+    // value type of an iterator: T for T*, I::ValueType for fsu iterators
+    template <class I> struct ValueOf          { typedef typename I::ValueType type; } ;
+    template <class T> struct ValueOf <T*>       { typedef T type; } ;
+    template <class T> struct ValueOf <const T*> { typedef T type; } ;
+
+    enum { insertionCutoff = 16, stableCutoff = 32, radixCutoff = 32 };
+
+    template <class I>
+    inline void IterSwap (I a, I b)
+    {
+      using std::swap;
+      swap(*a, *b);
+    }
+
+    // stable, in place; the workhorse below every cutoff
+    template <class I, class P>
+    void InsertionSort (I beg, I end, const P& p)
+    {
+      typedef typename ValueOf<I>::type T;
+      if (beg == end) return;
+      I i = beg;
+      for (++i; i != end; ++i)
+      {
+        T t = std::move(*i);
+        I j = i;
+        for (I k = j; j != beg && p(t, *--k); --j) // k never steps before beg
+          *j = std::move(*k);
+        *j = std::move(t);
+      }
+    }
+
+    template <class I, class P>
+    void SiftDown (I beg, long root, long n, const P& p)
+    {
+      typedef typename ValueOf<I>::type T;
+      T t = std::move(*(beg + root));
+      long child;
+      while ((child = 2 * root + 1) < n)
+      {
+        if (child + 1 < n && p(*(beg + child), *(beg + (child + 1))))
+          ++child;
+        if (!p(t, *(beg + child)))
+          break;
+        *(beg + root) = std::move(*(beg + child));
+        root = child;
+      }
+      *(beg + root) = std::move(t);
+    }
+
+    template <class I, class P>
+    void HeapSort (I beg, I end, const P& p)
+    {
+      long n = end - beg;
+      for (long i = n / 2 - 1; i >= 0; --i)
+        SiftDown(beg, i, n, p);
+      for (long last = n - 1; last > 0; --last)
+      {
+        IterSwap(beg, beg + last);
+        SiftDown(beg, 0, last, p);
+      }
+    }
+
+    // puts the median of *a, *b, *c at *result
+    template <class I, class P>
+    void MedianToFirst (I result, I a, I b, I c, const P& p)
+    {
+      if (p(*a, *b))
+      {
+        if      (p(*b, *c)) IterSwap(result, b);
+        else if (p(*a, *c)) IterSwap(result, c);
+        else                IterSwap(result, a);
+      }
+      else if (p(*a, *c))   IterSwap(result, a);
+      else if (p(*b, *c))   IterSwap(result, c);
+      else                  IterSwap(result, b);
+    }
+
+    // Hoare partition around the median of three; returns cut with
+    // [beg,cut) not after the pivot and [cut,end) not before it
+    template <class I, class P>
+    I Partition (I beg, I end, const P& p)
+    {
+      I mid = beg + (end - beg) / 2;
+      MedianToFirst(beg, beg + 1, mid, end - 1, p);
+      I lo = beg + 1, hi = end;
+      for (;;)
+      {
+        while (p(*lo, *beg)) ++lo;
+        --hi;
+        while (p(*beg, *hi)) --hi;
+        if (hi - lo <= 0)
+          return lo;
+        IterSwap(lo, hi);
+        ++lo;
+      }
+    }
+
+    template <class I, class P>
+    void IntroLoop (I beg, I end, const P& p, int depth)
+    {
+      while (end - beg > (long)insertionCutoff)
+      {
+        if (depth-- == 0)
+        {
+          HeapSort(beg, end, p);
+          return;
+        }
+        I cut = Partition(beg, end, p);
+        IntroLoop(cut, end, p, depth);
+        end = cut;
+      }
+    }
+
+    inline int DepthLimit (long n)
+    {
+      int lg = 0;
+      while (n > 1) { n >>= 1; ++lg; }
+      return 2 * lg;
+    }
+
+    template <class I, class P, typename T>
+    void MergeSort (I beg, I end, T* buf, const P& p)
+    {
+      long n = end - beg;
+      if (n <= (long)stableCutoff)
+      {
+        InsertionSort(beg, end, p);
+        return;
+      }
+      I mid = beg + n / 2;
+      MergeSort(beg, mid, buf, p);
+      MergeSort(mid, end, buf, p);
+      if (!p(*mid, *(mid - 1)))
+        return;                        // halves already in order
+      T* b = buf;
+      for (I i = beg; i != mid; ++i) *b++ = std::move(*i);
+      T* be = b;
+      b = buf;
+      I r = mid, out = beg;
+      while (b != be && r != end)      // right side wins only when strictly first: stable
+      {
+        if (p(*r, *b)) { *out = std::move(*r); ++r; }
+        else           { *out = std::move(*b); ++b; }
+        ++out;
+      }
+      while (b != be) { *out = std::move(*b); ++b; ++out; }
+    }
+
+    // LSD radix, 8 bits per pass, passes with a single occupied bucket skipped
+    template <class I, typename U>
+    void Radix (I beg, I end, U*)
+    {
+      static_assert(std::is_integral<U>::value && std::is_unsigned<U>::value,
+                    "g_radix_sort: value type must be unsigned integral or fsu::String");
+      size_t n = (size_t)(end - beg);
+      if (n < 2) return;
+      Vector<U> a(n), b(n);
+      U* src = a.Begin();
+      U* dst = b.Begin();
+      size_t i = 0;
+      for (I it = beg; it != end; ++it) src[i++] = *it;
+      for (size_t shift = 0; shift < 8 * sizeof(U); shift += 8)
+      {
+        size_t count[257] = { 0 };
+        for (i = 0; i < n; ++i) ++count[((src[i] >> shift) & 0xFF) + 1];
+        if (count[((src[0] >> shift) & 0xFF) + 1] == n)
+          continue;                    // every key has the same digit here
+        for (i = 1; i < 257; ++i) count[i] += count[i - 1];
+        for (i = 0; i < n; ++i) dst[count[(src[i] >> shift) & 0xFF]++] = src[i];
+        U* t = src; src = dst; dst = t;
+      }
+      i = 0;
+      for (I it = beg; it != end; ++it) *it = src[i++];
+    }
+
+    // character d of s as a bucket 0..255 in operator < order; past the end reads as '\0'
+    template <class S>
+    inline size_t CharKey (const S& s, size_t d)
+    {
+      return (size_t)((int)(char)s.Element(d) - CHAR_MIN);
+    }
+
+    template <class S>
+    struct DerefLess
+    {
+      bool operator () (const S* a, const S* b) const { return *a < *b; }
+    } ;
+
+    template <class S>
+    void Msd (const S** ptr, const S** aux, size_t n, size_t d)
+    {
+      if (n < (size_t)radixCutoff)
+      {
+        InsertionSort(ptr, ptr + n, DerefLess<S>());
+        return;
+      }
+      size_t count[257] = { 0 };
+      for (size_t i = 0; i < n; ++i) ++count[CharKey(*ptr[i], d) + 1];
+      for (size_t k = 1; k < 257; ++k) count[k] += count[k - 1];
+      size_t start[256];
+      for (size_t k = 0; k < 256; ++k) start[k] = count[k];
+      for (size_t i = 0; i < n; ++i) aux[count[CharKey(*ptr[i], d)]++] = ptr[i];
+      for (size_t i = 0; i < n; ++i) ptr[i] = aux[i];
+      const size_t end = (size_t)(0 - CHAR_MIN);   // bucket of strings that ended: all equal
+      for (size_t k = 0; k < 256; ++k)
+      {
+        size_t m = count[k] - start[k];
+        if (k != end && m > 1)
+          Msd(ptr + start[k], aux, m, d + 1);
+      }
+    }
+
+    template <class I>
+    void Radix (I beg, I end, String*)
+    {
+      typedef typename ValueOf<I>::type S;   // String, kept dependent on I
+      size_t n = (size_t)(end - beg);
+      if (n < 2) return;
+      Vector<const S*> ptr(n), aux(n);
+      size_t i = 0;
+      for (I it = beg; it != end; ++it) ptr[i++] = &*it;
+      Msd(ptr.Begin(), aux.Begin(), n, 0);
+      Vector<S> sorted(n);
+      for (i = 0; i < n; ++i) sorted[i] = *ptr[i];
+      i = 0;
+      for (I it = beg; it != end; ++it) *it = sorted[i++];
+    }
+  } // namespace gsort
+
+  template <class I, class P>
+  void g_sort (I beg, I end, const P& p)
+  {
+    if (end - beg < 2) return;
+    gsort::IntroLoop(beg, end, p, gsort::DepthLimit(end - beg));
+    gsort::InsertionSort(beg, end, p);
+  }
+
+  template <class I>
+  void g_sort (I beg, I end)
+  {
+    g_sort(beg, end, LessThan<typename gsort::ValueOf<I>::type>());
+  }
+
+  template <class I, class P>
+  void g_stable_sort (I beg, I end, const P& p)
+  {
+    typedef typename gsort::ValueOf<I>::type T;
+    long n = end - beg;
+    if (n < 2) return;
+    Vector<T> buf((size_t)(n / 2 + 1));
+    gsort::MergeSort(beg, end, buf.Begin(), p);
+  }
+
+  template <class I>
+  void g_stable_sort (I beg, I end)
+  {
+    g_stable_sort(beg, end, LessThan<typename gsort::ValueOf<I>::type>());
+  }
+
+  template <class I, class P>
+  void g_nth_element (I beg, I nth, I end, const P& p)
+  {
+    if (nth == end) return;
+    int depth = gsort::DepthLimit(end - beg);
+    while (end - beg > 3)
+    {
+      if (depth-- == 0)
+      {
+        gsort::HeapSort(beg, end, p);
+        return;
+      }
+      I cut = gsort::Partition(beg, end, p);
+      if (nth - cut >= 0)
+        beg = cut;
+      else
+        end = cut;
+    }
+    gsort::InsertionSort(beg, end, p);
+  }
+
+  template <class I>
+  void g_nth_element (I beg, I nth, I end)
+  {
+    g_nth_element(beg, nth, end, LessThan<typename gsort::ValueOf<I>::type>());
+  }
+
+  template <class I>
+  void g_radix_sort (I beg, I end)
+  {
+    gsort::Radix(beg, end, (typename gsort::ValueOf<I>::type*)nullptr);
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,91 @@
+/*
+    hashval.h
+    10/18/26
+
+    64-bit hash values for keys and data
+
+    HashValue(t) is an overloaded free function found by argument-dependent
+    lookup, like HeapUsage() in memtrack.h. This file defines it for the
+    arithmetic types. xstring.h defines it for String, and a user type
+    supplies its own in its own namespace.
+
+      HashMix   (x)         splitmix64 finalizer: every input bit affects
+                            every output bit
+      HashValue (t)         integral and enum types: HashMix of the value
+                            float, double: HashMix of the bits, with -0.0
+                            hashed as 0.0 so that equal values hash equally
+      HashBytes (p, n)      FNV-1a over n bytes, then HashMix
+      HasHashValue<T>       ::value is true when HashValue(const T&) is
+                            declared for T
+
+    The values are deterministic across runs and machines of the same
+    endianness, so a digest can be stored and compared later.
+*/
+
+#ifndef _HASHVAL_H
+#define _HASHVAL_H
+
+#include <cstddef>     // size_t
+#include <cstdint>
+#include <cstring>     // memcpy
+#include <type_traits>
+#include <utility>     // declval
+
+namespace fsu
+{
+
+  inline uint64_t HashMix (uint64_t x)
+  {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  inline uint64_t HashBytes (const void* p, size_t n)
+  {
+    const unsigned char* b = (const unsigned char*)p;
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < n; ++i)
+    {
+      h ^= b[i];
+      h *= 0x100000001B3ULL;
+    }
+    return HashMix(h);
+  }
+
+  template < typename T >
+  typename std::enable_if < std::is_integral<T>::value || std::is_enum<T>::value , uint64_t >::type
+  HashValue (const T& t)
+  {
+    return HashMix((uint64_t)t);
+  }
+
+  inline uint64_t HashValue (double d)
+  {
+    if (d == 0) d = 0;   // -0.0 == 0.0
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    return HashMix(u);
+  }
+
+  inline uint64_t HashValue (float f)
+  {
+    return HashValue((double)f);
+  }
+
+  // lets a class use HashValue only for the types that have one
+  template < typename T >
+  class HasHashValue
+  {
+    template < typename U >
+    static char Test (decltype(HashValue(std::declval<const U&>()))*);
+    template < typename U >
+    static long Test (...);
+  public:
+    static const bool value = sizeof(Test<T>(nullptr)) == 1;
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,217 @@
+/*
+    histogram.h
+    10/18/26
+
+    High dynamic range latency histogram and a matching stopwatch
+
+    classes defined in this file
+    ----------------------------
+
+    class LatencyTimer      // ns stopwatch: steady_clock, or rdtsc with -DFSU_LATENCY_RDTSC
+    class LatencyHistogram  // log-linear buckets, mergeable, p50/p99/p999/max
+
+    Bucket layout follows the HDR histogram idea: values below 2^subBits are
+    counted exactly, and every higher power of two is divided into 2^subBits
+    equal sub-buckets. With subBits = 5 the relative error of any reported
+    percentile is under 1/32 (about 3%) across the whole 64-bit range, and
+    the table is a fixed 15 KB with no allocation on Record().
+
+    Histograms are not synchronized. For multi-threaded use give each thread
+    its own histogram and Merge() them when the threads are done.
+
+    Usage:
+
+      LatencyHistogram h;
+      LatencyTimer t;
+      for (...)
+      {
+        t.Start();
+        map.Put(k,d);
+        h.Record(t.ElapsedNs());
+      }
+      LatencyHistogram::ReportHeader(std::cout);
+      h.Report(std::cout, "Put");
+*/
+
+#ifndef _HISTOGRAM_H
+#define _HISTOGRAM_H
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#if defined(FSU_LATENCY_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+namespace fsu
+{
+
+  //---------------------------
+  //    class LatencyTimer
+  //---------------------------
+
+  class LatencyTimer
+  {
+  public:
+    LatencyTimer () { Start(); }
+    void     Start     () { start_ = Ticks(); }
+    uint64_t ElapsedNs () const { return ToNs(Ticks() - start_); }
+
+#if defined(FSU_LATENCY_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+    // time stamp counter; assumes an invariant TSC (any x86 of the last decade)
+    static uint64_t Ticks () { return __rdtsc(); }
+    static uint64_t ToNs  (uint64_t ticks) { return (uint64_t)(ticks * NsPerTick()); }
+    static double   NsPerTick ()
+    {
+      static const double nsPerTick = Calibrate();
+      return nsPerTick;
+    }
+  private:
+    static double Calibrate ()
+    {
+      typedef std::chrono::steady_clock Clock;
+      Clock::time_point t0 = Clock::now();
+      uint64_t c0 = __rdtsc();
+      while (Clock::now() - t0 < std::chrono::milliseconds(10)) {}
+      uint64_t c1 = __rdtsc();
+      double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+      return ns / double(c1 - c0);
+    }
+  public:
+#else
+    static uint64_t Ticks ()
+    {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static uint64_t ToNs  (uint64_t ticks) { return ticks; }
+#endif
+
+  private:
+    uint64_t start_;
+  } ;
+
+  //-------------------------------
+  //    class LatencyHistogram
+  //-------------------------------
+
+  class LatencyHistogram
+  {
+  public:
+    LatencyHistogram () { Reset(); }
+
+    void Reset ()
+    {
+      for (size_t i = 0; i < numBuckets; ++i) counts_[i] = 0;
+      count_ = total_ = max_ = 0;
+      min_ = UINT64_MAX;
+    }
+
+    void Record (uint64_t v)
+    {
+      ++counts_[Index(v)];
+      ++count_;
+      total_ += v;
+      if (v > max_) max_ = v;
+      if (v < min_) min_ = v;
+    }
+
+    void Merge (const LatencyHistogram& h)
+    {
+      for (size_t i = 0; i < numBuckets; ++i) counts_[i] += h.counts_[i];
+      count_ += h.count_;
+      total_ += h.total_;
+      if (h.max_ > max_) max_ = h.max_;
+      if (h.min_ < min_) min_ = h.min_;
+    }
+
+    uint64_t Count () const { return count_; }
+    uint64_t Max   () const { return max_; }
+    uint64_t Min   () const { return count_ ? min_ : 0; }
+    double   Mean  () const { return count_ ? double(total_) / count_ : 0.0; }
+
+    // smallest recorded value v such that at least p percent of samples are <= v
+    // (reported as the upper edge of v's bucket, clamped to the true max)
+    uint64_t Percentile (double p) const
+    {
+      if (count_ == 0) return 0;
+      uint64_t rank = (uint64_t)(p / 100.0 * count_ + 0.5);
+      if (rank < 1) rank = 1;
+      if (rank > count_) rank = count_;
+      uint64_t seen = 0;
+      for (size_t i = 0; i < numBuckets; ++i)
+      {
+        seen += counts_[i];
+        if (seen >= rank)
+        {
+          uint64_t v = UpperEdge(i);
+          return v < max_ ? v : max_;
+        }
+      }
+      return max_;
+    }
+
+    static void ReportHeader (std::ostream& os)
+    {
+      os << std::setw(16) << std::left << "  operation" << std::right
+         << std::setw(12) << "count"
+         << std::setw(10) << "mean"
+         << std::setw(10) << "p50"
+         << std::setw(10) << "p99"
+         << std::setw(10) << "p999"
+         << std::setw(12) << "max (ns)" << '\n';
+    }
+
+    void Report (std::ostream& os, const char* label) const
+    {
+      os << "  " << std::setw(14) << std::left << label << std::right
+         << std::setw(12) << count_
+         << std::setw(10) << (uint64_t)Mean()
+         << std::setw(10) << Percentile(50.0)
+         << std::setw(10) << Percentile(99.0)
+         << std::setw(10) << Percentile(99.9)
+         << std::setw(12) << max_ << '\n';
+    }
+
+  private:
+    enum { subBits = 5, subCount = 1 << subBits, numBuckets = (64 - subBits + 1) * subCount };
+
+    static size_t Index (uint64_t v)
+    {
+      if (v < (uint64_t)subCount)
+        return (size_t)v;
+      unsigned msb = 63 - Clz(v);
+      unsigned shift = msb - subBits;
+      return (size_t)(msb - subBits + 1) * subCount + (size_t)((v >> shift) - subCount);
+    }
+
+    static uint64_t UpperEdge (size_t i)
+    {
+      if (i < (size_t)subCount)
+        return i;
+      size_t   band  = i / subCount;        // >= 1
+      uint64_t sub   = i % subCount;
+      unsigned shift = (unsigned)band - 1;
+      return ((subCount + sub + 1) << shift) - 1;
+    }
+
+    static unsigned Clz (uint64_t v)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return (unsigned)__builtin_clzll(v);
+#else
+      unsigned n = 0;
+      for (uint64_t bit = (uint64_t)1 << 63; (v & bit) == 0; bit >>= 1) ++n;
+      return n;
+#endif
+    }
+
+    uint64_t counts_[numBuckets];
+    uint64_t count_, total_, max_, min_;
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -356,6 +356,16 @@ size_t List<T>::Size()  const
   return size;
 }
 
+template < typename T >
+size_t List<T>::MemoryUsage()  const
+{
+  size_t bytes = sizeof(*this) + 2 * sizeof(Link);  // head_ and tail_
+  bytes += HeapUsage(head_->Tval_) + HeapUsage(tail_->Tval_);
+  for (Link * curr = head_->next_; curr != tail_; curr = curr -> next_)
+    bytes += sizeof(Link) + HeapUsage(curr->Tval_);
+  return bytes;
+}
+
 template < typename T >
 bool List<T>::Empty()  const
 {
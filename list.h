@@ -17,6 +17,7 @@
 #include <iostream>    // class ostream and objects cerr, cout
 #include <cstdlib>     // EXIT_FAILURE, size_t
 #include <compare.h>   // needed for Sort()
+#include <memtrack.h>  // HeapUsage()
 
 namespace fsu
 {
@@ -83,6 +84,7 @@ namespace fsu
 
     // information about the list - accessors
     size_t    Size  () const;  // return the number of elements on the list
+    size_t    MemoryUsage () const; // bytes owned, including links and both sentinels
     bool      Empty () const;  // true iff list has no elements
 
     // accessing values on the list - more accessors
@@ -161,6 +163,9 @@ namespace fsu
   template <typename T>
   std::ostream& operator << (std::ostream& os, const List<T>& list);
 
+  template <typename T>
+  size_t HeapUsage (const List<T>& list) { return list.MemoryUsage() - sizeof(list); }
+
   //----------------------------------
   //     ConstListIterator<T>
   //----------------------------------
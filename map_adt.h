@@ -14,22 +14,96 @@
  
  Iterators are implemented in a different class and can be of various types (e.g. Inorder, Levelorder).
  
+ ParallelForEach() and ParallelReduce() visit the live entries on a work-stealing
+ pool (threadpool.h). The tree splits at a node into its left subtree (a new task),
+ the node itself, and its right subtree (kept by the current thread). Splitting
+ stops once a subtree's black height promises fewer than grain entries; that
+ subtree is walked sequentially, inorder. ParallelForEach calls f(entry) concurrently
+ and in no overall order; f is copied into every task. ParallelReduce gives
+ combine(...combine(combine(identity, map(e1)), map(e2))..., map(en)) over the
+ entries in key order, grouped as the tree splits. So combine must be associative
+ with identity as its identity, but it need not be commutative; map and combine are
+ called concurrently. The map must not be modified during either call, except
+ that the non-const ParallelForEach may assign to data_.
+ 
+ EnableFilter() puts a blocked Bloom filter (bloom.h) in front of Includes() and
+ Retrieve(): a key that was never put answers "absent" after one hash and one
+ cache line, with no descent. Get/Put add keys to it, doubling it as needed, and
+ Rehash() rebuilds it without the erased keys.
+ 
+ EnableArena() moves the nodes into a NodeArena (arena.h), which takes memory from the
+ system in chunks of 2 MiB and up and asks for huge pages for them, so that a descent
+ through a map of several GB does not miss the data TLB at every level. Nodes made from
+ then on come from the arena, and nodes freed go back to it. DisableArena() moves the
+ nodes back to the heap. Both moves copy the tree, in Theta(n) with twice the memory at
+ the peak. A copy of a map with an arena gets an arena of its own.
+ 
+ After long churn the nodes lie in the order they were allocated, not in the order a
+ search or a walk visits them. Relayout(order) copies the tree, with the same shape,
+ into a fresh arena, laying the nodes out one after another in the given order:
+ LEVELORDER or VEB (van Emde Boas: the top half of the levels, then each subtree below
+ it, recursively) put the nodes near the root, and each node near its children, on few
+ cache lines and pages, for lookups; INORDER puts them in key order, for iteration;
+ PREORDER is the order of EnableArena() and of copies. Nodes made afterwards come from
+ the free blocks and the end of the arena, so a map that keeps changing will want
+ another Relayout() in time. Like the arena moves, Relayout() is Theta(n) and
+ invalidates iterators and the references returned by Get().
+ 
+ Built with -DMAP_ADT_DIGEST, every node also stores a 64-bit digest of the live
+ entries in its subtree, kept current by Put, Insert, Erase and the rotations.
+ Digest() then compares whole maps in O(1) and Diff() lists the keys where two maps
+ differ in O(d log^2 n), whatever the shapes of the two trees. See map_digest.h.
+ 
  The runtimes of all operations will be Theta(log n)
- with the exception of the Rehash() function, which will be Thetat(n log n).  The RBLLT structure is
- what ensures the log n runtimes; the rehash fucntion is n log n because it requires a full tree
- traversal and new tree creation.
+ with the exception of the Rehash() and Build() functions, which will be Theta(n).  The RBLLT structure is
+ what ensures the log n runtimes; Rehash() and Build() take a sequence already in key order and
+ build the new tree top-down, one node per entry in key order, with no searching and no
+ rotations. The new tree is as short as a left-leaning red-black tree of its size can be:
+ nodes split evenly where they can, and a 3-node (a black node with a red left child) is
+ used only where 2-nodes alone could not hold the entries.
+ 
+ StartRehash() begins an incremental Rehash() instead, for maps too large to stall on.
+ The old tree is frozen and a new one grows beside it. Put, Get and Erase go to the new
+ tree; each first copies over the old entry of its key when it needs it. RehashStep(us)
+ moves the old tree's live entries, in key order, into the new tree for about us
+ microseconds, and deletes each old node as it passes it. Every Get, Put and Erase
+ does a step of SetRehashBudget() microseconds (default 20). Retrieve() looks in the new
+ tree and then in what is left of the old one. When the old tree is used up, the new
+ tree takes over. Unlike Rehash(), the new tree is grown by insertion, so it is balanced
+ but not the shortest possible, and it keeps the tombstones of keys erased meanwhile.
+ The filter, if any, is not rebuilt, and StartRehash() during a rehash does nothing.
+ Includes() does a step too and copies its key over, as Get() does. Const calls read both
+ trees and leave the rehash where it is: a const inorder iterator walks them side by side,
+ in key order, and Size(), the digests, Diff(), Scan() and copying see every live entry.
+ The levelorder and structural iterators, the Dumps, CheckBST and CheckRBLLT see the new
+ tree only; the Dumps say how many old nodes are left. The non-const Begin(), rBegin()
+ and ParallelForEach() finish the rehash with FinishRehash() first. References that Get()
+ returned before StartRehash() are invalidated, as by Rehash(), and so is every iterator
+ into a rehashing map once a non-const call moves entries.
  */
 
 #ifndef _MAP_ADT_H
 #define _MAP_ADT_H
 
 #include <cstddef>    // size_t
+#include <algorithm>  // min, max
+#include <chrono>     // RehashStep()
 #include <iostream>
 #include <iomanip>
 #include <compare.h>  // LessThan
 #include <queue.h>    // used in Dump()
 #include <ansicodes.h>
 #include <entry.h>
+#include <map_stats.h> // MAP_STAT(), compiled in with -DMAP_ADT_STATS
+#include <map_digest.h> // MAP_DIGEST(), compiled in with -DMAP_ADT_DIGEST
+#include <map_check.h>  // MAP_CHECK(), compiled in with -DMAP_ADT_CHECK
+#include <vector.h>     // the old tree's inorder stack, while rehashing
+#include <bloom.h>      // EnableFilter()
+#include <arena.h>      // EnableArena()
+#include <hashval.h>
+#include <trace.h>     // FSU_TRACE_*(), compiled in with -DFSU_TRACE
+#include <memtrack.h>  // HeapUsage()
+#include <threadpool.h> // ParallelForEach(), ParallelReduce()
 #include <mapiter_adt.h>
 
 namespace fsu
@@ -87,7 +161,7 @@ namespace fsu
         
         DataType& operator [] (const KeyType& k)        { return Get(k); }
         
-        void Put (const KeyType& k , const DataType& d) { Get(k) = d; }
+        void Put (const KeyType& k , const DataType& d);
         D&   Get (const KeyType& k);
         
         //Additional Table API features
@@ -103,16 +177,84 @@ namespace fsu
         void Clear();
         void Rehash();
         
-        bool   Empty    () const { return root_ == nullptr; }
-        size_t Size     () const { return RSize(root_); }     // counts alive nodes
-        size_t NumNodes () const { return RNumNodes(root_); } // counts nodes
-        int    Height   () const { return RHeight(root_); }
+        // incremental Rehash(); see the notes at the top
+        void StartRehash     ();
+        bool RehashStep      (size_t budgetUs);  // true once the new tree has taken over
+        void FinishRehash    ();
+        bool Rehashing       () const { return !rehash_.Empty(); }
+        void SetRehashBudget (size_t budgetUs) { stepUs_ = budgetUs; } // per Get, Put, Erase
+        
+        // replaces the contents with [beg,end) in Theta(n); I is a forward iterator and
+        // (*i).key_, (*i).data_ give each entry. Returns false, leaving the map unchanged,
+        // unless the keys are strictly increasing under the predicate.
+        template < class I >
+        bool Build (I beg, I end);
+        
+        // piecewise reading and tree exchange, for compaction off the map's thread (syncmap.h).
+        // Scan passes n nodes, alive or dead, in key order from the first key after *after
+        // (from the least key when after is nullptr), calling f(const EntryType&) on the live
+        // ones; it returns the last key passed, or nullptr once the end is reached.
+        // SwapTree exchanges the trees, with their arenas: filters, predicates and counters
+        // stay, so each map's filter must already hold the keys of the tree it receives.
+        template < class F >
+        const K* Scan     (const K* after, size_t n, F f) const;
+        void     SwapTree (Map_ADT& other);
+        
+        bool   Empty    () const { return root_ == nullptr && rehash_.Empty(); }
+        size_t Size     () const; // counts alive nodes
+        size_t NumNodes () const; // counts nodes
+        int    Height   () const;
+        size_t MemoryUsage () const; // bytes owned, tombstones included
+        
+        // optional Bloom filter in front of Includes/Retrieve; K needs a HashValue() (hashval.h)
+        void               EnableFilter  (size_t bitsPerKey = 10);
+        void               DisableFilter ();
+        const BloomFilter* Filter        () const { return filter_; } // nullptr when disabled
+        
+        // node memory from an arena, on huge pages when hugePages and the system allows
+        void             EnableArena  (bool hugePages = true);
+        void             DisableArena ();
+        const NodeArena* Arena        () const { return arena_; } // nullptr when disabled
+        
+        // the nodes, same shape, into a fresh arena in the given order; see the notes at the top
+        enum Layout { PREORDER, LEVELORDER, VEB, INORDER };
+        void             Relayout     (Layout order);
+        
+        // parallel traversal of live entries; pool == nullptr means ThreadPool::Default()
+        template < class F >
+        void ParallelForEach (F f, size_t grain = 4096, ThreadPool* pool = nullptr) const; // f(const EntryType&)
+        template < class F >
+        void ParallelForEach (F f, size_t grain = 4096, ThreadPool* pool = nullptr);       // f(EntryType&)
+        template < typename T , class M , class C >
+        T    ParallelReduce  (const T& identity, M map, C combine,
+                              size_t grain = 4096, ThreadPool* pool = nullptr) const;    // map(const EntryType&) -> T
         
         void   DumpBW (std::ostream& os) const;
         void   Dump (std::ostream& os) const;
         void   Dump (std::ostream& os, int kw) const;
         void   Dump (std::ostream& os, int kw, char fill) const;
         
+#ifdef MAP_ADT_STATS
+        const MapStats& Stats      () const { return stats_; }
+        void            ResetStats () const { stats_.Reset(); }
+#endif
+        
+#ifdef MAP_ADT_CHECK
+        // online invariant checking; see map_check.h
+        const MapCheckStats& CheckStats       () const { check_.Join(); return check_; }
+        void                 SetCheckInterval (size_t every) { check_.every = every; }
+        void                 SetCheckBudget   (double fraction) { check_.budget = fraction; }
+#endif
+        
+#ifdef MAP_ADT_DIGEST
+        // content digests; see map_digest.h
+        uint64_t Digest      () const { Refresh(); return Sum(root_) + OldSum(nullptr, nullptr); }
+        uint64_t RangeDigest (const KeyType& lo, const KeyType& hi) const;
+        bool     DigestFresh () const { return !digestStale_; }
+        template < class F >
+        size_t   Diff        (const Map_ADT& other, F f) const; // f(const KeyType&)
+#endif
+        
     private: // definitions and relationships
         
         enum Flags { ZERO = 0x00 , DEAD = 0x01, RED = 0x02 , DEFAULT = RED }; // DEFAULT = alive,red
@@ -148,6 +290,9 @@ namespace fsu
             
             Node * lchild_, * rchild_;
             uint8_t flags_; //8 bit value
+#ifdef MAP_ADT_DIGEST
+            uint64_t sum_;  //digest of the live entries in this subtree
+#endif
             Node (const KeyType& k, const DataType& d, Flags flags = DEFAULT) // Flags = RED, Alive
             : value_(k,d), lchild_(nullptr), rchild_(nullptr), flags_(flags)
             {}
@@ -199,39 +344,153 @@ namespace fsu
     private: // data
         Node *         root_;
         PredicateType  pred_;
+        BloomFilter *  filter_;  // nullptr unless EnableFilter(); holds every key made alive since its last rebuild
+        fsu::Vector < Node* > rehash_; // while rehashing: what is left of the old tree, an inorder stack
+        size_t         stepUs_;  // RehashStep budget of each Get, Put and Erase
+        NodeArena *    arena_;   // nullptr unless EnableArena(); owns the memory of every node
+#ifdef MAP_ADT_STATS
+        mutable MapStats stats_;
+#endif
+#ifdef MAP_ADT_CHECK
+        mutable MapCheckStats check_;
+        bool CheckPath (const K& k) const;              // O(log n): the path to k, then the left spine below it
+        void Checked   (const char* op, const K& k);    // after a mutating call: path check, maybe a full check
+#endif
+#ifdef MAP_ADT_DIGEST
+        mutable bool   digestStale_; // more references to data_ escaped than lent_ holds; sums need RResum()
+        mutable const Node* lent_[8];   // nodes whose data_ a caller may have written since the last Repay()
+        mutable uint64_t    lentOwn_[8]; // the term of each that the sums still hold
+        mutable size_t      lentCount_;
+        uint64_t       pathDelta_;   // digest change made at the bottom of an RGet/RInsert path
+#endif
         
     private: // methods
-        static Node * NewNode     (const K& k, const D& d, Flags flags = DEFAULT);
-        static void   RRelease    (Node* n); // deletes all descendants of n
-        static Node * RClone      (const Node* n); // returns deep copy of n
+        Node *        NewNode     (const K& k, const D& d, Flags flags = DEFAULT) const;
+        void          FreeNode    (Node* n) const;
+        void          RRelease    (Node* n); // deletes all descendants of n
+        void          Relocate    (NodeArena* a, Layout order = PREORDER); // copies the tree into a's memory (nullptr: the heap)
+        struct Slot { const Node * old; Node ** link; }; // a node to copy, and where its copy goes
+        Node *        CopyNode    (const Node* n) const; // childless copy
+        Node *        RInorderCopy (const Node* n) const;
+        void          RVebCopy    (const Node* n, Node** link, int levels, fsu::Vector < Slot >& fringe) const;
+        Node *        RClone      (const Node* n) const; // returns deep copy of n
         static size_t RSize       (Node * n);
         static size_t RNumNodes   (Node * n);
         static int    RHeight     (Node * n);
+        static size_t RMemory     (Node * n);
+        
+        // parallel traversal support; bh is the black height of n
+        static int    RBlackHeight (Node * n);
+        static bool   Splittable   (int bh, size_t grain) { return bh < 63 && ((size_t)1 << bh) > grain; }
+        template < class E , class F >
+        static void   RForEach     (Node * n, F& f);
+        template < class E , class F >
+        static void   RParallelForEach (Node * n, int bh, const F& f, size_t grain, TaskGroup& g);
+        template < typename T , class M , class C >
+        static void   RFold        (Node * n, T& acc, const M& map, const C& combine);
+        template < typename T , class M , class C >
+        static T      RParallelReduce (Node * n, int bh, const T& identity, const M& map, const C& combine,
+                                       size_t grain, ThreadPool& pool);
+        
+        // order predicate; the single place comparisons are counted
+        bool Less (const K& a, const K& b) const
+        {
+            MAP_STAT(++stats_.comparisons;)
+            return pred_(a,b);
+        }
         
         // rotations
-        static Node * RotateLeft  (Node * n);
-        static Node * RotateRight (Node * n);
+        Node * RotateLeft  (Node * n);
+        Node * RotateRight (Node * n);
         
-        // recursive left-leaning get
-        Node * RGet(Node* nptr, const K& kval, Node*& location);
+        // recursive left-leaning get; assigns *assign to the entry's data when given
+        Node * RGet(Node* nptr, const K& kval, Node*& location, const D* assign = nullptr);
         
         // recursive left-leaning insert
         Node * RInsert(Node* nptr, const K& key, const D& data);
         
+        // linear build from n entries in key order; Rebuilt() follows the root swap
+        template < class I >
+        Node * BuildTree (I beg, size_t n) const;
+        template < class I >
+        Node * RBuild    (I& i, size_t n, int bh, int reds) const;
+        static size_t MaxNodes (int bh, int reds);
+        void   Rebuilt   ();
+        
+        // incremental rehash support
+        void   PushLeft (Node * n) { for ( ; n != nullptr; n = n->lchild_) rehash_.PushBack(n); }
+        const Node * Seek    (const Node * n, const K& k) const; // the node with key k below n, alive or dead
+        const Node * SeekOld (const K& k) const;                 // same, in what is left of the old tree
+        void   Adopt   (const K& k);             // copies k's live old entry into the new tree, if it has none
+        size_t Count   () const;                 // live entries in both trees, an entry in both counted twice
+        void   DumpRehash (std::ostream& os) const;  // the old nodes left, if any
+        
+        
+    private: // filter support
+        typedef std::integral_constant < bool , HasHashValue<K>::value > Hashable;
+        static uint64_t KeyHash (const K& k, std::true_type)  { return HashValue(k); }
+        static uint64_t KeyHash (const K&  , std::false_type) { return 0; } // EnableFilter() refuses these keys
+        bool FilterRejects (const K& k) const { return filter_ != nullptr && !filter_->MayContain(KeyHash(k, Hashable())); }
+        void FilterAdd     (const K& k);
+        void FilterRebuild (size_t capacity);
+        
+#ifdef MAP_ADT_DIGEST
+    private: // digest support
+        static uint64_t Sum (const Node* n) { return n ? n->sum_ : 0; }
+        static uint64_t Own (const Node* n) { return n->IsAlive() ? EntryDigest(n->value_.key_, n->value_.data_) : 0; }
+        static uint64_t RResum (Node* n);
+        void            Refresh () const { if (digestStale_) { RResum(root_); digestStale_ = false; lentCount_ = 0; } else Repay(); }
+        void            Lend    (const Node* n) const;          // a reference to n's data_ is handed out
+        void            Relent  (const Node* n, uint64_t delta) const; // the sums moved n's term by delta
+        void            Repay   () const;                       // the lent nodes' changes, one path each
+        uint64_t        Prefix  (const K& k, bool inclusive) const; // live keys < k (<= k)
+        uint64_t        Between (const K* lo, const K* hi) const;   // live keys in (lo,hi); null = unbounded
+        uint64_t        OldSum  (const K* lo, const K* hi) const;   // old tree, entries not yet moved, lo <= key < hi
+        const Node*     Find    (const K& k) const;                 // node with key k, alive or dead
+        template < class F >
+        void            RDiff     (const Node* n, const K* lo, const K* hi, const Map_ADT& other, F& f, size_t& d) const;
+        template < class F >
+        void            RForRange (const Node* n, const K* lo, const K* hi, F& f, size_t& d) const;
+        static uint64_t RCheckDigest (const Node* n, bool& ok);
+#endif
+        
+    private: // single-pass checker support
+        struct CheckSummary        // one subtree, as seen by CheckRBLLTFast
+        {
+            size_t      nodes, dead;
+            int         height;     // nodes on the longest path
+            int         black;      // black nodes on the leftmost path
+            const Node* bad;        // first violation found, or nullptr
+            int         property;   // its RBLLT property number
+        };
+        CheckSummary RCheckFast     (const Node* n, const K* lo, const K* hi) const;
+        CheckSummary RParallelCheck (const Node* n, const K* lo, const K* hi, int bh, size_t grain, ThreadPool& pool) const;
+        CheckSummary Join           (const Node* n, const K* lo, const K* hi, const CheckSummary& l, const CheckSummary& r) const;
         
     public: //signatures for map_tools.cpp
         bool CheckBST(bool verboseFlag) const;
         bool CheckRBLLT (int verboseFlag) const;
+        // one O(n) pass, no allocation; parallel splits the tree over pool, like ParallelReduce
+        bool CheckRBLLTFast (int verboseFlag = 0, bool parallel = false, size_t grain = 65536,
+                             ThreadPool* pool = nullptr) const;
+#ifdef MAP_ADT_DIGEST
+        bool CheckDigest (bool verboseFlag) const;
+#endif
         
         
         
     }; // class Map_ADT<>
     
+    // heap bytes owned beyond sizeof(map); see memtrack.h
+    template < typename K, typename D, class P >
+    size_t HeapUsage (const Map_ADT<K,D,P>& m) { return m.MemoryUsage() - sizeof(m); }
+    
     
     //global operator implementations
     template < typename K, typename D, class P >
     bool operator == (const Map_ADT<K,D,P> &map1, const Map_ADT<K,D,P> &map2)
     {
+        MAP_DIGEST(if (map1.DigestFresh() && map2.DigestFresh() && map1.Digest() != map2.Digest()) return 0;)
         typename Map_ADT<K,D,P>::ConstIterator i,j;
         for (i = map1.Begin(), j = map2.Begin(); i != map1.End() && j != map2.End(); ++i, ++j)
         {
@@ -257,7 +516,10 @@ namespace fsu
     template < typename K, typename D, class P >
     typename Map_ADT<K,D,P>::Iterator Map_ADT<K,D,P>::Begin()
     {
+        FinishRehash();
         Iterator i;
+        MAP_DIGEST(digestStale_ = true;)
+        MAP_STAT(i.stats_ = &stats_;)
         i.Init(root_);
         return i;
     }
@@ -274,7 +536,10 @@ namespace fsu
     template < typename K, typename D, class P >
     typename Map_ADT<K,D,P>::Iterator Map_ADT<K,D,P>::rBegin()
     {
+        FinishRehash();
         Iterator i;
+        MAP_DIGEST(digestStale_ = true;)
+        MAP_STAT(i.stats_ = &stats_;)
         i.rInit(root_);
         return i;
     }
@@ -292,7 +557,11 @@ namespace fsu
     typename Map_ADT<K,D,P>::ConstIterator Map_ADT<K,D,P>::Begin() const
     {
         ConstIterator i;
-        i.Init(root_);
+        MAP_STAT(i.stats_ = &stats_;)
+        if (rehash_.Empty())
+            i.Init(root_);
+        else
+            i.mInit(this); //both trees
         return i;
     }
     
@@ -309,7 +578,11 @@ namespace fsu
     typename Map_ADT<K,D,P>::ConstIterator Map_ADT<K,D,P>::rBegin() const
     {
         ConstIterator i;
-        i.rInit(root_);
+        MAP_STAT(i.stats_ = &stats_;)
+        if (rehash_.Empty())
+            i.rInit(root_);
+        else
+            i.mrInit(this);
         return i;
     }
     
@@ -326,6 +599,7 @@ namespace fsu
     typename Map_ADT<K,D,P>::LevelorderIterator Map_ADT<K,D,P>::BeginLevelorder() const
     {
         LevelorderIterator i;
+        MAP_STAT(i.stats_ = &stats_;)
         i.Init(root_);
         return i;
     }
@@ -352,37 +626,65 @@ namespace fsu
     template < typename K, typename D, class P >
     bool Map_ADT<K,D,P>::Retrieve (const KeyType &k, DataType &d) const
     {
-        Iterator i = this->Includes(k); //return iterator to entry containing key k
-        if (i == this->End()) //if not found
-            return 0; //do nothing, return false
-        else // found
+        FSU_TRACE_SCOPE("Map::Retrieve");
+        if (FilterRejects(k)) //certainly absent
         {
-            d = (*i).data_; //key found, overrite data value sent
-            return 1; //return true
+            MAP_STAT(++stats_.filterRejects;)
+            return 0;
         }
+        const Node * n = Seek(root_, k);
+        if (n == nullptr && !rehash_.Empty()) //not in the new tree: the old one decides
+            n = SeekOld(k);
+        if (n == nullptr || n->IsDead()) //if not found
+            return 0; //do nothing, return false
+        d = n->value_.data_; //key found, overrite data value sent
+        return 1; //return true
     }
 
     
     template < typename K, typename D, class P >
     typename Map_ADT<K,D,P>::Iterator Map_ADT<K,D,P>::Includes (const KeyType &k)
     {
+        FSU_TRACE_SCOPE("Map::Includes");
+        if (FilterRejects(k)) //certainly absent
+        {
+            MAP_STAT(++stats_.filterRejects;)
+            return End();
+        }
         Iterator i; //declare iterator, initializes with empty stack
+        MAP_STAT(i.stats_ = &stats_;)
+        MAP_DIGEST(i.lender_ = this;) //each entry the caller may write through it is lent
+        if (!rehash_.Empty())
+        {
+            MAP_CHECK(check_.Join();)
+            RehashStep(stepUs_);
+            Adopt(k); //a live entry is now in the new tree, where the iterator finds it first
+        }
+        if (!rehash_.Empty())
+        {
+            i.mSeek(this, k);
+            if (i.Valid() && !Less(k, (*i).key_) && i.Top()->IsAlive())
+                return i;
+            return End();
+        }
         Node * n = root_; //start at the root of the tree
         
         while(n) //while not null
         {
-            if (pred_(k, n->value_.key_)) //if k is less than current key
+            MAP_STAT(stats_.Visit();)
+            if (Less(k, n->value_.key_)) //if k is less than current key
             {
                 (i.stk_).Push(n); //push node to stack
                 n = n->lchild_; //go left
             }
-            else if (pred_(n->value_.key_,k)) //if k is greater than current key
+            else if (Less(n->value_.key_,k)) //if k is greater than current key
             {
                 (i.stk_).Push(n);
                 n = n->rchild_; //go right
             }
             else // key found
             {
+                MAP_STAT(stats_.EndPath();)
                 (i.stk_).Push(n);
                 if (n->IsAlive())
                     return i; //returns iterator with top stack value as found value if the node is alive
@@ -390,6 +692,7 @@ namespace fsu
                     return End();
             }
         }
+        MAP_STAT(stats_.EndPath();)
         //if we make it out of the loop, the key was not found at atll
         return End();
     }
@@ -398,23 +701,39 @@ namespace fsu
     template < typename K, typename D, class P >
     typename Map_ADT<K,D,P>::ConstIterator Map_ADT<K,D,P>::Includes (const KeyType &k) const
     {
+        FSU_TRACE_SCOPE("Map::Includes");
+        if (FilterRejects(k)) //certainly absent
+        {
+            MAP_STAT(++stats_.filterRejects;)
+            return End();
+        }
         Iterator i; //declare iterator, initializes with empty stack
+        MAP_STAT(i.stats_ = &stats_;)
+        if (!rehash_.Empty()) //both trees; the new one's entry hides the old one's
+        {
+            i.mSeek(this, k);
+            if (i.Valid() && !Less(k, (*i).key_) && i.Top()->IsAlive())
+                return i;
+            return End();
+        }
         Node * n = root_; //start at the root of the tree
         
         while(n) //while not null
         {
-            if (pred_(k, n->value_.key_)) //if k is less than current key
+            MAP_STAT(stats_.Visit();)
+            if (Less(k, n->value_.key_)) //if k is less than current key
             {
                 (i.stk_).Push(n); //push node to stack
                 n = n->lchild_; //go left
             }
-            else if (pred_(n->value_.key_,k)) //if k is greater than current key
+            else if (Less(n->value_.key_,k)) //if k is greater than current key
             {
                 (i.stk_).Push(n);
                 n = n->rchild_; //go right
             }
             else // key found
             {
+                MAP_STAT(stats_.EndPath();)
                 (i.stk_).Push(n);
                 if (n->IsAlive())
                     return i; //returns iterator with top stack value as found value if the node is alive
@@ -422,6 +741,7 @@ namespace fsu
                     return End();
             }
         }
+        MAP_STAT(stats_.EndPath();)
         //if we make it out of the loop, the key was not found at atll
         return End();
     }
@@ -431,41 +751,101 @@ namespace fsu
     D& Map_ADT<K,D,P>::Get (const KeyType& k)
     {
         //returns reference to data value assoated with k; inserts if necessary
+        FSU_TRACE_SCOPE("Map::Get");
+        MAP_CHECK(check_.Join();) //a background check must not see the tree change
+        if (!rehash_.Empty())
+        {
+            RehashStep(stepUs_);
+            Adopt(k); //else the new D() would hide the old data
+        }
         Node * location;
         root_ = RGet(root_,k,location); //use recursive get to find location of key
         root_ -> SetBlack(); //root is always black
+        MAP_STAT(stats_.EndPath();)
+        if (filter_) FilterAdd(k);
+        MAP_CHECK(Checked("Get", k);)
+        MAP_DIGEST(Lend(location);) //the caller may write through the reference
         return location->value_.data_; //returns node's data as a reference
     }
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Put (const KeyType& k, const DataType& d)
+    {
+        //like Get, but assigns d on the way, so no reference escapes
+        FSU_TRACE_SCOPE("Map::Put");
+        MAP_CHECK(check_.Join();)
+        if (!rehash_.Empty())
+            RehashStep(stepUs_); //the new entry hides the old one
+        Node * location;
+        root_ = RGet(root_,k,location,&d);
+        root_ -> SetBlack();
+        MAP_STAT(stats_.EndPath();)
+        if (filter_) FilterAdd(k);
+        MAP_CHECK(Checked("Put", k);)
+    }
 
     template < typename K , typename D , class P >
     void Map_ADT<K,D,P>::Erase(const KeyType& k)
     {
+        FSU_TRACE_SCOPE("Map::Erase");
+        MAP_CHECK(check_.Join();)
+        if (!rehash_.Empty())
+        {
+            RehashStep(stepUs_);
+            Adopt(k); //the tombstone goes in the new tree
+        }
         Node * n = root_; // start at root of tree
         while(n) //while on a valid node
         {
-            if (pred_(k, n->value_.key_)) //if k is less than current key
+            MAP_STAT(stats_.Visit();)
+            if (Less(k, n->value_.key_)) //if k is less than current key
             {
                 n = n->lchild_; //go left
             }
-            else if (pred_(n->value_.key_, k)) //if k is greater than current key
+            else if (Less(n->value_.key_, k)) //if k is greater than current key
             {
                 n = n->rchild_; //go right
             }
             else //key found
             {
+#ifdef MAP_ADT_DIGEST
+                if (n->IsAlive() && !digestStale_)
+                {
+                    //take the entry's term out of every subtree sum on its path
+                    uint64_t h = Own(n);
+                    for (Node * a = root_; a != n; a = Less(k, a->value_.key_) ? a->lchild_ : a->rchild_)
+                        a->sum_ -= h;
+                    n->sum_ -= h;
+                    Relent(n, 0 - h);
+                }
+#endif
                 n->SetDead();
-                return;
+                break;
             }
         }
+        MAP_STAT(stats_.EndPath();)
+        MAP_CHECK(Checked("Erase", k);)
     }
     
 
     template < typename K , typename D , class P >
     void Map_ADT<K,D,P>::Clear()
     {
+        FSU_TRACE_SCOPE("Map::Clear");
+        MAP_CHECK(check_.Join();)
         RRelease(root_); //delete all descendents of root
-        delete root_; //delete the root itself
+        FreeNode(root_); //delete the root itself
         root_ = 0; //set root to 0 (empty tree)
+        for (size_t i = 0; i < rehash_.Size(); ++i) //what is left of an old tree
+        {
+            RRelease(rehash_[i]->rchild_);
+            FreeNode(rehash_[i]->rchild_);
+            FreeNode(rehash_[i]);
+        }
+        rehash_.Clear();
+        if (arena_) arena_->Release(); //every node is gone: give the chunks back
+        MAP_DIGEST(digestStale_ = false; lentCount_ = 0;)
+        if (filter_) filter_->Clear();
     }
     
     
@@ -473,39 +853,541 @@ namespace fsu
     void Map_ADT<K,D,P>::Rehash()
     //restructure with no tombstones
     {
-        Node * newRoot = nullptr;
-        for (ConstIterator i = this->Begin(); i != this->End(); ++i)
+        FSU_TRACE_SCOPE_ARG("Map::Rehash", Size());
+        const Map_ADT& self = *this; //const iterators leave the digest fresh
+        Node * newRoot = BuildTree(self.Begin(), Size()); //inorder skips the tombstones
+        this->Clear(); //clears existing tree
+        this->root_ = newRoot; //RBuild summed every node: digest fresh
+        Rebuilt();
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::StartRehash()
+    // the tree becomes the old tree; the new one starts empty
+    {
+        FSU_TRACE_SCOPE("Map::StartRehash");
+        if (!rehash_.Empty() || root_ == nullptr)
+            return;
+        MAP_CHECK(check_.Join();)
+        PushLeft(root_);
+        root_ = nullptr;
+        MAP_DIGEST(digestStale_ = false; lentCount_ = 0;) //the new tree's sums are made as it grows
+    }
+    
+    
+    template < typename K , typename D , class P >
+    bool Map_ADT<K,D,P>::RehashStep(size_t budgetUs)
+    // moves old entries in key order until the budget is spent; each old node is
+    // deleted once it has been passed, its left subtree first
+    {
+        if (rehash_.Empty())
+            return 1;
+        FSU_TRACE_SCOPE("Map::RehashStep");
+        MAP_CHECK(check_.Join();)
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point stop = Clock::now() + std::chrono::microseconds(budgetUs);
+        for (size_t moved = 1; !rehash_.Empty(); ++moved)
         {
-            newRoot = RInsert(newRoot,(*i).key_, (*i).data_);
-            newRoot->SetBlack();
+            Node * n = rehash_.Back();
+            rehash_.PopBack();
+            PushLeft(n->rchild_);
+            if (n->IsAlive() && Seek(root_, n->value_.key_) == nullptr) //not yet replaced by a newer entry
+            {
+                Node * location;
+                root_ = RGet(root_, n->value_.key_, location, &n->value_.data_);
+                root_->SetBlack();
+            }
+            FreeNode(n);
+            if (moved % 16 == 0 && Clock::now() >= stop)
+                break;
         }
-        this->Clear(); //clears existing tree
+        if (!rehash_.Empty())
+            return 0;
+        rehash_.SetCapacity(0);
+        return 1;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::FinishRehash()
+    {
+        while (!RehashStep(1000000)) {}
+    }
+    
+    
+    template < typename K , typename D , class P >
+    const typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::Seek(const Node * n, const K& k) const
+    {
+        while (n != nullptr)
+        {
+            MAP_STAT(stats_.Visit();)
+            if (Less(k,n->value_.key_))
+                n = n->lchild_;
+            else if (Less(n->value_.key_,k))
+                n = n->rchild_;
+            else
+                break;
+        }
+        MAP_STAT(stats_.EndPath();)
+        return n;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    const typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::SeekOld(const K& k) const
+    // the stack holds keys decreasing from bottom to top; what is left of the old tree is
+    // the stack nodes and their right subtrees, each right subtree between its node and
+    // the node below it in the stack. Keys below the top have been moved, or were dead.
+    {
+        size_t lo = 0, hi = rehash_.Size(); //find the first index whose key is < k
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (Less(rehash_[mid]->value_.key_, k))
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        if (lo > 0 && !Less(k, rehash_[lo - 1]->value_.key_)) //the least key >= k is k
+            return rehash_[lo - 1];
+        if (lo == rehash_.Size()) //k precedes every old key that is left
+            return nullptr;
+        return Seek(rehash_[lo]->rchild_, k);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Adopt(const K& k)
+    // an old tombstone is dropped, as Rehash() drops it
+    {
+        if (Seek(root_, k) != nullptr)
+            return;
+        const Node * o = SeekOld(k);
+        if (o == nullptr || o->IsDead())
+            return;
+        Node * location;
+        root_ = RGet(root_, k, location, &o->value_.data_);
+        root_->SetBlack();
+    }
+    
+    
+    template < typename K , typename D , class P >
+    size_t Map_ADT<K,D,P>::Count() const
+    // an entry in both trees counts twice; good enough to size the filter
+    {
+        size_t n = RSize(root_);
+        for (size_t i = 0; i < rehash_.Size(); ++i)
+            n += rehash_[i]->IsAlive() + RSize(rehash_[i]->rchild_);
+        return n;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    size_t Map_ADT<K,D,P>::Size() const
+    {
+        if (rehash_.Empty())
+            return RSize(root_);
+        size_t n = 0;
+        for (ConstIterator i = Begin(); i != End(); ++i)
+            ++n;
+        return n;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    size_t Map_ADT<K,D,P>::NumNodes() const
+    {
+        size_t n = RNumNodes(root_);
+        for (size_t i = 0; i < rehash_.Size(); ++i)
+            n += 1 + RNumNodes(rehash_[i]->rchild_);
+        return n;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    int Map_ADT<K,D,P>::Height() const
+    // rehash_[i] is i levels below the old root
+    {
+        int h = RHeight(root_);
+        for (size_t i = 0; i < rehash_.Size(); ++i)
+            h = std::max(h, (int)i + 1 + RHeight(rehash_[i]->rchild_));
+        return h;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    size_t Map_ADT<K,D,P>::MemoryUsage() const
+    {
+        size_t m = sizeof(*this) + RMemory(root_) + (filter_ ? filter_->MemoryUsage() : 0) + (arena_ ? arena_->Slack() : 0);
+        for (size_t i = 0; i < rehash_.Size(); ++i)
+        {
+            const Node * n = rehash_[i];
+            m += sizeof(Node) + HeapUsage(n->value_.key_) + HeapUsage(n->value_.data_) + RMemory(n->rchild_);
+        }
+        return m + rehash_.Capacity() * sizeof(Node*);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::DumpRehash(std::ostream& os) const
+    {
+        if (!rehash_.Empty())
+            os << "  rehashing: " << NumNodes() - RNumNodes(root_) << " old nodes left, not shown\n";
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class I >
+    bool Map_ADT<K,D,P>::Build (I beg, I end)
+    {
+        FSU_TRACE_SCOPE("Map::Build");
+        size_t n = 0;
+        for (I i = beg, prev = beg; i != end; prev = i, ++i, ++n)
+        {
+            if (n > 0 && !Less((*prev).key_, (*i).key_)) //out of order, or a repeated key
+                return 0;
+        }
+        Node * newRoot = BuildTree(beg, n);
+        this->Clear();
         this->root_ = newRoot;
+        Rebuilt();
+        return 1;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class F >
+    const K* Map_ADT<K,D,P>::Scan (const K* after, size_t n, F f) const
+    {
+        FSU_TRACE_SCOPE("Map::Scan");
+        if (!rehash_.Empty()) //both trees, in step
+        {
+            ConstIterator i;
+            MAP_STAT(i.stats_ = &stats_;)
+            if (after == nullptr)
+                i.mInit(this);
+            else
+            {
+                i.mSeek(this, *after);
+                if (i.Valid() && !Less(*after, (*i).key_))
+                    i.Increment();
+            }
+            const K* last = nullptr;
+            for ( ; n > 0 && i.Valid(); --n)
+            {
+                const Node * p = i.Top();
+                if (p->IsAlive())
+                    f(p->value_);
+                last = &p->value_.key_;
+                i.Increment();
+            }
+            return i.Valid() ? last : nullptr;
+        }
+        fsu::Vector < const Node* > stack; //the inorder successors still to visit
+        for (const Node * p = root_; p != nullptr; )
+        {
+            MAP_STAT(stats_.Visit();)
+            if (after == nullptr || Less(*after, p->value_.key_))
+            {
+                stack.PushBack(p);
+                p = p->lchild_;
+            }
+            else
+                p = p->rchild_;
+        }
+        MAP_STAT(stats_.EndPath();)
+        const K* last = nullptr;
+        for ( ; n > 0 && !stack.Empty(); --n)
+        {
+            const Node * p = stack.Back();
+            stack.PopBack();
+            if (p->IsAlive())
+                f(p->value_);
+            last = &p->value_.key_;
+            for (p = p->rchild_; p != nullptr; p = p->lchild_)
+                stack.PushBack(p);
+        }
+        return stack.Empty() ? nullptr : last;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::SwapTree (Map_ADT& other)
+    {
+        FSU_TRACE_SCOPE("Map::SwapTree");
+        MAP_CHECK(check_.Join(); other.check_.Join();)
+        Node * r = root_;
+        root_ = other.root_;
+        other.root_ = r;
+        NodeArena * a = arena_; //the nodes stay with the memory they live in
+        arena_ = other.arena_;
+        other.arena_ = a;
+        rehash_.Swap(other.rehash_);
+#ifdef MAP_ADT_DIGEST
+        bool stale = digestStale_;
+        digestStale_ = other.digestStale_;
+        other.digestStale_ = stale;
+        for (size_t i = 0; i < sizeof(lent_) / sizeof(lent_[0]); ++i) //the lent nodes go with their tree
+        {
+            std::swap(lent_[i], other.lent_[i]);
+            std::swap(lentOwn_[i], other.lentOwn_[i]);
+        }
+        std::swap(lentCount_, other.lentCount_);
+#endif
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Rebuilt ()
+    // the tree was just replaced by BuildTree()
+    {
+        if (filter_) FilterRebuild(2 * Size()); //drops the erased keys
+#ifdef MAP_ADT_CHECK
+        ++check_.operations;
+        MapCheckStats::Clock::time_point t0 = MapCheckStats::Clock::now();
+        bool ok = CheckRBLLTFast(0); //the whole tree is new: check all of it, now
+        check_.Book(ok, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(MapCheckStats::Clock::now() - t0).count());
+#endif
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class I >
+    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::BuildTree (I beg, size_t n) const
+    // the shortest LLRB that holds n: the least h = bh + reds with MaxNodes(bh, reds) >= n
+    {
+        if (n == 0)
+            return nullptr;
+        int top = 0; //the largest black height with 2^bh - 1 <= n
+        while (top < 63 && ((size_t)2 << top) - 1 <= n)
+            ++top;
+        for (int h = top; ; ++h) //ends by h = 2 top: MaxNodes(top, top) = 3^top - 1 >= n
+        {
+            for (int bh = top; bh >= h - bh; --bh)
+            {
+                if (MaxNodes(bh, h - bh) >= n)
+                    return RBuild(beg, n, bh, h - bh);
+            }
+        }
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class I >
+    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::RBuild (I& i, size_t n, int bh, int reds) const
+    // n entries from i, inorder, as an LLRB of black height bh with a black root and at
+    // most reds red nodes on any path; needs 2^bh - 1 <= n <= MaxNodes(bh, reds)
+    {
+        if (n == 0)
+            return nullptr;
+        Node * left;
+        size_t right;
+        if (n - 1 - (n - 1) / 2 <= MaxNodes(bh - 1, reds)) //a 2-node: halves of n - 1, the larger one on the right
+        {
+            left  = RBuild(i, (n - 1) / 2, bh - 1, reds);
+            right = n - 1 - (n - 1) / 2;
+        }
+        else //a 3-node: a black node and its red left child; thirds of n - 2, as far as the red side holds them
+        {
+            size_t cap = MaxNodes(bh - 1, reds - 1), third = (n - 2) / 3, extra = (n - 2) % 3;
+            size_t t1 = std::min(third + (extra > 0), cap), t2 = std::min(third + (extra > 1), cap);
+            Node * a = RBuild(i, t1, bh - 1, reds - 1);
+            left = NewNode((*i).key_, (*i).data_); //note, will use DEFAULT as flags argument (RED)
+            ++i;
+            left->lchild_ = a;
+            left->rchild_ = RBuild(i, t2, bh - 1, reds - 1);
+            MAP_DIGEST(left->sum_ += Sum(left->lchild_) + Sum(left->rchild_);)
+            right = n - 2 - t1 - t2;
+        }
+        Node * n0 = NewNode((*i).key_, (*i).data_, ZERO); //black, alive
+        ++i;
+        n0->lchild_ = left;
+        n0->rchild_ = RBuild(i, right, bh - 1, reds);
+        MAP_DIGEST(n0->sum_ += Sum(n0->lchild_) + Sum(n0->rchild_);)
+        return n0;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    size_t Map_ADT<K,D,P>::MaxNodes (int bh, int reds)
+    // most nodes in an LLRB of black height bh with at most reds red nodes on any path:
+    // M(0,r) = 0, M(b,0) = 2^b - 1, M(b,r) = max(1 + 2 M(b-1,r), 2 + 2 M(b-1,r-1) + M(b-1,r))
+    // (a 2-node, or a 3-node whose red node spends one red). Saturates at SIZE_MAX.
+    {
+        static const struct Table
+        {
+            size_t m[65][65];
+            Table ()
+            {
+                const size_t top = (size_t)-1;
+                auto add = [top](size_t x, size_t y) { return x > top - y ? top : x + y; };
+                for (int b = 0; b <= 64; ++b)
+                {
+                    for (int r = 0; r <= 64; ++r)
+                    {
+                        if (b == 0)
+                            m[b][r] = 0;
+                        else if (r == 0)
+                            m[b][r] = add(m[b-1][0], m[b-1][0] + 1);
+                        else
+                            m[b][r] = std::max(add(1, add(m[b-1][r], m[b-1][r])),
+                                               add(2, add(add(m[b-1][r-1], m[b-1][r-1]), m[b-1][r])));
+                    }
+                }
+            }
+        } table;
+        if (bh > 64) bh = 64;
+        if (reds > 64) reds = 64;
+        return table.m[bh][reds];
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::EnableFilter (size_t bitsPerKey)
+    {
+        static_assert(HasHashValue<K>::value, "Map_ADT::EnableFilter: no HashValue() for the key type");
+        FinishRehash();
+        if (filter_ == nullptr || filter_->BitsPerKey() != bitsPerKey)
+        {
+            delete filter_;
+            filter_ = new BloomFilter(0, bitsPerKey);
+        }
+        FilterRebuild(2 * Size());
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::DisableFilter ()
+    {
+        delete filter_;
+        filter_ = nullptr;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::FilterAdd (const K& k)
+    // k has just been made alive
+    {
+        if (filter_->Count() < filter_->Capacity())
+            filter_->Insert(KeyHash(k, Hashable()));
+        else
+            FilterRebuild(2 * Count()); //doubling: O(1) amortized per key
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::FilterRebuild (size_t capacity)
+    {
+        if (capacity < 1024) capacity = 1024;
+        filter_->Reset(capacity);
+        BloomFilter * f = filter_;
+        auto add = [f](const EntryType& e) { f->Insert(KeyHash(e.key_, Hashable())); };
+        RForEach<const EntryType>(root_, add);
+        for (size_t i = 0; i < rehash_.Size(); ++i) //the old tree's keys are still looked up
+        {
+            if (rehash_[i]->IsAlive()) add(rehash_[i]->value_);
+            RForEach<const EntryType>(rehash_[i]->rchild_, add);
+        }
     }
     
     
     template < typename K , typename D , class P >
-    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::RGet(Node* nptr, const K& kval, Node*& location)
+    template < class F >
+    void Map_ADT<K,D,P>::ParallelForEach (F f, size_t grain, ThreadPool* pool) const
+    {
+        FSU_TRACE_SCOPE("Map::ParallelForEach");
+        if (!rehash_.Empty()) //the two trees are walked together, in one thread
+        {
+            for (ConstIterator i = Begin(); i != End(); ++i)
+                f(*i);
+            return;
+        }
+        ThreadPool& tp = pool ? *pool : ThreadPool::Default();
+        if (tp.Concurrency() == 1)
+        {
+            RForEach<const EntryType>(root_, f);
+            return;
+        }
+        TaskGroup g(tp);
+        RParallelForEach<const EntryType>(root_, RBlackHeight(root_), f, grain, g);
+        g.Wait();
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class F >
+    void Map_ADT<K,D,P>::ParallelForEach (F f, size_t grain, ThreadPool* pool)
+    {
+        FSU_TRACE_SCOPE("Map::ParallelForEach");
+        FinishRehash();
+        MAP_DIGEST(digestStale_ = true;)
+        ThreadPool& tp = pool ? *pool : ThreadPool::Default();
+        if (tp.Concurrency() == 1)
+        {
+            RForEach<EntryType>(root_, f);
+            return;
+        }
+        TaskGroup g(tp);
+        RParallelForEach<EntryType>(root_, RBlackHeight(root_), f, grain, g);
+        g.Wait();
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < typename T , class M , class C >
+    T Map_ADT<K,D,P>::ParallelReduce (const T& identity, M map, C combine, size_t grain, ThreadPool* pool) const
+    {
+        FSU_TRACE_SCOPE("Map::ParallelReduce");
+        ThreadPool& tp = pool ? *pool : ThreadPool::Default();
+        if (tp.Concurrency() == 1 || !rehash_.Empty())
+        {
+            T acc = identity;
+            if (rehash_.Empty())
+                RFold(root_, acc, map, combine);
+            else //the two trees are walked together, in one thread
+                for (ConstIterator i = Begin(); i != End(); ++i)
+                    acc = combine(acc, map(*i));
+            return acc;
+        }
+        return RParallelReduce(root_, RBlackHeight(root_), identity, map, combine, grain, tp);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::RGet(Node* nptr, const K& kval, Node*& location, const D* assign)
     // recursive left-leaning get; returns node location of found value
     {
         if (nptr == 0) //add new node at "bottom" of tree
         {
-            location = NewNode(kval, D()); //note, will use DEFAULT as flags argument (RED and ALIVE)
+            location = NewNode(kval, assign ? *assign : D()); //note, will use DEFAULT as flags argument (RED and ALIVE)
+            MAP_DIGEST(pathDelta_ = location->sum_;)
             return location;
         }
-        if (pred_(kval,nptr->value_.key_)) //if kval < key_ in current node, go to left subtree
+        MAP_STAT(stats_.Visit();)
+        if (Less(kval,nptr->value_.key_)) //if kval < key_ in current node, go to left subtree
         {
-            nptr->lchild_ = RGet(nptr->lchild_,kval,location);
+            nptr->lchild_ = RGet(nptr->lchild_,kval,location,assign);
+            MAP_DIGEST(nptr->sum_ += pathDelta_;)
         }
-        else if (pred_(nptr->value_.key_,kval)) // if kval > key_ in current node, go to right subtree
+        else if (Less(nptr->value_.key_,kval)) // if kval > key_ in current node, go to right subtree
         {
-            nptr->rchild_ = RGet(nptr->rchild_,kval,location);
+            nptr->rchild_ = RGet(nptr->rchild_,kval,location,assign);
+            MAP_DIGEST(nptr->sum_ += pathDelta_;)
         }
-        else // the node exists and was found; set location only, don't update value
+        else // the node exists and was found; set location, and data only if assigning
         {
             location = nptr;
+            MAP_STAT(if (nptr->IsDead()) ++stats_.revivals;)
+            MAP_DIGEST(pathDelta_ = 0;)
+            MAP_DIGEST(bool revived = nptr->IsDead();)
+            MAP_DIGEST(uint64_t before = Own(nptr);) //0 if dead
+            if (assign)
+                nptr->value_.data_ = *assign;
             nptr -> SetAlive(); //set alive; Get will insert if data is not found, hence if any node
                                 //is found containing the data it should be set to alive.
+            MAP_DIGEST(if (assign || revived) pathDelta_ = Own(nptr) - before;)
+            MAP_DIGEST(nptr->sum_ += pathDelta_; if (pathDelta_) Relent(nptr, pathDelta_);)
         }
         
         
@@ -516,6 +1398,7 @@ namespace fsu
             nptr = RotateRight(nptr); //rotate right
         if (nptr->LeftChildIsRed() && nptr->RightChildIsRed()) //red node has to have only black children
         {   //swap parent/child colors
+            MAP_STAT(++stats_.colorFlips;)
             nptr->lchild_->SetBlack();
             nptr->rchild_->SetBlack();
             nptr->SetRed();
@@ -531,20 +1414,26 @@ namespace fsu
     {
         if (nptr == 0) //add new node at "bottom" of tree
         {
-            return NewNode(key, data); //note, will use DEFAULT as flags argument (RED)
+            Node * n = NewNode(key, data); //note, will use DEFAULT as flags argument (RED)
+            MAP_DIGEST(pathDelta_ = n->sum_;)
+            return n;
         }
-        if (pred_(key,nptr->value_.key_)) //if kval < key_ in current node, go to left subtree
+        if (Less(key,nptr->value_.key_)) //if kval < key_ in current node, go to left subtree
         {
             nptr->lchild_ = RInsert(nptr->lchild_,key,data);
+            MAP_DIGEST(nptr->sum_ += pathDelta_;)
         }
-        else if (pred_(nptr->value_.key_,key)) // if kval > key_ in current node, go to right subtree
+        else if (Less(nptr->value_.key_,key)) // if kval > key_ in current node, go to right subtree
         {
             nptr->rchild_ = RInsert(nptr->rchild_,key,data);
+            MAP_DIGEST(nptr->sum_ += pathDelta_;)
         }
         else // the node exists and was found; overwrite data
         {
+            MAP_DIGEST(uint64_t before = Own(nptr);)
             nptr->value_.data_ = data; //overright data at corresponding key; note key is constant and cannot be overwritten
             nptr->SetAlive(); //set Alive in case it is not already alive
+            MAP_DIGEST(pathDelta_ = Own(nptr) - before; nptr->sum_ += pathDelta_; Relent(nptr, pathDelta_);)
         }
         
         //repair the RBLL properties on the way up
@@ -554,6 +1443,7 @@ namespace fsu
             nptr = RotateRight(nptr); //rotate right
         if (nptr->LeftChildIsRed() && nptr->RightChildIsRed()) //red node has to have only black children
         {   //swap parent/child colors
+            MAP_STAT(++stats_.colorFlips;)
             nptr->lchild_->SetBlack();
             nptr->rchild_->SetBlack();
             nptr->SetRed();
@@ -565,23 +1455,38 @@ namespace fsu
     // proper type
     
     template < typename K , typename D , class P >
-    Map_ADT<K,D,P>::Map_ADT  () : root_(nullptr), pred_()
-    {}
+    Map_ADT<K,D,P>::Map_ADT  () : root_(nullptr), pred_(), filter_(nullptr), stepUs_(20), arena_(nullptr)
+    {
+        MAP_DIGEST(digestStale_ = false; lentCount_ = 0;)
+    }
     
     template < typename K , typename D , class P >
-    Map_ADT<K,D,P>::Map_ADT  (P p) : root_(nullptr), pred_(p)
-    {}
+    Map_ADT<K,D,P>::Map_ADT  (P p) : root_(nullptr), pred_(p), filter_(nullptr), stepUs_(20), arena_(nullptr)
+    {
+        MAP_DIGEST(digestStale_ = false; lentCount_ = 0;)
+    }
     
     template < typename K , typename D , class P >
     Map_ADT<K,D,P>::~Map_ADT ()
     {
         Clear();
+        delete filter_;
+        delete arena_;
     }
     
     template < typename K , typename D , class P >
-    Map_ADT<K,D,P>::Map_ADT( const Map_ADT& tree ) : root_(nullptr), pred_(tree.pred_)
+    Map_ADT<K,D,P>::Map_ADT( const Map_ADT& tree ) : root_(nullptr), pred_(tree.pred_), filter_(nullptr), stepUs_(tree.stepUs_), arena_(nullptr)
     {
-        root_ = RClone(tree.root_);
+        if (tree.arena_) arena_ = new NodeArena(sizeof(Node), alignof(Node), tree.arena_->HugePages());
+        MAP_DIGEST(digestStale_ = tree.digestStale_ || tree.lentCount_ > 0; lentCount_ = 0;) //the copied sums miss the lent writes
+        if (tree.rehash_.Empty())
+            root_ = RClone(tree.root_);
+        else //a rehashing tree is copied as Rehash() would leave it
+        {
+            root_ = BuildTree(tree.Begin(), tree.Size());
+            MAP_DIGEST(digestStale_ = false;)
+        }
+        if (tree.filter_) filter_ = new BloomFilter(*tree.filter_);
     }
     
     template < typename K , typename D , class P >
@@ -590,7 +1495,19 @@ namespace fsu
         if (this != &that)
         {
             Clear();
-            this->root_ = RClone(that.root_);
+            delete arena_; //a copy gets an arena of its own, as in the copy constructor
+            arena_ = that.arena_ ? new NodeArena(sizeof(Node), alignof(Node), that.arena_->HugePages()) : nullptr;
+            stepUs_ = that.stepUs_;
+            MAP_DIGEST(digestStale_ = that.digestStale_ || that.lentCount_ > 0;)
+            if (that.rehash_.Empty())
+                this->root_ = RClone(that.root_);
+            else
+            {
+                this->root_ = BuildTree(that.Begin(), that.Size());
+                MAP_DIGEST(digestStale_ = false;)
+            }
+            delete filter_;
+            filter_ = that.filter_ ? new BloomFilter(*that.filter_) : nullptr;
         }
         return *this;
     }
@@ -605,7 +1522,9 @@ namespace fsu
             std::cerr << " ** RotateLeft called with black right child\n";
             return n;
         }
+        MAP_STAT(++stats_.rotations;)
         Node * p = n->rchild_;
+        MAP_DIGEST(uint64_t total = n->sum_; n->sum_ -= p->sum_ - Sum(p->lchild_); p->sum_ = total;)
         n->rchild_ = p->lchild_;
         p->lchild_ = n;
         
@@ -624,7 +1543,9 @@ namespace fsu
             return n;
         }
         
+        MAP_STAT(++stats_.rotations;)
         Node * p = n->lchild_;
+        MAP_DIGEST(uint64_t total = n->sum_; n->sum_ -= p->sum_ - Sum(p->rchild_); p->sum_ = total;)
         n->lchild_ = p->rchild_;
         p->rchild_ = n;
         
@@ -649,6 +1570,334 @@ namespace fsu
         return 1 + RNumNodes(n->lchild_) + RNumNodes(n->rchild_);
     }
     
+    template < typename K , typename D , class P >
+    size_t Map_ADT<K,D,P>::RMemory(Node * n)
+    {
+        if (n == nullptr) return 0;
+        return sizeof(Node) + HeapUsage(n->value_.key_) + HeapUsage(n->value_.data_)
+             + RMemory(n->lchild_) + RMemory(n->rchild_);
+    }
+    
+    template < typename K , typename D , class P >
+    int Map_ADT<K,D,P>::RBlackHeight(Node * n)
+    // black nodes on the leftmost path; in a red-black tree every path has as many
+    {
+        int bh = 0;
+        for ( ; n != nullptr; n = n->lchild_)
+            if (n->IsBlack()) ++bh;
+        return bh;
+    }
+    
+    template < typename K , typename D , class P >
+    template < class E , class F >
+    void Map_ADT<K,D,P>::RForEach(Node * n, F& f)
+    // inorder over live entries; loops down right spines, recurses left
+    {
+        while (n != nullptr)
+        {
+            RForEach<E>(n->lchild_, f);
+            if (n->IsAlive())
+                f(static_cast<E&>(n->value_));
+            n = n->rchild_;
+        }
+    }
+    
+    template < typename K , typename D , class P >
+    template < class E , class F >
+    void Map_ADT<K,D,P>::RParallelForEach(Node * n, int bh, const F& f, size_t grain, TaskGroup& g)
+    // left subtrees become tasks of g; this thread continues down the right spine
+    {
+        F local(f);
+        while (n != nullptr && Splittable(bh, grain))
+        {
+            if (n->IsBlack()) --bh; // both children have the same black height
+            Node * l = n->lchild_;
+            int lbh = bh;
+            g.Run([l, lbh, &f, grain, &g]() { RParallelForEach<E>(l, lbh, f, grain, g); });
+            if (n->IsAlive())
+                local(static_cast<E&>(n->value_));
+            n = n->rchild_;
+        }
+        RForEach<E>(n, local);
+    }
+    
+    template < typename K , typename D , class P >
+    template < typename T , class M , class C >
+    void Map_ADT<K,D,P>::RFold(Node * n, T& acc, const M& map, const C& combine)
+    {
+        while (n != nullptr)
+        {
+            RFold(n->lchild_, acc, map, combine);
+            if (n->IsAlive())
+                acc = combine(acc, map(static_cast<const EntryType&>(n->value_)));
+            n = n->rchild_;
+        }
+    }
+    
+    template < typename K , typename D , class P >
+    template < typename T , class M , class C >
+    T Map_ADT<K,D,P>::RParallelReduce(Node * n, int bh, const T& identity, const M& map, const C& combine,
+                                      size_t grain, ThreadPool& pool)
+    // (left) node (right): left on a task, right here, joined in key order
+    {
+        if (n == nullptr || !Splittable(bh, grain))
+        {
+            T acc = identity;
+            RFold(n, acc, map, combine);
+            return acc;
+        }
+        if (n->IsBlack()) --bh;
+        Node * l = n->lchild_;
+        T left = identity;
+        TaskGroup g(pool);
+        g.Run([&]() { left = RParallelReduce(l, bh, identity, map, combine, grain, pool); });
+        T right = RParallelReduce(n->rchild_, bh, identity, map, combine, grain, pool);
+        g.Wait();
+        if (n->IsAlive())
+            left = combine(left, map(static_cast<const EntryType&>(n->value_)));
+        return combine(left, right);
+    }
+    
+#ifdef MAP_ADT_DIGEST
+    template < typename K , typename D , class P >
+    uint64_t Map_ADT<K,D,P>::RangeDigest (const KeyType& lo, const KeyType& hi) const
+    // digest of the live entries with lo <= key < hi
+    {
+        if (!Less(lo,hi))
+            return 0;
+        return Prefix(hi,false) - Prefix(lo,false) + OldSum(&lo, &hi);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class F >
+    size_t Map_ADT<K,D,P>::Diff (const Map_ADT& other, F f) const
+    {
+        FSU_TRACE_SCOPE("Map::Diff");
+        size_t d = 0;
+        if (!rehash_.Empty() || !other.rehash_.Empty()) //no subtree sums span both trees: merge
+        {
+            ConstIterator i = Begin(), j = other.Begin();
+            while (i.Valid() || j.Valid())
+            {
+                const K* key;
+                bool differ = 1;
+                if (!j.Valid() || (i.Valid() && Less((*i).key_, (*j).key_)))
+                {
+                    key = &(*i).key_;
+                    ++i;
+                }
+                else if (!i.Valid() || Less((*j).key_, (*i).key_))
+                {
+                    key = &(*j).key_;
+                    ++j;
+                }
+                else
+                {
+                    key = &(*i).key_;
+                    differ = !((*i).data_ == (*j).data_);
+                    ++i;
+                    ++j;
+                }
+                if (differ)
+                {
+                    f(*key);
+                    ++d;
+                }
+            }
+            return d;
+        }
+        Refresh();
+        other.Refresh();
+        RDiff(root_, nullptr, nullptr, other, f, d);
+        return d;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    uint64_t Map_ADT<K,D,P>::OldSum(const K* lo, const K* hi) const
+    // the old tree's sums went stale with it, and its entries may be hidden: one by one
+    {
+        uint64_t acc = 0;
+        if (rehash_.Empty())
+            return acc;
+        const Map_ADT * m = this;
+        auto add = [&acc, m, lo, hi](const EntryType& e)
+        {
+            if ((lo == nullptr || !m->Less(e.key_, *lo)) && (hi == nullptr || m->Less(e.key_, *hi))
+                && m->Seek(m->root_, e.key_) == nullptr)
+                acc += EntryDigest(e.key_, e.data_);
+        };
+        for (size_t i = 0; i < rehash_.Size(); ++i)
+        {
+            if (rehash_[i]->IsAlive()) add(rehash_[i]->value_);
+            RForEach<const EntryType>(rehash_[i]->rchild_, add);
+        }
+        return acc;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    uint64_t Map_ADT<K,D,P>::RResum(Node * n)
+    // recomputes every subtree sum below n, in O(size)
+    {
+        if (n == nullptr) return 0;
+        n->sum_ = Own(n) + RResum(n->lchild_) + RResum(n->rchild_);
+        return n->sum_;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Lend(const Node* n) const
+    // the sums keep n's term as it is now until Repay(); a full list gives up on it
+    {
+        if (digestStale_)
+            return;
+        for (size_t i = 0; i < lentCount_; ++i)
+        {
+            if (lent_[i] == n)
+                return;
+        }
+        if (lentCount_ == sizeof(lent_) / sizeof(lent_[0]))
+        {
+            digestStale_ = true;
+            lentCount_ = 0;
+            return;
+        }
+        lent_[lentCount_] = n;
+        lentOwn_[lentCount_++] = Own(n);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Relent(const Node* n, uint64_t delta) const
+    {
+        for (size_t i = 0; i < lentCount_; ++i)
+        {
+            if (lent_[i] == n)
+                lentOwn_[i] += delta;
+        }
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Repay() const
+    // rotations move subtree sums as they are, so each lent node's old term is
+    // still on its path from the root, in O(log n)
+    {
+        for (size_t i = 0; i < lentCount_; ++i)
+        {
+            const Node * n = lent_[i];
+            uint64_t delta = Own(n) - lentOwn_[i];
+            if (delta == 0)
+                continue;
+            for (Node * a = root_; ; a = Less(n->value_.key_, a->value_.key_) ? a->lchild_ : a->rchild_)
+            {
+                a->sum_ += delta;
+                if (a == n)
+                    break;
+            }
+        }
+        lentCount_ = 0;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    uint64_t Map_ADT<K,D,P>::Prefix(const K& k, bool inclusive) const
+    // one root-leaf path: whenever the path goes right, the node and its
+    // left subtree are all below k
+    {
+        Refresh();
+        uint64_t acc = 0;
+        Node * n = root_;
+        while (n != nullptr)
+        {
+            if (inclusive ? !Less(k,n->value_.key_) : Less(n->value_.key_,k))
+            {
+                acc += n->sum_ - Sum(n->rchild_);
+                n = n->rchild_;
+            }
+            else
+                n = n->lchild_;
+        }
+        return acc;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    uint64_t Map_ADT<K,D,P>::Between(const K* lo, const K* hi) const
+    {
+        Refresh();
+        uint64_t upper = hi ? Prefix(*hi,false) : Sum(root_);
+        uint64_t lower = lo ? Prefix(*lo,true) : 0;
+        return upper - lower;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    const typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::Find(const K& k) const
+    {
+        const Node * n = root_;
+        while (n != nullptr)
+        {
+            if (Less(k,n->value_.key_))
+                n = n->lchild_;
+            else if (Less(n->value_.key_,k))
+                n = n->rchild_;
+            else
+                break;
+        }
+        return n;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class F >
+    void Map_ADT<K,D,P>::RDiff(const Node * n, const K* lo, const K* hi, const Map_ADT& other, F& f, size_t& d) const
+    // n is the subtree of this map holding its keys in (lo,hi); skip it when
+    // the other map's entries in (lo,hi) have the same digest
+    {
+        if (n == nullptr)
+        {
+            other.RForRange(other.root_, lo, hi, f, d);
+            return;
+        }
+        if (n->sum_ == other.Between(lo,hi))
+            return;
+        const K& key = n->value_.key_;
+        RDiff(n->lchild_, lo, &key, other, f, d);
+        const Node * o = other.Find(key);
+        bool mine = n->IsAlive(), theirs = o != nullptr && o->IsAlive();
+        if (mine != theirs || (mine && !(n->value_.data_ == o->value_.data_)))
+        {
+            f(key);
+            ++d;
+        }
+        RDiff(n->rchild_, &key, hi, other, f, d);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    template < class F >
+    void Map_ADT<K,D,P>::RForRange(const Node * n, const K* lo, const K* hi, F& f, size_t& d) const
+    // calls f on the live keys in (lo,hi), in order
+    {
+        if (n == nullptr) return;
+        const K& key = n->value_.key_;
+        bool above = lo == nullptr || Less(*lo,key);
+        bool below = hi == nullptr || Less(key,*hi);
+        if (above)
+            RForRange(n->lchild_, lo, hi, f, d);
+        if (above && below && n->IsAlive())
+        {
+            f(key);
+            ++d;
+        }
+        if (below)
+            RForRange(n->rchild_, lo, hi, f, d);
+    }
+#endif
+    
     template < typename K , typename D , class P >
     int Map_ADT<K,D,P>::RHeight(Node * n)
     {
@@ -669,13 +1918,13 @@ namespace fsu
             if (n->lchild_ != nullptr)
             {
                 Map_ADT<K,D,P>::RRelease(n->lchild_);
-                delete n->lchild_;
+                FreeNode(n->lchild_);
                 n->lchild_ = nullptr;
             }
             if (n->rchild_ != nullptr)
             {
                 Map_ADT<K,D,P>::RRelease(n->rchild_);
-                delete n->rchild_;
+                FreeNode(n->rchild_);
                 n->rchild_ = nullptr;
             }
         }
@@ -683,24 +1932,34 @@ namespace fsu
     
     
     template < typename K , typename D , class P >
-    typename Map_ADT<K,D,P>::Node* Map_ADT<K,D,P>::RClone(const Map_ADT<K,D,P>::Node* n)
+    typename Map_ADT<K,D,P>::Node* Map_ADT<K,D,P>::RClone(const Map_ADT<K,D,P>::Node* n) const
     // returns a pointer to a deep copy of n
     {
         if (n == nullptr)
             return 0;
         typename Map_ADT<K,D,P>::Node* newN = NewNode (n->value_.key_,n->value_.data_);
         newN->flags_ = n->flags_;
-        newN->lchild_ = Map_ADT<K,D,P>::RClone(n->lchild_);
-        newN->rchild_ = Map_ADT<K,D,P>::RClone(n->rchild_);
+        MAP_DIGEST(newN->sum_ = n->sum_;)
+        newN->lchild_ = RClone(n->lchild_);
+        newN->rchild_ = RClone(n->rchild_);
         return newN;
     } // end Map_ADT<K,D,P>::RClone() */
     
     
     // private node allocator
     template < typename K , typename D , class P >
-    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::NewNode(const K& k, const D& d, Flags flags)
+    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::NewNode(const K& k, const D& d, Flags flags) const
     {
-        Node * nPtr = new(std::nothrow) Node(k,d,flags);
+        MAP_STAT(++stats_.allocations;)
+        Node * nPtr;
+        if (arena_)
+        {
+            void * block = arena_->Allocate();
+            nPtr = block ? new(block) Node(k,d,flags) : nullptr;
+        }
+        else
+            nPtr = new(std::nothrow) Node(k,d,flags);
+        MAP_DIGEST(if (nPtr) nPtr->sum_ = Own(nPtr);)
         if (nPtr == nullptr)
         {
             std::cerr << "** Map_ADT memory allocation failure\n";
@@ -709,6 +1968,151 @@ namespace fsu
         return nPtr;
     }
     
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::FreeNode(Node* n) const
+    {
+        if (n == nullptr)
+            return;
+        if (arena_)
+        {
+            n->~Node();
+            arena_->Free(n);
+        }
+        else
+            delete n;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Relocate(NodeArena* a, Layout order)
+    // the new tree is made in a's memory, its nodes allocated in the given order,
+    // and the old one freed to the old arena. The copies keep flags and digests:
+    // the shape and the sums stay.
+    {
+        MAP_DIGEST(Repay();) //the lent nodes are about to be freed
+        NodeArena * old = arena_;
+        Node * oldRoot = root_;
+        arena_ = a;
+        switch (order)
+        {
+            case LEVELORDER:
+            {
+                Queue < Slot , Deque < Slot > > que;
+                Slot top = { oldRoot, &root_ };
+                if (oldRoot) que.Push(top);
+                while (!que.Empty())
+                {
+                    Slot s = que.Front();
+                    que.Pop();
+                    Node * c = CopyNode(s.old);
+                    *s.link = c;
+                    if (s.old->lchild_) { Slot l = { s.old->lchild_, &c->lchild_ }; que.Push(l); }
+                    if (s.old->rchild_) { Slot r = { s.old->rchild_, &c->rchild_ }; que.Push(r); }
+                }
+                if (oldRoot == nullptr) root_ = nullptr;
+                break;
+            }
+            case VEB:
+            {
+                fsu::Vector < Slot > fringe; //stays empty: the first call spans every level
+                RVebCopy(oldRoot, &root_, RHeight(oldRoot) + 1, fringe);
+                break;
+            }
+            case INORDER:
+                root_ = RInorderCopy(oldRoot);
+                break;
+            default:
+                root_ = RClone(oldRoot);
+        }
+        arena_ = old;
+        RRelease(oldRoot);
+        FreeNode(oldRoot);
+        delete old;
+        arena_ = a;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::CopyNode(const Node* n) const
+    {
+        Node * c = NewNode(n->value_.key_, n->value_.data_);
+        c->flags_ = n->flags_;
+        MAP_DIGEST(c->sum_ = n->sum_;)
+        return c;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    typename Map_ADT<K,D,P>::Node * Map_ADT<K,D,P>::RInorderCopy(const Node* n) const
+    {
+        if (n == nullptr)
+            return nullptr;
+        Node * l = RInorderCopy(n->lchild_);
+        Node * c = CopyNode(n);
+        c->lchild_ = l;
+        c->rchild_ = RInorderCopy(n->rchild_);
+        return c;
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::RVebCopy(const Node* n, Node** link, int levels, fsu::Vector < Slot >& fringe) const
+    // copies the top levels of the subtree at n, in van Emde Boas order, to *link; the
+    // children just below them are added to fringe, with the links their copies go to
+    {
+        if (n == nullptr)
+        {
+            *link = nullptr;
+            return;
+        }
+        if (levels == 1)
+        {
+            Node * c = CopyNode(n);
+            *link = c;
+            if (n->lchild_) { Slot l = { n->lchild_, &c->lchild_ }; fringe.PushBack(l); }
+            if (n->rchild_) { Slot r = { n->rchild_, &c->rchild_ }; fringe.PushBack(r); }
+            return;
+        }
+        int top = levels / 2;
+        fsu::Vector < Slot > middle;
+        RVebCopy(n, link, top, middle);
+        for (size_t i = 0; i < middle.Size(); ++i)
+            RVebCopy(middle[i].old, middle[i].link, levels - top, fringe);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::Relayout(Layout order)
+    {
+        FSU_TRACE_SCOPE("Map::Relayout");
+        FinishRehash();
+        MAP_CHECK(check_.Join();)
+        Relocate(new NodeArena(sizeof(Node), alignof(Node), arena_ ? arena_->HugePages() : true), order);
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::EnableArena(bool hugePages)
+    {
+        FSU_TRACE_SCOPE("Map::EnableArena");
+        FinishRehash();
+        MAP_CHECK(check_.Join();)
+        if (arena_ && arena_->HugePages() == hugePages)
+            return;
+        Relocate(new NodeArena(sizeof(Node), alignof(Node), hugePages));
+    }
+    
+    
+    template < typename K , typename D , class P >
+    void Map_ADT<K,D,P>::DisableArena()
+    {
+        FSU_TRACE_SCOPE("Map::DisableArena");
+        FinishRehash();
+        MAP_CHECK(check_.Join();)
+        if (arena_)
+            Relocate(nullptr);
+    }
+    
     // development assistants
     
     template < typename K , typename D , class P >
@@ -718,6 +2122,7 @@ namespace fsu
         // This is the same as "Dump(1)" except it uses a character map instead of a
         // color map for the display: B/b = black_alive/black_dead, R/r = red_alive/red_dead
         
+        DumpRehash(os);
         if (root_ == nullptr)
             return;
         
@@ -809,6 +2214,7 @@ namespace fsu
         // to use the root of a non-empty tree as the fill. To make that work, we have
         // to take care of the real root case before entering the main loop.
         
+        DumpRehash(os);
         if (root_ == nullptr)
             return;
         
@@ -895,6 +2301,7 @@ namespace fsu
     void Map_ADT<K,D,P>::Dump (std::ostream& os, int kw) const
     {
         // fsu::debug ("Dump(2)");
+        DumpRehash(os);
         if (root_ == nullptr)
             return;
         Queue < Node * , Deque < Node * > > Que;
@@ -934,6 +2341,7 @@ namespace fsu
     void Map_ADT<K,D,P>::Dump (std::ostream& os, int kw, char fill) const
     {
         // fsu::debug ("Dump(3)");
+        DumpRehash(os);
         if (root_ == nullptr)
             return;
         
@@ -986,7 +2394,7 @@ namespace fsu
             k *= 2;
         } // end while
         Que.Clear();
-        delete fillNode;
+        FreeNode(fillNode);
     } // Dump(os, kw, fill) */
     
 #include <map_tools.cpp> //slave file, logically included
@@ -0,0 +1,197 @@
+/*
+    map_check.h
+    10/18/26
+
+    Online invariant checking for Map_ADT
+
+    A compile-time switch, like map_stats.h: build with -DMAP_ADT_CHECK and
+    every Map_ADT checks itself while it is used. Without the switch the
+    MAP_CHECK(...) hooks expand to nothing.
+
+    path checks   After each Get, Put and Erase, the path from the root to
+                  the key is re-walked, then continued down the left spine
+                  to a null. Each node on it must lie between the keys of
+                  its ancestors, must not have a red right child, and if red
+                  must not have a red left child. The walk ends by comparing
+                  its black count with the leftmost path's. This is O(log n)
+                  with no allocation, about the cost of one more lookup.
+
+    full checks   Every Nth mutating call (SetCheckInterval(N), default
+                  1024) starts CheckRBLLTFast on ThreadPool::Default(), in
+                  the background. The next call that changes the tree waits
+                  for it first, so the check always sees a tree at rest.
+                  If no worker has taken the check yet, that call runs it
+                  itself; otherwise it sleeps until the check is done. It
+                  never runs other queued tasks of the pool. Const
+                  operations keep running meanwhile. Rehash() checks the
+                  whole new tree at once.
+
+    budget        SetCheckBudget(f) caps the share of wall time spent in full
+                  checks. A full check that took t blocks the next one for
+                  t / f, and intervals that fall inside that window are
+                  counted as skipped. f = 0 turns the cap off. Default 0.05.
+
+    A failed check writes a line to std::cerr, and CheckStats().failures
+    counts it. The map keeps working: the checker only reads.
+
+    counters (CheckStats())
+    --------
+
+    operations   mutating calls seen
+    pathChecks   path checks run
+    fullChecks   full checks completed
+    fullSkipped  full checks skipped to stay within the budget
+    failures     checks of either kind that found a violation
+    fullNs       total time spent in full checks
+*/
+
+#ifndef _MAP_CHECK_H
+#define _MAP_CHECK_H
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include <threadpool.h>
+
+#ifdef MAP_ADT_CHECK
+  #define MAP_CHECK(x) x
+#else
+  #define MAP_CHECK(x)
+#endif
+
+namespace fsu
+{
+
+  struct MapCheckStats
+  {
+    typedef std::chrono::steady_clock Clock;
+
+    // knobs
+    size_t   every;
+    double   budget;
+    // counters
+    size_t   operations, pathChecks, fullChecks, fullSkipped, failures;
+    uint64_t fullNs;
+
+    MapCheckStats () : every(1024), budget(0.05) { Reset(); }
+
+    // a copy keeps the knobs; its counters and background check start fresh
+    MapCheckStats (const MapCheckStats& s) : every(s.every), budget(s.budget) { Reset(); }
+
+    MapCheckStats& operator = (const MapCheckStats& s)
+    {
+      every  = s.every;
+      budget = s.budget;
+      return *this;
+    }
+
+    ~MapCheckStats () { Join(); }
+
+    void Reset ()
+    {
+      operations = pathChecks = fullChecks = fullSkipped = failures = 0;
+      fullNs = 0;
+      next_ = Clock::now();
+    }
+
+    void Dump (std::ostream& os) const
+    {
+      os << "  mutating operations = " << operations  << '\n'
+         << "  path checks         = " << pathChecks  << '\n'
+         << "  full checks         = " << fullChecks  << " (" << fullSkipped << " skipped for budget)\n"
+         << "  full check time     = " << fullNs / 1000 << " us\n"
+         << "  failures            = " << failures    << '\n';
+    }
+
+    // true if a full check is due now; counts a skip when the budget says wait
+    bool FullDue ()
+    {
+      if (every == 0 || operations % every != 0)
+        return 0;
+      if (budget > 0 && Clock::now() < next_)
+      {
+        ++fullSkipped;
+        return 0;
+      }
+      return 1;
+    }
+
+    // runs check() (returns bool) on the default pool
+    template < class F >
+    void Start (F check)
+    {
+      Join();
+      std::shared_ptr<Pending> p(new Pending(check));
+      task_ = p;
+      ThreadPool::Default().Submit([p]() { p->Claim(); }); //a no-op if Join() got there first
+    }
+
+    // waits for a background check, if one is running, and books its result
+    void Join ()
+    {
+      if (!task_)
+        return;
+      if (!task_->Claim()) //a worker has it: wait for this check only
+      {
+        std::unique_lock<std::mutex> lock(task_->mutex);
+        task_->done.wait(lock, [this]{ return task_->state == Pending::DONE; });
+      }
+      Book(task_->ok, task_->ns);
+      task_.reset();
+    }
+
+    void Book (bool ok, uint64_t ns)
+    {
+      ++fullChecks;
+      fullNs += ns;
+      if (!ok) ++failures;
+      if (budget > 0)
+        next_ = Clock::now() + std::chrono::nanoseconds((uint64_t)(ns / budget));
+    }
+
+  private:
+    // one background check, shared with the pool task that may run it
+    struct Pending
+    {
+      enum { QUEUED, RUNNING, DONE };
+      std::function<bool()>   check;
+      std::atomic<int>        state;
+      bool                    ok;
+      uint64_t                ns;
+      std::mutex              mutex;
+      std::condition_variable done;
+
+      explicit Pending (const std::function<bool()>& f) : check(f), state(QUEUED), ok(1), ns(0) {}
+
+      // runs the check on this thread unless another thread took it first
+      bool Claim ()
+      {
+        int queued = QUEUED;
+        if (!state.compare_exchange_strong(queued, RUNNING))
+          return 0;
+        Clock::time_point t0 = Clock::now();
+        ok = check();
+        ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        check = nullptr;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          state = DONE;
+        }
+        done.notify_all();
+        return 1;
+      }
+    } ;
+
+    std::shared_ptr<Pending> task_;
+    Clock::time_point        next_;
+  } ;
+
+} // namespace fsu
+
+#endif
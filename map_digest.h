@@ -0,0 +1,77 @@
+/*
+    map_digest.h
+    10/18/26
+
+    Content digests for Map_ADT
+
+    The digest is a compile-time switch, like map_stats.h: build with
+    -DMAP_ADT_DIGEST. Each node then also holds the digest of its
+    subtree, and Map_ADT gains these members:
+
+      Digest      ()            O(1)      hash of the live entries, independent of
+                                          tree shape and insertion order
+      RangeDigest (lo, hi)      O(log n)  the same over live entries lo <= key < hi
+      Diff        (other, f)    O(d log^2 n)  calls f(key) once for each of the d
+                                          keys whose live entries differ (present in
+                                          one map only, or with unequal data_);
+                                          returns d
+      DigestFresh ()            O(1)      false if the digest must be recomputed
+
+    The digest of a set of entries is the sum, mod 2^64, of EntryDigest(key,
+    data) over the live entries. A sum does not depend on order, and it
+    can be updated in O(1): Put, Insert and Erase add or subtract one term
+    at each node on their path, and rotations move subtree sums without
+    rehashing. CheckDigest(verbose) (map_tools.cpp) recomputes every
+    subtree sum and compares. Equal maps have equal digests. Unequal
+    maps collide with probability about 2^-64.
+
+    Writes made through references are invisible to the digest until it
+    looks. Get() and operator[] lend out one entry, and so does each
+    entry read through the iterator of a non-const Includes(). The map
+    keeps the last 8 lent entries, with the digest term each had when
+    lent. The next Digest(), RangeDigest() or Diff() replaces those terms
+    along each entry's root path, in O(log n) apiece. A ninth entry, a
+    non-const Begin() or rBegin(), or the non-const ParallelForEach()
+    marks the digest stale instead, and the next query recomputes every
+    subtree sum once, in O(n). Put() does not return a reference, so a
+    map updated only through Put/Insert/Erase stays fresh. operator ==
+    uses the digests only when both are fresh: unequal digests then
+    answer "not equal" in O(1).
+
+    Diff() does not need the two maps to have the same shape. It walks
+    this map's tree and compares each subtree's digest with the other
+    map's RangeDigest over the same key interval. Only the intervals
+    whose digests differ are entered. While either map is in an incremental
+    rehash, its entries are split between two trees, and Diff() walks both
+    maps side by side instead, in O(n). Digest() and RangeDigest() then add
+    the old tree's entries one by one.
+
+    Key and data types need a HashValue() overload (hashval.h: arithmetic
+    types; xstring.h: String).
+*/
+
+#ifndef _MAP_DIGEST_H
+#define _MAP_DIGEST_H
+
+#include <cstdint>
+#include <hashval.h>
+
+#ifdef MAP_ADT_DIGEST
+  #define MAP_DIGEST(x) x
+#else
+  #define MAP_DIGEST(x)
+#endif
+
+namespace fsu
+{
+
+  // one live entry's term in the digest sum
+  template < typename K , typename D >
+  uint64_t EntryDigest (const K& k, const D& d)
+  {
+    return HashMix(HashValue(k) ^ (HashMix(HashValue(d)) * 0x9E3779B97F4A7C15ULL));
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,93 @@
+/*
+    map_stats.h
+    10/18/26
+
+    Operation counters for Map_ADT (and its iterators)
+
+    Instrumentation is a compile-time switch: build with -DMAP_ADT_STATS and
+    every Map_ADT object carries a MapStats record, reachable through
+    Map_ADT::Stats() and cleared with Map_ADT::ResetStats(). Without the
+    switch the MAP_STAT(...) hooks expand to nothing and neither the maps nor
+    their iterators change size, so uninstrumented builds pay nothing.
+
+    counters
+    --------
+
+    comparisons  calls to the order predicate
+    rotations    RotateLeft + RotateRight
+    colorFlips   4-node splits on the way up an insertion path
+    allocations  nodes created (inserts, copies, rehash)
+    revivals     tombstones brought back to life by Get/Put
+    deadSkips    tombstones stepped over by ++/-- and Begin() in iterators
+    filterRejects  Includes/Retrieve answered by the Bloom filter, no descent
+    operations   descents recorded (Get/Put, Retrieve/Includes, Erase)
+    pathTotal    nodes visited by those descents
+    pathMax      longest single descent
+*/
+
+#ifndef _MAP_STATS_H
+#define _MAP_STATS_H
+
+#include <cstddef>   // size_t
+#include <iostream>
+#include <iomanip>
+
+#ifdef MAP_ADT_STATS
+  #define MAP_STAT(x) x
+#else
+  #define MAP_STAT(x)
+#endif
+
+namespace fsu
+{
+
+  struct MapStats
+  {
+    size_t comparisons, rotations, colorFlips, allocations, revivals, deadSkips, filterRejects;
+    size_t operations, pathTotal, pathMax;
+
+    MapStats () { Reset(); }
+
+    void Reset ()
+    {
+      comparisons = rotations = colorFlips = allocations = revivals = deadSkips = filterRejects = 0;
+      operations = pathTotal = pathMax = pathCurrent_ = 0;
+    }
+
+    // called once per node visited during a descent, then once at the end of it
+    void Visit   () { ++pathCurrent_; }
+    void EndPath ()
+    {
+      ++operations;
+      pathTotal += pathCurrent_;
+      if (pathMax < pathCurrent_) pathMax = pathCurrent_;
+      pathCurrent_ = 0;
+    }
+
+    double AvgPath () const { return operations ? double(pathTotal) / operations : 0.0; }
+
+    void Dump (std::ostream& os) const
+    {
+      std::ios::fmtflags flags = os.flags();
+      std::streamsize    precision = os.precision();
+      os << "  comparisons         = " << comparisons << '\n'
+         << "  rotations           = " << rotations   << '\n'
+         << "  color flips         = " << colorFlips  << '\n'
+         << "  node allocations    = " << allocations << '\n'
+         << "  tombstone revivals  = " << revivals    << '\n'
+         << "  dead-node skips     = " << deadSkips   << '\n'
+         << "  filter rejects      = " << filterRejects << '\n'
+         << "  descents            = " << operations  << '\n'
+         << "  avg / max path      = " << std::fixed << std::setprecision(2) << AvgPath()
+         << " / " << pathMax << '\n';
+      os.flags(flags);
+      os.precision(precision);
+    }
+
+  private:
+    size_t pathCurrent_;
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,367 @@
+/*
+    maplog.h
+    10/18/26
+
+    Recording the operations made on a map, and reading them back
+
+    classes defined in this file
+    ----------------------------
+
+    MapRecorder < M >   M with every Put, Get, Erase, Retrieve, Includes,
+                        Rehash and Clear appended to a binary log
+    MapLogReader        reads a log, one operation at a time
+
+    MapRecorder derives from the map type M (a Map_ADT, usually) and
+    shadows the recorded calls. Everything else, iterators and Dump()
+    included, is M's own. A recorder with no log open is M plus one test
+    per call.
+
+      Record        (path)   starts a new log at path; false if it cannot
+                             be opened
+      StopRecording ()       flushes and closes the log
+      Recording     ()       true while a log is open
+      Logged        ()       operations written to the current log
+
+    operator [] and Insert() are logged as the Get and Put they are, and
+    StartRehash() as a Rehash: the map then holds what Rehash() would leave.
+    A successful Build() is logged as Clear followed by one Put per entry.
+    A copy of a recorder does not record.
+
+    log format
+    ----------
+
+    A 16-byte header, then one record per operation, with no padding:
+
+      header   "FSUMAPLG", version (1), key type, data type, 5 zero bytes
+      record   op code (1 byte), then the key, except for Rehash and
+               Clear, then the data, for Put only
+
+    Type codes and encodings:
+
+      0x11..0x18   signed integer of 1..8 bytes      zigzag LEB128 varint
+      0x21..0x28   unsigned integer of 1..8 bytes    LEB128 varint
+      0x34, 0x38   float, double                     raw bytes, little-endian host
+      'S'          String                            varint length, then the characters
+
+    Small keys and data therefore take a byte or two. Records are
+    buffered and written in 64 KB blocks, so logging costs about one
+    memcpy per call. The log is complete once StopRecording() or the
+    destructor has run.
+
+    MapLogReader reads without knowing K or D: an integer comes back as
+    int64_t or uint64_t, a String as a pointer and a length, so that a
+    replay tool (mreplay.cpp) can drive maps of other key types with
+    the same trace.
+*/
+
+#ifndef _MAPLOG_H
+#define _MAPLOG_H
+
+#include <cstddef>     // size_t
+#include <cstdint>
+#include <cstdio>      // FILE
+#include <cstring>     // memcpy, memcmp, strlen
+#include <vector>
+#include <type_traits>
+
+#include <xstring.h>
+
+namespace fsu
+{
+
+  enum MapLogOp { LOG_PUT = 1, LOG_GET, LOG_ERASE, LOG_RETRIEVE, LOG_INCLUDES, LOG_REHASH, LOG_CLEAR, LOG_NUM_OPS };
+
+  inline const char* MapLogOpName (int op)
+  {
+    static const char* names[LOG_NUM_OPS] =
+      { "?", "Put", "Get", "Erase", "Retrieve", "Includes", "Rehash", "Clear" };
+    return (op > 0 && op < LOG_NUM_OPS) ? names[op] : names[0];
+  }
+
+  //---------------------------
+  //    encoding
+  //---------------------------
+
+  template < typename T , class Enable = void >
+  struct MapLogType;   // no log encoding for T
+
+  template < typename T >
+  struct MapLogType < T , typename std::enable_if < std::is_integral<T>::value >::type >
+  {
+    static const uint8_t code = (std::is_signed<T>::value ? 0x10 : 0x20) + sizeof(T);
+    static void Put (std::vector<char>& b, T t)
+    {
+      uint64_t v = (uint64_t)(int64_t)t;
+      if (std::is_signed<T>::value)
+        v = (v << 1) ^ (uint64_t)((int64_t)t >> 63); // zigzag: small negatives stay small
+      else
+        v = (uint64_t)t;
+      while (v >= 0x80)
+      {
+        b.push_back((char)(v | 0x80));
+        v >>= 7;
+      }
+      b.push_back((char)v);
+    }
+  } ;
+
+  template < typename T >
+  struct MapLogType < T , typename std::enable_if < std::is_floating_point<T>::value >::type >
+  {
+    static const uint8_t code = 0x30 + sizeof(T);
+    static void Put (std::vector<char>& b, T t)
+    {
+      char c[sizeof(T)];
+      memcpy(c, &t, sizeof(T));
+      b.insert(b.end(), c, c + sizeof(T));
+    }
+  } ;
+
+  template <>
+  struct MapLogType < String >
+  {
+    static const uint8_t code = 'S';
+    static void Put (std::vector<char>& b, const String& s)
+    {
+      const char* p = s.Cstr();
+      size_t n = p ? strlen(p) : 0;
+      MapLogType<uint64_t>::Put(b, n);
+      b.insert(b.end(), p, p + n);
+    }
+  } ;
+
+  //---------------------------
+  //    class MapRecorder
+  //---------------------------
+
+  template < class M >
+  class MapRecorder : public M
+  {
+  public:
+    typedef typename M::KeyType       KeyType;
+    typedef typename M::DataType      DataType;
+    typedef typename M::Iterator      Iterator;
+    typedef typename M::ConstIterator ConstIterator;
+
+    MapRecorder () : file_(nullptr), logged_(0) {}
+    MapRecorder (const MapRecorder& m) : M(m), file_(nullptr), logged_(0) {}
+    MapRecorder& operator = (const MapRecorder& m) { M::operator=(m); return *this; } // keeps this log
+    ~MapRecorder () { StopRecording(); }
+
+    bool Record (const char* path)
+    {
+      StopRecording();
+      file_ = fopen(path, "wb");
+      if (file_ == nullptr)
+        return 0;
+      static const char magic[8] = { 'F','S','U','M','A','P','L','G' };
+      buf_.assign(magic, magic + 8);
+      buf_.push_back(1);
+      buf_.push_back((char)MapLogType<KeyType>::code);
+      buf_.push_back((char)MapLogType<DataType>::code);
+      buf_.resize(16, 0);
+      logged_ = 0;
+      return 1;
+    }
+
+    void StopRecording ()
+    {
+      if (file_ == nullptr)
+        return;
+      Flush();
+      fclose(file_);
+      file_ = nullptr;
+    }
+
+    bool     Recording () const { return file_ != nullptr; }
+    uint64_t Logged    () const { return logged_; }
+
+    // the recorded calls
+    DataType& operator [] (const KeyType& k) { return Get(k); }
+    void      Put      (const KeyType& k, const DataType& d) { Log(LOG_PUT, &k, &d); M::Put(k,d); }
+    void      Insert   (const KeyType& k, const DataType& d) { Put(k,d); }
+    DataType& Get      (const KeyType& k) { Log(LOG_GET, &k); return M::Get(k); }
+    bool      Retrieve (const KeyType& k, DataType& d) const { Log(LOG_RETRIEVE, &k); return M::Retrieve(k,d); }
+    Iterator      Includes (const KeyType& k)       { Log(LOG_INCLUDES, &k); return M::Includes(k); }
+    ConstIterator Includes (const KeyType& k) const { Log(LOG_INCLUDES, &k); return M::Includes(k); }
+    void      Erase    (const KeyType& k) { Log(LOG_ERASE, &k); M::Erase(k); }
+    void      Rehash   () { Log(LOG_REHASH); M::Rehash(); }
+    void      StartRehash () { if (!M::Rehashing()) Log(LOG_REHASH); M::StartRehash(); }
+    void      Clear    () { Log(LOG_CLEAR); M::Clear(); }
+
+    template < class I >
+    bool Build (I beg, I end)
+    {
+      if (!M::Build(beg, end))
+        return 0;
+      if (file_)
+      {
+        Log(LOG_CLEAR);
+        for (I i = beg; i != end; ++i)
+          Log(LOG_PUT, &(*i).key_, &(*i).data_);
+      }
+      return 1;
+    }
+
+  private:
+    mutable FILE*             file_;
+    mutable std::vector<char> buf_;
+    mutable uint64_t          logged_;
+
+    void Log (MapLogOp op, const KeyType* k = nullptr, const DataType* d = nullptr) const
+    {
+      if (file_ == nullptr)
+        return;
+      buf_.push_back((char)op);
+      if (k) MapLogType<KeyType>::Put(buf_, *k);
+      if (d) MapLogType<DataType>::Put(buf_, *d);
+      ++logged_;
+      if (buf_.size() >= 65536)
+        Flush();
+    }
+
+    void Flush () const
+    {
+      if (!buf_.empty())
+        fwrite(buf_.data(), 1, buf_.size(), file_);
+      buf_.clear();
+    }
+  } ;
+
+  //---------------------------
+  //    class MapLogReader
+  //---------------------------
+
+  struct MapLogValue
+  {
+    uint8_t     type;
+    int64_t     i;     // signed integer types
+    uint64_t    u;     // unsigned integer types
+    double      f;     // float, double
+    const char* s;     // String: s[0..n) in the reader's buffer
+    size_t      n;
+  } ;
+
+  class MapLogReader
+  {
+  public:
+    MapLogReader () : pos_(0), keyType_(0), dataType_(0), bad_(0) {}
+
+    // reads the whole log; false if it cannot be read or is not a map log
+    bool Open (const char* path)
+    {
+      data_.clear();
+      pos_ = 0;
+      bad_ = 0;
+      FILE* f = fopen(path, "rb");
+      if (f == nullptr)
+        return 0;
+      char block[65536];
+      size_t got;
+      while ((got = fread(block, 1, sizeof(block), f)) > 0)
+        data_.insert(data_.end(), block, block + got);
+      fclose(f);
+      if (data_.size() < 16 || memcmp(data_.data(), "FSUMAPLG", 8) != 0 || data_[8] != 1)
+        return 0;
+      keyType_  = (uint8_t)data_[9];
+      dataType_ = (uint8_t)data_[10];
+      if (!Known(keyType_) || !Known(dataType_))
+        return 0;
+      pos_ = 16;
+      return 1;
+    }
+
+    uint8_t KeyType  () const { return keyType_; }
+    uint8_t DataType () const { return dataType_; }
+    bool    Bad      () const { return bad_; }   // stopped at a damaged record
+
+    // the next operation; false at the end of the log
+    bool Next (int& op, MapLogValue& key, MapLogValue& data)
+    {
+      if (pos_ >= data_.size())
+        return 0;
+      op = (uint8_t)data_[pos_++];
+      if (op <= 0 || op >= LOG_NUM_OPS)
+        return Damaged();
+      if (op != LOG_REHASH && op != LOG_CLEAR && !Value(keyType_, key))
+        return Damaged();
+      if (op == LOG_PUT && !Value(dataType_, data))
+        return Damaged();
+      return 1;
+    }
+
+    static bool Known (uint8_t t)
+    {
+      return ((t & 0xF0) == 0x10 && (t & 0x0F) >= 1 && (t & 0x0F) <= 8)
+          || ((t & 0xF0) == 0x20 && (t & 0x0F) >= 1 && (t & 0x0F) <= 8)
+          || t == 0x34 || t == 0x38 || t == 'S';
+    }
+
+    static const char* TypeName (uint8_t t)
+    {
+      switch (t)
+      {
+        case 0x11: return "int8";   case 0x12: return "int16";  case 0x14: return "int32";  case 0x18: return "int64";
+        case 0x21: return "uint8";  case 0x22: return "uint16"; case 0x24: return "uint32"; case 0x28: return "uint64";
+        case 0x34: return "float";  case 0x38: return "double"; case 'S':  return "String";
+        default:   return "unknown";
+      }
+    }
+
+  private:
+    std::vector<char> data_;
+    size_t            pos_;
+    uint8_t           keyType_, dataType_;
+    bool              bad_;
+
+    bool Damaged ()
+    {
+      bad_ = 1;
+      pos_ = data_.size();
+      return 0;
+    }
+
+    bool Varint (uint64_t& v)
+    {
+      v = 0;
+      for (unsigned shift = 0; shift < 64 && pos_ < data_.size(); shift += 7)
+      {
+        uint8_t b = (uint8_t)data_[pos_++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (b < 0x80)
+          return 1;
+      }
+      return 0;
+    }
+
+    bool Value (uint8_t t, MapLogValue& x)
+    {
+      x.type = t;
+      uint64_t v;
+      switch (t & 0xF0)
+      {
+        case 0x10:
+          if (!Varint(v)) return 0;
+          x.i = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+          return 1;
+        case 0x20:
+          return Varint(x.u);
+        case 0x30:
+          if (data_.size() - pos_ < (size_t)(t & 0x0F)) return 0;
+          if (t == 0x34) { float g; memcpy(&g, &data_[pos_], 4); x.f = g; }
+          else           { memcpy(&x.f, &data_[pos_], 8); }
+          pos_ += t & 0x0F;
+          return 1;
+        default: // 'S'
+          if (!Varint(v) || data_.size() - pos_ < v) return 0;
+          x.s = &data_[pos_];
+          x.n = (size_t)v;
+          pos_ += (size_t)v;
+          return 1;
+      }
+    }
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,191 @@
+/*
+    memtrack.h
+    10/18/26
+
+    Memory accounting for fsu containers
+
+    functions/classes/macros defined in this file
+    ---------------------------------------------
+
+    HeapUsage (t)                    // heap bytes owned by t, beyond sizeof(t)
+    struct HeapCounters              // process-wide allocation tallies
+    HeapStats ()                     // the HeapCounters instance
+    class  HeapMark                  // snapshot; allocations / bytes since, peak since
+    FSU_MEMTRACK_INSTALL_OPERATORS   // counting operator new/delete, one TU per program
+
+    Two complementary views:
+
+    1. Structural: each container answers MemoryUsage(), the bytes it owns
+       counting sizeof(*this), slack capacity, per-node links and sentinels,
+       and whatever its elements own in turn. Elements report through the
+       free function HeapUsage(t), which is 0 for anything without an
+       overload (scalars, pointers, PODs); fsu::String, std::string and the
+       fsu containers provide overloads, so nested containers add up.
+       Allocator headers and rounding are not included; they are a property
+       of malloc, not of the container.
+
+    2. Measured: a program that expands FSU_MEMTRACK_INSTALL_OPERATORS at
+       file scope in exactly one translation unit replaces global operator
+       new/delete with versions that tally allocations, live bytes and peak
+       live bytes (requested sizes, again without malloc overhead). Use a
+       HeapMark around a region to get allocations per operation and the
+       peak reached inside it. Without the macro HeapStats().Installed() is
+       false and the counters stay at zero.
+
+    The counters are relaxed atomics, so totals are exact under threads;
+    the peak is a best effort (a racing pair of allocations may be missed).
+
+    Usage:
+
+      FSU_MEMTRACK_INSTALL_OPERATORS   // at file scope in the driver
+
+      fsu::HeapMark mark;
+      for (size_t i = 0; i < n; ++i) map.Put(keys[i], i);
+      std::cout << double(mark.Allocations()) / n << " allocations/op, "
+                << mark.Peak() << " bytes peak, "
+                << map.MemoryUsage() << " bytes owned\n";
+*/
+
+#ifndef _MEMTRACK_H
+#define _MEMTRACK_H
+
+#include <cstddef>   // size_t
+#include <cstdlib>   // malloc, free
+#include <atomic>
+#include <new>
+#include <string>
+
+namespace fsu
+{
+
+  //-----------------------------
+  //    HeapUsage (element)
+  //-----------------------------
+
+  // default: the object owns nothing off its own footprint
+  template < typename T >
+  inline size_t HeapUsage (const T&) { return 0; }
+
+  inline size_t HeapUsage (const std::string& s)
+  {
+    // short strings live inside the object itself (small string optimization)
+    const char* d = s.data();
+    const char* o = (const char*)&s;
+    return (d >= o && d < o + sizeof(s)) ? 0 : s.capacity() + 1;
+  }
+
+  //-----------------------------
+  //    struct HeapCounters
+  //-----------------------------
+
+  struct HeapCounters
+  {
+    std::atomic<size_t> allocations, deallocations, liveBytes, peakBytes, totalBytes;
+    std::atomic<bool>   installed;
+
+    bool   Installed () const { return installed.load(std::memory_order_relaxed); }
+    size_t Live      () const { return liveBytes.load(std::memory_order_relaxed); }
+    size_t Peak      () const { return peakBytes.load(std::memory_order_relaxed); }
+    size_t Allocs    () const { return allocations.load(std::memory_order_relaxed); }
+    size_t Total     () const { return totalBytes.load(std::memory_order_relaxed); }
+    void   ResetPeak ()       { peakBytes.store(Live(), std::memory_order_relaxed); }
+
+    void OnAlloc (size_t n)
+    {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+      totalBytes.fetch_add(n, std::memory_order_relaxed);
+      size_t live = liveBytes.fetch_add(n, std::memory_order_relaxed) + n;
+      if (live > peakBytes.load(std::memory_order_relaxed))
+        peakBytes.store(live, std::memory_order_relaxed);
+    }
+    void OnFree (size_t n)
+    {
+      deallocations.fetch_add(1, std::memory_order_relaxed);
+      liveBytes.fetch_sub(n, std::memory_order_relaxed);
+    }
+  } ;
+
+  // zero-initialized before any dynamic initialization, so safe from operator new
+  inline HeapCounters& HeapStats ()
+  {
+    static HeapCounters counters;
+    return counters;
+  }
+
+  //-----------------------
+  //    class HeapMark
+  //-----------------------
+
+  class HeapMark
+  {
+  public:
+    HeapMark () { Reset(); }
+    void Reset ()
+    {
+      HeapCounters& h = HeapStats();
+      allocs_ = h.Allocs();
+      total_  = h.Total();
+      live_   = h.Live();
+      h.ResetPeak();
+    }
+    size_t Allocations () const { return HeapStats().Allocs() - allocs_; }  // since Reset()
+    size_t Bytes       () const { return HeapStats().Total() - total_; }    // allocated since Reset()
+    long   Growth      () const { return (long)HeapStats().Live() - (long)live_; }
+    size_t Peak        () const { return HeapStats().Peak() - live_; }      // above the starting level
+
+  private:
+    size_t allocs_, total_, live_;
+  } ;
+
+  //---------------------------------
+  //    counting operator new/delete
+  //---------------------------------
+
+  namespace memtrack
+  {
+    enum { header = 16 };   // keeps returned blocks 16-byte aligned
+
+    // out of line so the optimizer never pairs a visible new with this free()
+#if defined(__GNUC__) || defined(__clang__)
+  #define FSU_MEMTRACK_NOINLINE __attribute__((noinline))
+#else
+  #define FSU_MEMTRACK_NOINLINE
+#endif
+
+    FSU_MEMTRACK_NOINLINE inline void* Allocate (size_t n)
+    {
+      char* p = (char*)malloc(n + header);
+      if (p == nullptr) return nullptr;
+      *(size_t*)p = n;
+      HeapStats().OnAlloc(n);
+      return p + header;
+    }
+
+    FSU_MEMTRACK_NOINLINE inline void Release (void* p)
+    {
+      if (p == nullptr) return;
+      char* b = (char*)p - header;
+      HeapStats().OnFree(*(size_t*)b);
+      free(b);
+    }
+
+    struct Installer { Installer () { HeapStats().installed.store(true); } };
+  } // namespace memtrack
+
+} // namespace fsu
+
+#define FSU_MEMTRACK_INSTALL_OPERATORS \
+  void* operator new (size_t n) \
+  { void* p = fsu::memtrack::Allocate(n); if (p == nullptr) throw std::bad_alloc(); return p; } \
+  void* operator new (size_t n, const std::nothrow_t&) noexcept { return fsu::memtrack::Allocate(n); } \
+  void* operator new[] (size_t n) { return operator new(n); } \
+  void* operator new[] (size_t n, const std::nothrow_t& t) noexcept { return operator new(n, t); } \
+  void operator delete (void* p) noexcept                          { fsu::memtrack::Release(p); } \
+  void operator delete (void* p, const std::nothrow_t&) noexcept   { fsu::memtrack::Release(p); } \
+  void operator delete (void* p, size_t) noexcept                  { fsu::memtrack::Release(p); } \
+  void operator delete[] (void* p) noexcept                        { fsu::memtrack::Release(p); } \
+  void operator delete[] (void* p, const std::nothrow_t&) noexcept { fsu::memtrack::Release(p); } \
+  void operator delete[] (void* p, size_t) noexcept                { fsu::memtrack::Release(p); } \
+  static fsu::memtrack::Installer fsuMemtrackInstaller;
+
+#endif
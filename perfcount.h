@@ -0,0 +1,212 @@
+/*
+    perfcount.h
+    10/18/26
+
+    Hardware performance counters for benchmark regions (Linux perf_event_open)
+
+    classes defined in this file
+    ----------------------------
+
+    struct PerfSample    // one reading of every counter, plus which ones are valid
+    class  PerfCounters  // opens the counters once; Start() / Stop() bracket a region
+
+    counters
+    --------
+
+    cycles        CPU cycles (user space only)
+    instructions  instructions retired
+    L1d           L1 data cache read misses
+    LLC           last level cache read misses
+    branch        mispredicted branches
+    dTLB          data TLB read misses
+
+    Each counter is opened on its own rather than as a group, so a PMU that
+    lacks one event (dTLB on many VMs, for example) still delivers the rest.
+    When the kernel multiplexes counters the raw counts are scaled by
+    time_enabled / time_running, the same correction perf stat applies.
+
+    Everything degrades quietly: off Linux, inside containers that block the
+    syscall, or with /proc/sys/kernel/perf_event_paranoid > 2, Available()
+    is false, Stop() returns a sample with no valid counters, and reports
+    simply omit the counter columns. Reason() says why.
+
+    Usage:
+
+      PerfCounters pc;
+      pc.Start();
+      for (...) map.Get(k);
+      PerfSample s = pc.Stop();
+      if (s.Valid(PerfCounters::l1dMisses))
+        std::cout << s.PerOp(PerfCounters::l1dMisses, n) << " L1d misses/op\n";
+*/
+
+#ifndef _PERFCOUNT_H
+#define _PERFCOUNT_H
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <cstring>   // memset
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace fsu
+{
+
+  class PerfCounters;
+
+  //------------------------
+  //    struct PerfSample
+  //------------------------
+
+  struct PerfSample
+  {
+    enum { numEvents = 6 };
+
+    PerfSample () { Clear(); }
+    void Clear ()
+    {
+      for (size_t i = 0; i < numEvents; ++i) { value[i] = 0; valid[i] = false; }
+    }
+
+    bool   Valid (size_t e) const { return valid[e]; }
+    bool   Any   () const
+    {
+      for (size_t i = 0; i < numEvents; ++i) if (valid[i]) return true;
+      return false;
+    }
+    double PerOp (size_t e, double ops) const { return (valid[e] && ops > 0) ? double(value[e]) / ops : 0.0; }
+    double Ipc   () const;
+
+    uint64_t value[numEvents];
+    bool     valid[numEvents];
+  } ;
+
+  //--------------------------
+  //    class PerfCounters
+  //--------------------------
+
+  class PerfCounters
+  {
+  public:
+    enum Event { cycles, instructions, l1dMisses, llcMisses, branchMisses, dtlbMisses, numEvents };
+
+    PerfCounters () : reason_("not supported on this platform")
+    {
+      for (size_t i = 0; i < numEvents; ++i) fd_[i] = -1;
+#if defined(__linux__)
+      reason_ = nullptr;
+      for (size_t i = 0; i < numEvents; ++i)
+        fd_[i] = Open((Event)i);
+      if (!Available())
+        reason_ = "perf_event_open not permitted (see /proc/sys/kernel/perf_event_paranoid)";
+#endif
+    }
+
+    ~PerfCounters ()
+    {
+#if defined(__linux__)
+      for (size_t i = 0; i < numEvents; ++i)
+        if (fd_[i] >= 0) close(fd_[i]);
+#endif
+    }
+
+    bool Available (Event e) const { return fd_[e] >= 0; }
+    bool Available () const
+    {
+      for (size_t i = 0; i < numEvents; ++i) if (fd_[i] >= 0) return true;
+      return false;
+    }
+    const char* Reason () const { return reason_; }   // null when Available()
+
+    static const char* Name (size_t e)
+    {
+      static const char* names[numEvents] = { "cycles", "instructions", "L1d", "LLC", "branch", "dTLB" };
+      return names[e];
+    }
+
+    void Start ()
+    {
+#if defined(__linux__)
+      for (size_t i = 0; i < numEvents; ++i)
+        if (fd_[i] >= 0)
+        {
+          ioctl(fd_[i], PERF_EVENT_IOC_RESET, 0);
+          ioctl(fd_[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    PerfSample Stop ()
+    {
+      PerfSample s;
+#if defined(__linux__)
+      for (size_t i = 0; i < numEvents; ++i)
+        if (fd_[i] >= 0) ioctl(fd_[i], PERF_EVENT_IOC_DISABLE, 0);
+      for (size_t i = 0; i < numEvents; ++i)
+      {
+        if (fd_[i] < 0) continue;
+        uint64_t buf[3];   // value, time_enabled, time_running
+        if (read(fd_[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf) || buf[2] == 0)
+          continue;
+        s.value[i] = (buf[1] == buf[2]) ? buf[0]
+                   : (uint64_t)((double)buf[0] * (double)buf[1] / (double)buf[2]);
+        s.valid[i] = true;
+      }
+#endif
+      return s;
+    }
+
+  private:
+    int         fd_[numEvents];
+    const char* reason_;
+
+#if defined(__linux__)
+    static int Open (Event e)
+    {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      switch (e)
+      {
+        case cycles:       attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES;    break;
+        case instructions: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS;  break;
+        case branchMisses: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case l1dMisses:    attr.type = PERF_TYPE_HW_CACHE; attr.config = CacheMiss(PERF_COUNT_HW_CACHE_L1D);  break;
+        case llcMisses:    attr.type = PERF_TYPE_HW_CACHE; attr.config = CacheMiss(PERF_COUNT_HW_CACHE_LL);   break;
+        case dtlbMisses:   attr.type = PERF_TYPE_HW_CACHE; attr.config = CacheMiss(PERF_COUNT_HW_CACHE_DTLB); break;
+        default: return -1;
+      }
+      return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);   // this thread, any cpu
+    }
+
+    static uint64_t CacheMiss (uint64_t cache)
+    {
+      return cache | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8)
+                   | ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+    PerfCounters (const PerfCounters&);
+    PerfCounters& operator= (const PerfCounters&);
+  } ;
+
+  static_assert((int)PerfSample::numEvents == (int)PerfCounters::numEvents, "PerfSample must cover every event");
+
+  inline double PerfSample::Ipc () const
+  {
+    return (valid[PerfCounters::cycles] && valid[PerfCounters::instructions] && value[PerfCounters::cycles])
+      ? double(value[PerfCounters::instructions]) / value[PerfCounters::cycles] : 0.0;
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,220 @@
+/*
+    pgenalg.h
+    10/18/26
+
+    Parallel overloads of the genalg.h algorithms
+
+    Each algorithm takes the execution-policy tag fsu::par as its first
+    argument and otherwise matches its sequential counterpart:
+
+      g_fill        (par, beg, end, t)
+      g_copy        (par, src_beg, src_end, dest_beg)
+      g_for_each    (par, beg, end, f)      // f is copied into each chunk
+      g_find        (par, beg, end, t)
+      g_find_if     (par, beg, end, p)
+      g_min_element (par, beg, end [, p])
+      g_max_element (par, beg, end [, p])
+
+    I must be random access: end - beg and beg + n are used to cut the
+    range into chunks (raw pointers, i.e. Vector<T>::Iterator, and
+    Deque<T> iterators both qualify). Chunks run on a TaskGroup over
+    ThreadPool::Default(), a few per thread so stealing can even out load.
+    Ranges shorter than a grain (policy.grain, default 32K elements) run
+    sequentially: below that, task overhead outweighs the work. A policy
+    object can name a different pool:
+
+      fsu::ThreadPool four(3);                        // 3 workers + caller
+      fsu::g_fill(fsu::ParallelPolicy(32768, &four), beg, end, 0);
+
+    Results are identical to the sequential versions: g_find returns the
+    first match (later chunks stop early once an earlier match is known),
+    and min/max return the first extreme element, as genalg.h does.
+
+    Usage:
+
+      fsu::Vector<int> v(100000000, 0);
+      fsu::g_fill(fsu::par, v.Begin(), v.End(), 7);
+      int* m = fsu::g_min_element(fsu::par, v.Begin(), v.End());
+*/
+
+#ifndef _PGENALG_H
+#define _PGENALG_H
+
+#include <cstddef>   // size_t
+#include <atomic>
+#include <vector>
+#include <genalg.h>
+#include <threadpool.h>
+
+namespace fsu
+{
+
+  struct ParallelPolicy
+  {
+    size_t      grain;   // minimum elements per chunk
+    ThreadPool* pool;    // null: ThreadPool::Default()
+    explicit ParallelPolicy (size_t g = 32768, ThreadPool* p = nullptr) : grain(g ? g : 1), pool(p) {}
+    ThreadPool& Pool () const { return pool ? *pool : ThreadPool::Default(); }
+  } ;
+
+  static const ParallelPolicy par;
+
+  namespace pgenalg
+  {
+    // runs body(lo, hi, chunk) over [0,n) in chunks, in parallel; returns the number of chunks
+    template < class B >
+    size_t ForChunks (const ParallelPolicy& pol, size_t n, B body)
+    {
+      ThreadPool& pool = pol.Pool();
+      size_t chunks = n / pol.grain;
+      size_t most   = 4 * pool.Concurrency();
+      if (chunks > most) chunks = most;
+      if (chunks <= 1 || pool.Concurrency() == 1)
+      {
+        body((size_t)0, n, (size_t)0);
+        return 1;
+      }
+      TaskGroup g(pool);
+      for (size_t c = 0; c < chunks; ++c)
+      {
+        size_t lo = n * c / chunks, hi = n * (c + 1) / chunks;
+        g.Run([=]() { body(lo, hi, c); });
+      }
+      g.Wait();
+      return chunks;
+    }
+
+    // chunk-local extreme, then a sequential pass over the chunk winners
+    template < class I, class P >
+    I ExtremeElement (const ParallelPolicy& pol, I beg, I end, const P& better)
+    {
+      size_t n = (size_t)(end - beg);
+      if (n == 0) return end;
+      std::vector<size_t> best(4 * pol.Pool().Concurrency() + 1, n);
+      size_t chunks = ForChunks(pol, n, [&](size_t lo, size_t hi, size_t c)
+        {
+          size_t b = lo;
+          for (size_t i = lo + 1; i < hi; ++i)
+            if (better(*(beg + (long)i), *(beg + (long)b)))
+              b = i;
+          best[c] = b;
+        });
+      size_t b = best[0];
+      for (size_t c = 1; c < chunks; ++c)   // strict: ties keep the earlier chunk
+        if (better(*(beg + (long)best[c]), *(beg + (long)b)))
+          b = best[c];
+      return beg + (long)b;
+    }
+
+    template < class I, class P >
+    I FindIf (const ParallelPolicy& pol, I beg, I end, const P& p)
+    {
+      size_t n = (size_t)(end - beg);
+      std::atomic<size_t> found(n);
+      ForChunks(pol, n, [&](size_t lo, size_t hi, size_t)
+        {
+          for (size_t i = lo; i < hi; ++i)
+          {
+            if ((i & 1023) == 0 && found.load(std::memory_order_relaxed) < lo)
+              return;                                 // an earlier chunk already matched
+            if (p(*(beg + (long)i)))
+            {
+              size_t f = found.load();
+              while (i < f && !found.compare_exchange_weak(f, i)) {}
+              return;
+            }
+          }
+        });
+      return beg + (long)found.load();
+    }
+
+    template < typename T >
+    struct EqualTo
+    {
+      const T& t;
+      explicit EqualTo (const T& x) : t(x) {}
+      template < typename U > bool operator () (const U& u) const { return t == u; }
+    } ;
+
+    struct Less
+    {
+      template < typename A, typename B > bool operator () (const A& a, const B& b) const { return a < b; }
+    } ;
+
+    template < class P >
+    struct Reversed   // better(a,b) for max: b precedes a in p's order
+    {
+      const P& p;
+      explicit Reversed (const P& x) : p(x) {}
+      template < typename A, typename B > bool operator () (const A& a, const B& b) const { return p(b,a); }
+    } ;
+  } // namespace pgenalg
+
+  template < class I, typename T >
+  void g_fill (const ParallelPolicy& pol, I beg, I end, const T& t)
+  {
+    pgenalg::ForChunks(pol, (size_t)(end - beg), [&](size_t lo, size_t hi, size_t)
+      {
+        g_fill(beg + (long)lo, beg + (long)hi, t);
+      });
+  }
+
+  template < class I, class J >
+  void g_copy (const ParallelPolicy& pol, I source_beg, I source_end, J dest_beg)
+  {
+    pgenalg::ForChunks(pol, (size_t)(source_end - source_beg), [&](size_t lo, size_t hi, size_t)
+      {
+        g_copy(source_beg + (long)lo, source_beg + (long)hi, dest_beg + (long)lo);
+      });
+  }
+
+  template < class I, class F >
+  F g_for_each (const ParallelPolicy& pol, I beg, I end, F f)
+  {
+    pgenalg::ForChunks(pol, (size_t)(end - beg), [&](size_t lo, size_t hi, size_t)
+      {
+        g_for_each(beg + (long)lo, beg + (long)hi, f);
+      });
+    return f;
+  }
+
+  template < class I, typename T >
+  I g_find (const ParallelPolicy& pol, I beg, I end, const T& t)
+  {
+    return pgenalg::FindIf(pol, beg, end, pgenalg::EqualTo<T>(t));
+  }
+
+  template < class I, class P >
+  I g_find_if (const ParallelPolicy& pol, I beg, I end, const P& p)
+  {
+    return pgenalg::FindIf(pol, beg, end, p);
+  }
+
+  template < class I >
+  I g_min_element (const ParallelPolicy& pol, I beg, I end)
+  {
+    return pgenalg::ExtremeElement(pol, beg, end, pgenalg::Less());
+  }
+
+  template < class I, class P >
+  I g_min_element (const ParallelPolicy& pol, I beg, I end, const P& p)
+  {
+    return pgenalg::ExtremeElement(pol, beg, end, p);
+  }
+
+  template < class I >
+  I g_max_element (const ParallelPolicy& pol, I beg, I end)
+  {
+    pgenalg::Less less;
+    return pgenalg::ExtremeElement(pol, beg, end, pgenalg::Reversed<pgenalg::Less>(less));
+  }
+
+  template < class I, class P >
+  I g_max_element (const ParallelPolicy& pol, I beg, I end, const P& p)
+  {
+    return pgenalg::ExtremeElement(pol, beg, end, pgenalg::Reversed<P>(p));
+  }
+
+} // namespace fsu
+
+#endif
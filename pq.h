@@ -0,0 +1,248 @@
+/*
+    pq.h
+    10/18/26
+
+    The PriorityQueue < T, C, P, D > class
+    An adaptor class: a D-ary heap stored in a random access container C<T>
+
+    ASSUMPTION: T and C::ValueType are the same type
+
+    classes defined in this file
+    ----------------------------
+
+    class PriorityQueue < T, C, P, D >   // the primary ADT
+
+    Front() is a largest element in the order P: with the default
+    LessThan<T> it is a maximum, and with GreaterThan<T> a minimum. Equal
+    elements come out in no particular order.
+
+    D is the number of children per node, 2 (binary heap, the default) or
+    4. With a 4-ary heap the tree is half as deep, so Push and the moves
+    in Pop touch fewer cache lines. Each Pop level compares 4 children
+    instead of 2, but they sit side by side in memory. Pop-heavy loads
+    with large elements or many elements usually favor D = 4. cbench
+    measures both.
+
+      Push     (t)      O(log n)   insert t
+      Pop      ()       O(log n)   remove Front()          Pre: !Empty()
+      Front    ()       O(1)       a largest element        Pre: !Empty()
+      PushPop  (t)      O(log n)   Push(t), then Pop(); returns the removed value
+                                   and does no work when t itself would go
+      Replace  (t)      O(log n)   Pop(), then Push(t); returns the removed value
+                                                            Pre: !Empty()
+      PriorityQueue (beg, end)  O(n)  heapify a range (bottom-up, Floyd)
+
+    PushPop keeps the k smallest of a stream in a k-element max-heap
+    (top-K). Replace advances one run of a k-way merge: pop the run's
+    head, push its successor.
+
+    container protocols used
+    ------------------------
+
+    constructor         C          ()
+    void                PushBack   (const ValueType&)
+    void                PopBack    ()
+    void                Clear      ()
+    const ValueType&    operator[] (size_t) const
+    C::Iterator         Begin      ()
+    ValueType&          C::Iterator::operator[] (size_t)
+    bool                Empty      () const
+    size_t              Size       () const
+*/
+
+#ifndef _PQ_H
+#define _PQ_H
+
+#include <cstdlib>    // size_t
+#include <iostream>
+#include <utility>    // std::move
+#include <vector.h>
+#include <compare.h>
+
+namespace fsu
+{
+
+  template < typename T , class C = Vector < T > , class P = LessThan < T > , size_t D = 2 >
+  class PriorityQueue
+  {
+    static_assert(D >= 2, "PriorityQueue: arity must be at least 2");
+
+  protected:
+    C c_;
+    P p_;
+
+  public:
+    typedef T ValueType;
+    typedef C ContainerType;
+    typedef P PredicateType;
+    enum { arity = D };
+
+    explicit PriorityQueue (const P& p = P())  :  c_(), p_(p)
+    {}
+
+    // heapify [beg,end) in O(n)
+    template < class I >
+    PriorityQueue (I beg, I end, const P& p = P())  :  c_(), p_(p)
+    {
+      for ( ; beg != end; ++beg)
+        c_.PushBack(*beg);
+      Heapify();
+    }
+
+    void Push (const ValueType& t)
+    {
+      c_.PushBack(t);
+      SiftUp(c_.Size() - 1);
+    }
+
+    void Pop ()
+    // Pre:  !Empty()
+    {
+      size_t last = c_.Size() - 1;
+      if (last == 0)
+      {
+        c_.PopBack();
+        return;
+      }
+      ValueType t = std::move(c_.Begin()[last]);
+      c_.PopBack();
+      Sink(c_.Begin(), 0, last, t);
+    }
+
+    ValueType PushPop (const ValueType& t)
+    {
+      if (c_.Empty() || !p_(t, c_[0]))
+        return t;                 // t would be the new front and leave at once
+      return Replace(t);
+    }
+
+    ValueType Replace (const ValueType& t)
+    // Pre:  !Empty()
+    {
+      typename C::Iterator h = c_.Begin();
+      ValueType top = std::move(h[0]);
+      ValueType x = t;
+      Sink(h, 0, c_.Size(), x);
+      return top;
+    }
+
+    const ValueType& Front () const
+    // Pre:  !Empty()
+    {
+      return c_[0];
+    }
+
+    void Clear ()
+    {
+      c_.Clear();
+    }
+
+    bool Empty () const
+    {
+      return c_.Empty();
+    }
+
+    size_t Size () const
+    {
+      return c_.Size();
+    }
+
+    // development assistant: 1 iff no child precedes its parent in P
+    bool CheckHeap () const
+    {
+      for (size_t i = 1; i < c_.Size(); ++i)
+        if (p_(c_[(i - 1) / D], c_[i]))
+          return 0;
+      return 1;
+    }
+
+    void Display (std::ostream& os, char ofc = '\0') const;
+    // displays the heap array, level by level
+
+  private:
+    // Both sifts use the hole technique: the moving element is taken out
+    // once and the others shift into the hole. Access goes through
+    // C::Iterator, a raw pointer for Vector, so there is no index check.
+
+    // moves t up from hole i, stopping below top
+    void SiftUp (typename C::Iterator h, size_t i, ValueType& t, size_t top = 0)
+    {
+      while (i > top)
+      {
+        size_t parent = (i - 1) / D;
+        if (!p_(h[parent], t))
+          break;
+        h[i] = std::move(h[parent]);
+        i = parent;
+      }
+      h[i] = std::move(t);
+    }
+
+    void SiftUp (size_t i)
+    {
+      typename C::Iterator h = c_.Begin();
+      ValueType t = std::move(h[i]);
+      SiftUp(h, i, t);
+    }
+
+    // places t in the subtree of hole i, heap size n. Bottom-up (Floyd):
+    // walk the hole down the path of largest children to a leaf without
+    // comparing t, then sift t back up. An element that replaces the front
+    // nearly always belongs near the bottom, so this does about half the
+    // comparisons of stopping on the way down.
+    void Sink (typename C::Iterator h, size_t i, size_t n, ValueType& t)
+    {
+      size_t top = i;
+      for (;;)
+      {
+        size_t first = D * i + 1;
+        if (first >= n)
+          break;
+        size_t last = (first + D < n) ? first + D : n;
+        size_t best = first;
+        for (size_t k = first + 1; k < last; ++k)
+          if (p_(h[best], h[k]))
+            best = k;
+        h[i] = std::move(h[best]);
+        i = best;
+      }
+      SiftUp(h, i, t, top);
+    }
+
+    void SiftDown (size_t i)
+    {
+      typename C::Iterator h = c_.Begin();
+      ValueType t = std::move(h[i]);
+      Sink(h, i, c_.Size(), t);
+    }
+
+    void Heapify ()
+    {
+      size_t n = c_.Size();
+      if (n < 2)
+        return;
+      for (size_t i = (n - 2) / D + 1; i-- > 0; )
+        SiftDown(i);
+    }
+  } ;
+
+  template < typename T , class C , class P , size_t D >
+  void PriorityQueue <T,C,P,D>:: Display (std::ostream& os, char ofc) const
+  {
+    if (ofc == '\0')
+      for (size_t i = 0; i < c_.Size(); ++i)
+	os << c_[i];
+    else
+      for (size_t i = 0; i < c_.Size(); ++i)
+	os << c_[i] << ofc;
+  }
+
+  template < typename T , class C , class P , size_t D >
+  std::ostream& operator << (std::ostream& os, const PriorityQueue<T,C,P,D>& q)
+  {
+    q.Display(os);
+    return os;
+  }
+
+} // namespace fsu
+#endif
@@ -0,0 +1,151 @@
+/*
+    scriptbench.h
+    10/18/26
+
+    ScriptBench: timed, silent replay of a driver's command script
+
+    The table drivers (fmap, foaa) read commands from the file named by
+    argv[1], echoing each one. Run as
+
+      fmap -b comfile
+
+    they replay comfile in bench mode instead. The file is read into
+    memory first. std::cout is silenced during the replay: its badbit is
+    set, so every insertion returns at once. Each command is timed on a
+    LatencyTimer (histogram.h), from the moment its command letter has
+    been read until it is done. That includes reading its arguments from
+    the in-memory script. At the end (Q, or the end of the script) a
+    summary goes to std::cout, one line per command type:
+
+      count      commands of the type
+      total      time spent in them, ms
+      mean, p50, p99, max
+                 latency per command, ns
+      ops/s      count / total
+
+    It is followed by the wall time of the whole replay, parsing and
+    dispatch included. Scripts recorded from real sessions then serve as
+    performance regression tests.
+
+      Open   (path)    reads the script; false if it cannot be read
+      Script ()        the stream to read commands from
+      Begin  ()        silences std::cout and starts the wall clock
+      Start  (op)      a command of type op begins
+      Stop   ()        it ends
+      Report (os)      restores std::cout; writes the summary
+*/
+
+#ifndef _SCRIPTBENCH_H
+#define _SCRIPTBENCH_H
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <histogram.h>
+
+namespace fsu
+{
+
+  class ScriptBench
+  {
+  public:
+    enum Op { PUT, GET, ERASE, INCLUDES, TRAVERSAL, REHASH, LOAD, OTHER, NUM_OPS };
+
+    static const char* Name (Op op)
+    {
+      static const char* names[NUM_OPS] =
+        { "Put", "Get", "Erase", "Includes", "Traversal", "Rehash", "Load", "other" };
+      return names[op];
+    }
+
+    ScriptBench () : path_(""), op_(OTHER), running_(0), commands_(0) {}
+
+    bool Open (const char* path)
+    {
+      std::ifstream in(path);
+      if (in.fail())
+        return 0;
+      std::ostringstream text;
+      text << in.rdbuf();
+      script_.str(text.str());
+      path_ = path;
+      return 1;
+    }
+
+    std::istream& Script () { return script_; }
+
+    void Begin ()
+    {
+      std::cout.setstate(std::ios::badbit);
+      wall_.Start();
+    }
+
+    void Start (Op op)
+    {
+      op_ = op;
+      running_ = 1;
+      ++commands_;
+      timer_.Start();
+    }
+
+    void Stop ()
+    {
+      if (!running_)
+        return;
+      hist_[op_].Record(timer_.ElapsedNs());
+      running_ = 0;
+    }
+
+    void Report (std::ostream& os)
+    {
+      Stop();
+      uint64_t wallNs = wall_.ElapsedNs();
+      std::cout.clear();
+      uint64_t busyNs = 0;
+      os << "\nbench: " << path_ << '\n'
+         << std::setw(16) << std::left << "  command" << std::right
+         << std::setw(10) << "count"
+         << std::setw(12) << "total ms"
+         << std::setw(10) << "mean"
+         << std::setw(10) << "p50"
+         << std::setw(10) << "p99"
+         << std::setw(12) << "max (ns)"
+         << std::setw(12) << "ops/s" << '\n';
+      for (size_t i = 0; i < NUM_OPS; ++i)
+      {
+        const LatencyHistogram& h = hist_[i];
+        if (h.Count() == 0)
+          continue;
+        double ns = h.Mean() * h.Count();
+        busyNs += (uint64_t)ns;
+        os << "  " << std::setw(14) << std::left << Name((Op)i) << std::right
+           << std::setw(10) << h.Count()
+           << std::setw(12) << std::fixed << std::setprecision(3) << ns / 1e6
+           << std::setw(10) << (uint64_t)h.Mean()
+           << std::setw(10) << h.Percentile(50.0)
+           << std::setw(10) << h.Percentile(99.0)
+           << std::setw(12) << h.Max()
+           << std::setw(12) << std::setprecision(0) << (ns > 0 ? h.Count() * 1e9 / ns : 0.0) << '\n';
+      }
+      os << "  " << commands_ << " commands: " << std::setprecision(3)
+         << busyNs / 1e6 << " ms in commands, " << wallNs / 1e6 << " ms wall\n";
+      os.unsetf(std::ios::floatfield);
+      os << std::setprecision(6);
+    }
+
+  private:
+    std::istringstream script_;
+    const char*        path_;
+    LatencyHistogram   hist_[NUM_OPS];
+    LatencyTimer       timer_, wall_;
+    Op                 op_;
+    bool               running_;
+    size_t             commands_;
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,466 @@
+/*
+    syncmap.h
+    10/18/26
+
+    SyncMap: a Map_ADT that may be shared by threads
+
+    classes defined in this file
+    ----------------------------
+
+    SharedLock          reader-writer lock (pthread_rwlock_t); readers share it
+    ExclusiveLock       one std::mutex for readers and writers alike
+    SyncMap < K , D , P , L >
+                        Map_ADT<K,D,P> behind a lock of type L (default SharedLock)
+
+    Every call takes the lock for its whole duration, so each one appears to
+    happen at a single instant between the calls of other threads. Calls
+    that change the map lock for writing; the others lock for reading and,
+    with SharedLock, run side by side. With the glibc rwlock, waiting
+    writers are served before new readers, so a stream of lookups cannot
+    starve Put().
+
+    Nothing that points into the map leaves a call: Get() returns the data
+    by value, Includes() returns bool, and there are no iterators. To change
+    data in place, pass a function to Update(). Whole-map reads go through
+    ForEach(), Snapshot() (a copy) or Read(f), each under one read lock.
+
+      Put      (k,d)      insert or overwrite
+      Get      (k)        the data at k, inserting D() if absent (by value)
+      Update   (k,f)      f(D&) on the data at k, inserted if absent
+      Retrieve (k,d)      false if k is absent
+      Includes (k)        true if k is present
+      Erase    (k)
+      Clear    ()
+      Rehash   ()
+      Size     ()
+      Empty    ()
+      Snapshot ()         a copy of the map
+      ForEach  (f)        f(const EntryType&) for each entry, in key order
+      Read     (f)        f(const Map_ADT&), under the read lock; returns f's result
+      Write    (f)        f(Map_ADT&), under the write lock; returns f's result
+      Compact  ()         rebuilds the tree without its tombstones; false if abandoned
+      StartCompactor (fraction, ms)
+                          a thread that calls Compact() whenever the Erase() calls
+                          since the last compaction reach fraction of the entries
+                          it left (checked every ms milliseconds)
+      StopCompactor  ()
+      Compactions    ()   compactions completed
+
+    Write(f) finishes any incremental rehash that f starts (Map_ADT::
+    StartRehash): readers cannot move entries, so they would search both
+    trees until the next Write.
+
+    Compact() does the work of Rehash() without holding the write lock
+    for it. It journals the writes made from then on, reads the live
+    entries in slices of 1024 nodes, each under its own read lock, and
+    builds the new tree with Map_ADT::Build, unlocked. Then the
+    journaled writes are replayed on the new tree in batches, unlocked,
+    until at most 64 remain; those are replayed under the write lock, the
+    trees are swapped, and the old one is freed after unlocking. If a
+    batch is no shorter than the one before, the writers are outrunning
+    the replay, and the compaction is abandoned rather than replaying a
+    long journal under the write lock. Writers
+    meanwhile wait for at most one slice or the short swap; readers wait
+    only for the swap. As with Rehash(), the tombstones are dropped, except
+    those of keys erased while Compact() ran. Clear(), Rehash() and
+    Write(f) abandon a compaction in progress. The map's filter, if
+    enabled, is kept: every key of the new tree went through this map.
+
+    Built with -DMAP_ADT_STATS, Map_ADT's const calls update its counters,
+    so SyncMap then takes the write lock for reads too.
+*/
+
+#ifndef _SYNCMAP_H
+#define _SYNCMAP_H
+
+#include <cstddef>   // size_t
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <utility>   // declval
+#include <pthread.h>
+
+#include <compare.h> // LessThan
+#include <map_adt.h>
+
+namespace fsu
+{
+
+  //---------------------------
+  //    locks
+  //---------------------------
+
+  class SharedLock
+  {
+  public:
+    SharedLock ()
+    {
+      pthread_rwlockattr_t attr;
+      pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+      pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+      pthread_rwlock_init(&lock_, &attr);
+      pthread_rwlockattr_destroy(&attr);
+    }
+    ~SharedLock () { pthread_rwlock_destroy(&lock_); }
+
+    void Lock         () { pthread_rwlock_wrlock(&lock_); }
+    void Unlock       () { pthread_rwlock_unlock(&lock_); }
+    void LockShared   () { pthread_rwlock_rdlock(&lock_); }
+    void UnlockShared () { pthread_rwlock_unlock(&lock_); }
+
+    static const char* Name () { return "SharedLock"; }
+
+  private:
+    pthread_rwlock_t lock_;
+
+    SharedLock (const SharedLock&);
+    SharedLock& operator = (const SharedLock&);
+  } ;
+
+  class ExclusiveLock
+  {
+  public:
+    void Lock         () { mutex_.lock(); }
+    void Unlock       () { mutex_.unlock(); }
+    void LockShared   () { mutex_.lock(); }
+    void UnlockShared () { mutex_.unlock(); }
+
+    static const char* Name () { return "ExclusiveLock"; }
+
+  private:
+    std::mutex mutex_;
+  } ;
+
+  template < class L >
+  class WriteGuard
+  {
+  public:
+    explicit WriteGuard (L& l) : l_(l) { l_.Lock(); }
+    ~WriteGuard () { l_.Unlock(); }
+  private:
+    L& l_;
+  } ;
+
+  template < class L >
+  class ReadGuard
+  {
+  public:
+#ifdef MAP_ADT_STATS
+    explicit ReadGuard (L& l) : l_(l) { l_.Lock(); }
+    ~ReadGuard () { l_.Unlock(); }
+#else
+    explicit ReadGuard (L& l) : l_(l) { l_.LockShared(); }
+    ~ReadGuard () { l_.UnlockShared(); }
+#endif
+  private:
+    L& l_;
+  } ;
+
+  //---------------------------
+  //    class SyncMap
+  //---------------------------
+
+  template < typename K , typename D , class P = LessThan<K> , class L = SharedLock >
+  class SyncMap
+  {
+  public:
+    typedef K                   KeyType;
+    typedef D                   DataType;
+    typedef P                   PredicateType;
+    typedef L                   LockType;
+    typedef Map_ADT<K,D,P>      MapType;
+    typedef typename MapType::EntryType EntryType;
+
+    SyncMap () : compacting_(0), abandoned_(0), erased_(0), base_(0), compactions_(0), stop_(0) {}
+    explicit SyncMap (const MapType& m) : map_(m), compacting_(0), abandoned_(0), erased_(0),
+                                          base_(m.Size()), compactions_(0), stop_(0) {}
+    ~SyncMap () { StopCompactor(); }
+
+    void Put (const K& k, const D& d)
+    {
+      WriteGuard<L> g(lock_);
+      map_.Put(k,d);
+      if (compacting_) Journal(JOURNAL_PUT, k, d);
+    }
+
+    D Get (const K& k)
+    {
+      WriteGuard<L> g(lock_);
+      D& d = map_.Get(k);
+      if (compacting_) Journal(JOURNAL_PUT, k, d);
+      return d;
+    }
+
+    template < class F >
+    void Update (const K& k, F f)
+    {
+      WriteGuard<L> g(lock_);
+      D& d = map_.Get(k);
+      f(d);
+      if (compacting_) Journal(JOURNAL_PUT, k, d);
+    }
+
+    bool Retrieve (const K& k, D& d) const
+    {
+      ReadGuard<L> g(lock_);
+      return map_.Retrieve(k,d);
+    }
+
+    bool Includes (const K& k) const
+    {
+      ReadGuard<L> g(lock_);
+      const MapType& m = map_;
+      return m.Includes(k) != m.End();
+    }
+
+    void Erase (const K& k)
+    {
+      WriteGuard<L> g(lock_);
+      map_.Erase(k);
+      ++erased_;
+      if (compacting_) Journal(JOURNAL_ERASE, k, D());
+    }
+
+    void Clear ()
+    {
+      WriteGuard<L> g(lock_);
+      map_.Clear();
+      Restart(0);
+    }
+
+    void Rehash ()
+    {
+      WriteGuard<L> g(lock_);
+      map_.Rehash();
+      Restart(map_.Size());
+    }
+
+    size_t Size () const
+    {
+      ReadGuard<L> g(lock_);
+      return map_.Size();
+    }
+
+    bool Empty () const
+    {
+      ReadGuard<L> g(lock_);
+      return map_.Empty();
+    }
+
+    MapType Snapshot () const
+    {
+      ReadGuard<L> g(lock_);
+      return map_;
+    }
+
+    template < class F >
+    void ForEach (F f) const
+    {
+      ReadGuard<L> g(lock_);
+      const MapType& m = map_;
+      for (typename MapType::ConstIterator i = m.Begin(); i != m.End(); ++i)
+        f(*i);
+    }
+
+    template < class F >
+    auto Read (F f) const -> decltype(f(std::declval<const MapType&>()))
+    {
+      ReadGuard<L> g(lock_);
+      return f(static_cast<const MapType&>(map_));
+    }
+
+    template < class F >
+    auto Write (F f) -> decltype(f(std::declval<MapType&>()))
+    {
+      WriteGuard<L> g(lock_);
+      Settled settled(map_);
+      abandoned_ = compacting_; //f may write any key
+      return f(map_);
+    }
+
+    bool Compact ()
+    {
+      std::lock_guard<std::mutex> one(compactMutex_); //one compaction at a time
+      MapType fresh;
+      {
+        WriteGuard<L> g(lock_);
+        journal_.clear();
+        compacting_ = 1;
+        abandoned_ = 0;
+        if (map_.Arena()) //the new tree goes where the old one was
+          fresh.EnableArena(map_.Arena()->HugePages());
+      }
+      std::vector<EntryType> live;
+      K last = K();
+      const K* after = nullptr;
+      bool done = 0;
+      while (!done)
+      {
+        ReadGuard<L> g(lock_);
+        if (abandoned_)
+          break;
+        const K* k = map_.Scan(after, 1024, [&live](const EntryType& e) { live.push_back(e); });
+        if (k == nullptr)
+          done = 1;
+        else
+        {
+          last = *k;
+          after = &last;
+        }
+      }
+      if (done)
+        fresh.Build(live.begin(), live.end());
+      std::vector<EntryType>().swap(live);
+      // catch up unlocked, a batch of journaled writes at a time, until at
+      // most 64 are left for the write lock; a batch no shorter than the
+      // one before means the writers outrun the replay, so give up
+      std::vector<Record> batch;
+      size_t entries = fresh.Size(); //no full count under the lock
+      size_t previous = (size_t)-1;
+      while (1)
+      {
+        {
+          WriteGuard<L> g(lock_);
+          if (!done || abandoned_ || (journal_.size() > 64 && journal_.size() >= previous))
+          {
+            compacting_ = 0;
+            std::vector<Record>().swap(journal_);
+            return 0;
+          }
+          if (journal_.size() <= 64)
+          {
+            compacting_ = 0;
+            entries += journal_.size(); //about the entries left
+            Replay(fresh, journal_);
+            map_.SwapTree(fresh);
+            base_ = entries;
+            erased_ = 0;
+            ++compactions_;
+            std::vector<Record>().swap(journal_);
+            break;
+          }
+          previous = journal_.size();
+          batch.swap(journal_);
+        }
+        Replay(fresh, batch);
+        batch.clear();
+        entries = fresh.Size();
+      }
+      return 1; //fresh, the old tree, is freed here, unlocked
+    }
+
+    void StartCompactor (double fraction = 0.25, size_t ms = 100)
+    {
+      StopCompactor();
+      stop_ = 0;
+      compactor_ = std::thread([this, fraction, ms]()
+      {
+        std::unique_lock<std::mutex> lk(stopMutex_);
+        while (!stop_)
+        {
+          stopped_.wait_for(lk, std::chrono::milliseconds(ms));
+          if (stop_)
+            break;
+          bool due;
+          {
+            ReadGuard<L> g(lock_);
+            due = erased_ > 0 && (double)erased_ >= fraction * (double)(base_ ? base_ : 1);
+          }
+          if (due)
+          {
+            lk.unlock();
+            Compact();
+            lk.lock();
+          }
+        }
+      });
+    }
+
+    void StopCompactor ()
+    {
+      if (!compactor_.joinable())
+        return;
+      {
+        std::lock_guard<std::mutex> lk(stopMutex_);
+        stop_ = 1;
+      }
+      stopped_.notify_all();
+      compactor_.join();
+    }
+
+    size_t Compactions () const
+    {
+      ReadGuard<L> g(lock_);
+      return compactions_;
+    }
+
+  private:
+    enum { JOURNAL_PUT, JOURNAL_ERASE };
+    struct Record
+    {
+      int op;
+      K   key;
+      D   data;
+    } ;
+
+    MapType   map_;
+    mutable L lock_;
+
+    // compaction state; all but the thread and its stop signal are guarded by lock_
+    std::vector<Record>     journal_;     // writes since the compaction began
+    bool                    compacting_;
+    bool                    abandoned_;
+    size_t                  erased_;      // Erase() calls since the last compaction
+    size_t                  base_;        // about the entries the last compaction left
+    size_t                  compactions_;
+    std::mutex              compactMutex_;
+    std::thread             compactor_;
+    std::mutex              stopMutex_;
+    std::condition_variable stopped_;
+    bool                    stop_;
+
+    void Journal (int op, const K& k, const D& d)
+    {
+      Record r = { op, k, d };
+      journal_.push_back(r);
+    }
+
+    // each write in order; the last one for a key leaves its state
+    static void Replay (MapType& m, const std::vector<Record>& writes)
+    {
+      for (size_t i = 0; i < writes.size(); ++i)
+      {
+        if (writes[i].op == JOURNAL_PUT)
+          m.Put(writes[i].key, writes[i].data);
+        else
+          m.Erase(writes[i].key);
+      }
+    }
+
+    void Restart (size_t base)
+    {
+      abandoned_ = compacting_;
+      erased_ = 0;
+      base_ = base;
+    }
+
+    // an incremental rehash started by f in Write(f) is finished before the
+    // lock is released: readers never step a rehash, so it would not finish
+    struct Settled
+    {
+      MapType& m;
+      explicit Settled (MapType& map) : m(map) {}
+      ~Settled () { m.FinishRehash(); }
+    } ;
+
+    SyncMap (const SyncMap&);
+    SyncMap& operator = (const SyncMap&);
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,300 @@
+/*
+    tableload.h
+    10/18/26
+
+    LoadTable: fast loading of <key,data> text files into a Map_ADT
+
+      LoadTable (path, map, info)   reads path into map; false if path cannot
+                                    be opened or mapped. info describes the
+                                    file.
+
+    The file is a sequence of whitespace-separated pairs "key data", as
+    written by rantable (one TAB-separated pair per line). The key is a
+    String, and data is an integer type. The map is a Map_ADT or a class
+    derived from it, such as MapRecorder (maplog.h), whose Build() and
+    Put() are then the ones called. The result is the same as
+
+      while (ifs >> key >> data) map[key] = data;
+
+    in every case: leading whitespace is skipped, a key ends at a blank,
+    TAB or newline, data is an optional sign and decimal digits, a later
+    duplicate key overwrites an earlier one, and reading stops at the
+    first pair that does not parse (or whose data is out of range for D).
+
+    The work is different. The file is mapped with mmap and scanned once,
+    front to back, by hand-written scanners, with no istream and no locale.
+    The scan records where each key lies in the mapping and does not
+    allocate. Then:
+
+      map empty, P = LessThan<String>   the fields are sorted by key, using
+                                        an 8-byte key prefix held beside
+                                        each field, and the last field of
+                                        each key is kept. Their Strings are
+                                        made in key order, and
+                                        Map_ADT::Build() makes the tree in
+                                        one linear pass, with no searching.
+      map empty, other P                the Strings are made in file order.
+                                        If the keys are strictly increasing
+                                        under P, Build() makes the tree,
+                                        else each pair goes in with Put().
+      map not empty                     each pair goes in with Put().
+
+    Column widths are the byte lengths of the fields, not log10 of the
+    data.
+
+    TableLoadInfo
+    -------------
+
+      entries     pairs read
+      bytes       size of the file
+      keyWidth    longest key, in characters
+      dataWidth   longest data field, in characters (sign included)
+      sorted      the file's keys were already strictly increasing
+                  (known only when the map was empty)
+      bulk        true: the tree was built by Build(); false: by Put()
+*/
+
+#ifndef _TABLELOAD_H
+#define _TABLELOAD_H
+
+#include <cstddef>     // size_t
+#include <cstdint>
+#include <cstring>     // memchr, memcpy
+#include <algorithm>   // sort
+#include <limits>
+#include <vector>
+#include <type_traits>
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <xstring.h>
+#include <compare.h>   // LessThan
+#include <map_adt.h>
+
+namespace fsu
+{
+
+  struct TableLoadInfo
+  {
+    size_t entries;
+    size_t bytes;
+    size_t keyWidth;
+    size_t dataWidth;
+    bool   sorted;
+    bool   bulk;
+
+    TableLoadInfo () : entries(0), bytes(0), keyWidth(0), dataWidth(0), sorted(0), bulk(0) {}
+  } ;
+
+  // the characters operator >> skips
+  inline bool TableSpace (char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+  }
+
+  // the characters that end a String read by operator >>
+  inline bool TableKeyEnd (char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n';
+  }
+
+  // reads [sign]digits at p into d; returns the end of the field, or nullptr
+  // if there are no digits or the value does not fit in D
+  template < typename D >
+  const char* ScanInteger (const char* p, const char* end, D& d)
+  {
+    bool neg = 0;
+    if (p != end && (*p == '-' || *p == '+'))
+      neg = (*p++ == '-');
+    const char* digits = p;
+    uint64_t limit = neg ? (uint64_t)0 - (uint64_t)std::numeric_limits<D>::min()
+                         : (uint64_t)std::numeric_limits<D>::max();
+    uint64_t v = 0;
+    for ( ; p != end && (unsigned char)(*p - '0') < 10; ++p)
+    {
+      unsigned c = *p - '0';
+      if (c > limit || v > (limit - c) / 10)
+        return nullptr;
+      v = 10 * v + c;
+    }
+    if (p == digits)
+      return nullptr;
+    d = neg ? (D)(0 - v) : (D)v;
+    return p;
+  }
+
+  // one pair as scanned: the key is len bytes at key, in the mapping
+  template < typename D >
+  struct TableField
+  {
+    uint64_t    prefix;  // orders as the first 8 key bytes do under String's operator <
+    const char* key;
+    size_t      len;
+    D           data;
+  } ;
+
+  // String compares chars as signed, so flipping the sign bit and packing
+  // big-endian, with the end of the key as 0x80 ('\0'), gives an unsigned
+  // integer that orders the same way
+  inline uint64_t TablePrefix (const char* k, size_t len)
+  {
+    uint64_t p = 0;
+    for (size_t i = 0; i < 8; ++i)
+      p = (p << 8) | (i < len ? (uint8_t)(k[i] ^ 0x80) : 0x80);
+    return p;
+  }
+
+  // String's operator < on two scanned keys
+  template < typename D >
+  bool TableKeyLess (const TableField<D>& a, const TableField<D>& b)
+  {
+    if (a.prefix != b.prefix)
+      return a.prefix < b.prefix;
+    size_t n = a.len < b.len ? a.len : b.len;
+    for (size_t i = 8; i < n; ++i)
+    {
+      if (a.key[i] != b.key[i])
+        return (signed char)a.key[i] < (signed char)b.key[i];
+    }
+    // one key is a prefix of the other: the longer one's next char meets
+    // the shorter one's '\0', signed, as in String::StrCmp
+    if (a.len < b.len)
+      return '\0' < (signed char)b.key[n];
+    if (b.len < a.len)
+      return (signed char)a.key[n] < '\0';
+    return 0;
+  }
+
+  template < typename D >
+  struct TableRow
+  {
+    String key_;
+    D      data_;
+    TableRow (const char* k, D d) : key_(k), data_(d) {}
+  } ;
+
+  // makes field f's String, by way of buf, and appends its row
+  template < typename D >
+  void TableAppend (std::vector< TableRow<D> >& rows, const TableField<D>& f, std::vector<char>& buf)
+  {
+    if (buf.size() <= f.len)
+      buf.resize(2 * f.len + 1);
+    memcpy(buf.data(), f.key, f.len);
+    buf[f.len] = '\0';
+    rows.push_back(TableRow<D>(buf.data(), f.data));
+  }
+
+  // M is a Map_ADT<String,D,P>, or a class derived from one (MapRecorder)
+  template < class M >
+  bool LoadTable (const char* path, M& map, TableLoadInfo& info)
+  {
+    typedef typename M::DataType      D;
+    typedef typename M::PredicateType P;
+    static_assert(std::is_same< typename M::KeyType , String >::value, "LoadTable: key must be String");
+    static_assert(std::is_integral<D>::value, "LoadTable: data must be an integer type");
+    info = TableLoadInfo();
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+      return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+      close(fd);
+      return 0;
+    }
+    info.bytes = (size_t)st.st_size;
+    const char* text = nullptr;
+    if (info.bytes > 0)
+    {
+      void* p = mmap(nullptr, info.bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED)
+      {
+        close(fd);
+        return 0;
+      }
+      madvise(p, info.bytes, MADV_SEQUENTIAL);
+      text = (const char*)p;
+    }
+    close(fd);
+
+    // one pair per line is the usual case
+    const char* end = text + info.bytes;
+    size_t lines = 0;
+    for (const char* q = text; q != end && (q = (const char*)memchr(q, '\n', end - q)) != nullptr; ++q)
+      ++lines;
+    std::vector< TableField<D> > fields;
+    fields.reserve(lines + 1);
+
+    bool sorted = 1;
+    const char* p = text;
+    while (1)
+    {
+      while (p != end && TableSpace(*p)) ++p;
+      const char* k = p;
+      while (p != end && !TableKeyEnd(*p)) ++p;
+      if (p == k)
+        break;
+      TableField<D> f;
+      f.key = k;
+      const char* nul = (const char*)memchr(k, '\0', p - k); // a String ends at a NUL
+      f.len = (nul ? nul : p) - k;
+      while (p != end && TableSpace(*p)) ++p;
+      const char* q = ScanInteger(p, end, f.data);
+      if (q == nullptr)
+        break;
+      f.prefix = TablePrefix(f.key, f.len);
+      if (sorted && !fields.empty() && !TableKeyLess(fields.back(), f))
+        sorted = 0;
+      fields.push_back(f);
+      if (info.keyWidth < f.len)            info.keyWidth = f.len;
+      if (info.dataWidth < (size_t)(q - p)) info.dataWidth = q - p;
+      p = q;
+    }
+    info.entries = fields.size();
+
+    std::vector< TableRow<D> > rows;
+    std::vector<char> buf(64);
+    rows.reserve(fields.size());
+    if (map.Empty() && std::is_same< P , LessThan<String> >::value)
+    {
+      info.sorted = sorted;
+      if (!sorted) // key order; equal keys stay in file order
+      {
+        std::sort(fields.begin(), fields.end(), [](const TableField<D>& a, const TableField<D>& b)
+          {
+            if (TableKeyLess(a, b)) return true;
+            if (TableKeyLess(b, a)) return false;
+            return a.key < b.key;
+          });
+      }
+      for (size_t i = 0; i < fields.size(); ++i)
+      {
+        if (i + 1 < fields.size() && !TableKeyLess(fields[i], fields[i + 1]))
+          continue; // fields[i + 1] has the same key and came later in the file
+        TableAppend(rows, fields[i], buf);
+      }
+      info.bulk = map.Build(rows.begin(), rows.end());
+    }
+    else
+    {
+      for (size_t i = 0; i < fields.size(); ++i)
+        TableAppend(rows, fields[i], buf);
+      if (map.Empty())
+        info.sorted = info.bulk = map.Build(rows.begin(), rows.end());
+    }
+    if (!info.bulk) // Build refused the rows (or was not tried): one Put each, in order
+    {
+      for (typename std::vector< TableRow<D> >::const_iterator i = rows.begin(); i != rows.end(); ++i)
+        map.Put(i->key_, i->data_);
+    }
+    if (text)
+      munmap((void*)text, info.bytes);
+    return 1;
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,236 @@
+/*
+    threadpool.h
+    10/18/26
+
+    Work-stealing thread pool and fork/join task groups
+
+    classes defined in this file
+    ----------------------------
+
+    class ThreadPool   // fixed set of workers, one task deque each
+    class TaskGroup    // Run() tasks, then Wait() for all of them
+
+    Each worker owns a deque of tasks. A worker pushes and pops its own
+    deque at the back (LIFO, cache-warm), and when it runs dry it steals
+    from the front of the others (FIFO, the oldest and usually largest
+    pieces of work). Tasks submitted from outside the pool are dealt round
+    robin. The deques are short mutex-guarded std::deques: parallel
+    algorithms here submit a few tasks per worker, so contention is
+    negligible and the simple structure is easy to trust.
+
+    TaskGroup::Wait() does not block while work is pending: the waiting
+    thread runs queued tasks itself until its group is done. That makes
+    nested parallelism deadlock-free and lets a pool with zero workers
+    (a single-core machine) still complete every group, on the caller.
+
+    ThreadPool::Default() is a process-wide pool sized to
+    hardware_concurrency - 1 workers; the caller of Wait() is the last one.
+
+    Usage:
+
+      fsu::TaskGroup g;                  // uses ThreadPool::Default()
+      g.Run([&]{ SumLeft(); });
+      g.Run([&]{ SumRight(); });
+      g.Wait();
+*/
+
+#ifndef _THREADPOOL_H
+#define _THREADPOOL_H
+
+#include <cstddef>   // size_t
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+namespace fsu
+{
+
+  //-------------------------
+  //    class ThreadPool
+  //-------------------------
+
+  class ThreadPool
+  {
+  public:
+    typedef std::function<void()> Task;
+
+    // workers == 0 is legal: tasks then run on threads that Wait()
+    explicit ThreadPool (size_t workers) : queues_(workers ? workers : 1), pending_(0), next_(0), stop_(false)
+    {
+      for (size_t i = 0; i < workers; ++i)
+        threads_.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+    }
+
+    ~ThreadPool ()
+    {
+      {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+      }
+      wake_.notify_all();
+      for (size_t i = 0; i < threads_.size(); ++i)
+        threads_[i].join();
+    }
+
+    static ThreadPool& Default ()
+    {
+      static ThreadPool pool(DefaultWorkers());
+      return pool;
+    }
+
+    static size_t DefaultWorkers ()
+    {
+      size_t hw = std::thread::hardware_concurrency();
+      return hw > 1 ? hw - 1 : 0;
+    }
+
+    size_t Workers     () const { return threads_.size(); }
+    size_t Concurrency () const { return threads_.size() + 1; }  // workers + the waiting caller
+
+    void Submit (const Task& task)
+    {
+      size_t q = (WorkerIndex() >= 0) ? (size_t)WorkerIndex() : next_.fetch_add(1) % queues_.size();
+      {
+        std::lock_guard<std::mutex> lock(queues_[q].mutex);
+        queues_[q].tasks.push_back(task);
+      }
+      pending_.fetch_add(1);
+      if (!threads_.empty())
+      {
+        std::lock_guard<std::mutex> lock(sleepMutex_);   // pairs with the predicate check in WorkerLoop
+        wake_.notify_one();
+      }
+    }
+
+    // runs one queued task on the calling thread, if there is one
+    bool RunOne ()
+    {
+      Task task;
+      if (!Take(task))
+        return false;
+      task();
+      return true;
+    }
+
+  private:
+    struct Queue
+    {
+      std::mutex       mutex;
+      std::deque<Task> tasks;
+    } ;
+
+    std::vector<Queue>       queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t>      pending_;   // tasks queued, not yet taken
+    std::atomic<size_t>      next_;      // round robin for outside submitters
+    std::mutex               sleepMutex_;
+    std::condition_variable  wake_;
+    bool                     stop_;
+
+    // this thread's queue index in this pool, -1 if not one of its workers
+    int WorkerIndex () const
+    {
+      return (CurrentPool() == this) ? CurrentIndex() : -1;
+    }
+    static const ThreadPool*& CurrentPool  () { static thread_local const ThreadPool* p = nullptr; return p; }
+    static int&               CurrentIndex () { static thread_local int i = -1; return i; }
+
+    bool Take (Task& task)
+    {
+      if (pending_.load() == 0)
+        return false;
+      int self = WorkerIndex();
+      if (self >= 0 && PopBack(queues_[self], task))
+        return true;
+      size_t start = (self >= 0) ? (size_t)self + 1 : 0;
+      for (size_t k = 0; k < queues_.size(); ++k)
+        if (PopFront(queues_[(start + k) % queues_.size()], task))
+          return true;
+      return false;
+    }
+
+    bool PopBack (Queue& q, Task& task)
+    {
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (q.tasks.empty()) return false;
+      task = std::move(q.tasks.back());
+      q.tasks.pop_back();
+      pending_.fetch_sub(1);
+      return true;
+    }
+
+    bool PopFront (Queue& q, Task& task)   // steal
+    {
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (q.tasks.empty()) return false;
+      task = std::move(q.tasks.front());
+      q.tasks.pop_front();
+      pending_.fetch_sub(1);
+      return true;
+    }
+
+    void WorkerLoop (size_t index)
+    {
+      CurrentPool()  = this;
+      CurrentIndex() = (int)index;
+      for (;;)
+      {
+        if (RunOne())
+          continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]{ return stop_ || pending_.load() > 0; });
+        if (stop_ && pending_.load() == 0)
+          return;
+      }
+    }
+
+    ThreadPool (const ThreadPool&);
+    ThreadPool& operator= (const ThreadPool&);
+  } ;
+
+  //------------------------
+  //    class TaskGroup
+  //------------------------
+
+  class TaskGroup
+  {
+  public:
+    explicit TaskGroup (ThreadPool& pool = ThreadPool::Default()) : pool_(pool), outstanding_(0) {}
+    ~TaskGroup () { Wait(); }
+
+    template < class F >
+    void Run (F f)
+    {
+      outstanding_.fetch_add(1);
+      std::atomic<size_t>* count = &outstanding_;
+      pool_.Submit([f, count]() mutable { f(); count->fetch_sub(1); });
+    }
+
+    // helps with queued work (any group's) until every task of this group is done
+    void Wait ()
+    {
+      while (outstanding_.load() != 0)
+      {
+        if (!pool_.RunOne())
+          std::this_thread::yield();
+      }
+    }
+
+    ThreadPool& Pool () const { return pool_; }
+
+  private:
+    ThreadPool&         pool_;
+    std::atomic<size_t> outstanding_;
+
+    TaskGroup (const TaskGroup&);
+    TaskGroup& operator= (const TaskGroup&);
+  } ;
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,258 @@
+/*
+    trace.h
+    10/18/26
+
+    Low-overhead scoped tracing, a production-grade stand-in for fsu::Debug
+
+    classes/macros defined in this file
+    -----------------------------------
+
+    FSU_TRACE_SCOPE (name)          // 'B' on entry, 'E' on scope exit
+    FSU_TRACE_SCOPE_ARG (name,arg)  // same, with a 64-bit argument on entry
+    FSU_TRACE_EVENT (name,arg)      // instant event
+    FSU_TRACE_DUMP (file)           // write everything recorded so far as Chrome JSON
+
+    struct TraceRecord   // (timestamp, event id, arg, phase)
+    class  TraceBuffer   // per-thread ring of TraceRecords
+    class  Tracer        // registry of buffers; Dump / DumpFile / Clear
+    class  TraceScope    // RAII helper behind FSU_TRACE_SCOPE
+
+    Tracing is a compile-time switch: build with -DFSU_TRACE to record,
+    otherwise every macro expands to nothing and its arguments are not
+    evaluated. The event id is the address of the name, so names must be
+    string literals (or otherwise outlive the dump); nothing is copied.
+
+    Each thread writes only to its own ring buffer, found through a
+    thread_local pointer, so recording takes no lock and does no
+    allocation: one clock read and four stores. The clock is
+    LatencyTimer::Ticks() from histogram.h; add -DFSU_LATENCY_RDTSC to
+    use the time stamp counter, which brings an event down to a few ns.
+    The registry mutex is taken only the first time a thread records and
+    when dumping. When a ring fills, the oldest records are overwritten
+    (capacity per thread is FSU_TRACE_CAPACITY, default 64K records).
+
+    Dump while the traced threads are quiet (typically at program end);
+    a record being written concurrently with a dump may come out torn.
+    Load the output in chrome://tracing or https://ui.perfetto.dev
+
+    Usage:
+
+      void Map::Erase (const K& k)
+      {
+        FSU_TRACE_SCOPE("Map::Erase");
+        ...
+      }
+      ...
+      FSU_TRACE_DUMP("fmap.trace.json");
+*/
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#ifdef FSU_TRACE
+
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <histogram.h>  // LatencyTimer::Ticks()
+
+#ifndef FSU_TRACE_CAPACITY
+  #define FSU_TRACE_CAPACITY (1 << 16)   // records per thread; power of 2
+#endif
+
+#define FSU_TRACE_CAT2(a,b) a##b
+#define FSU_TRACE_CAT(a,b)  FSU_TRACE_CAT2(a,b)
+#define FSU_TRACE_SCOPE(name)         fsu::TraceScope FSU_TRACE_CAT(fsuTraceScope_,__LINE__) (name)
+#define FSU_TRACE_SCOPE_ARG(name,arg) fsu::TraceScope FSU_TRACE_CAT(fsuTraceScope_,__LINE__) (name, (uint64_t)(arg))
+#define FSU_TRACE_EVENT(name,arg)     fsu::TraceBuffer::Local()->Record('i', name, (uint64_t)(arg))
+#define FSU_TRACE_DUMP(file)          fsu::Tracer::Instance().DumpFile(file)
+
+namespace fsu
+{
+
+  struct TraceRecord
+  {
+    uint64_t    ticks;
+    const char* name;
+    uint64_t    arg;
+    char        phase;   // 'B' begin, 'E' end, 'i' instant
+  } ;
+
+  //--------------------------
+  //    class TraceBuffer
+  //--------------------------
+
+  class TraceBuffer
+  {
+  public:
+    enum { capacity = FSU_TRACE_CAPACITY };
+
+    explicit TraceBuffer (unsigned tid) : head_(0), tid_(tid), ring_(new TraceRecord [capacity]) {}
+    ~TraceBuffer () { delete [] ring_; }
+
+    // single writer (the owning thread); the release store publishes the record
+    void Record (char phase, const char* name, uint64_t arg)
+    {
+      uint64_t h = head_.load(std::memory_order_relaxed);
+      TraceRecord& r = ring_[h & (capacity - 1)];
+      r.ticks = LatencyTimer::Ticks();
+      r.name  = name;
+      r.arg   = arg;
+      r.phase = phase;
+      head_.store(h + 1, std::memory_order_release);
+    }
+
+    static TraceBuffer* Local ();   // this thread's buffer, registered on first use
+
+    uint64_t           Head    () const { return head_.load(std::memory_order_acquire); }
+    unsigned           Tid     () const { return tid_; }
+    const TraceRecord& At      (uint64_t i) const { return ring_[i & (capacity - 1)]; }
+    void               Clear   () { head_.store(0, std::memory_order_release); }
+
+  private:
+    std::atomic<uint64_t> head_;   // total records ever written
+    unsigned              tid_;
+    TraceRecord*          ring_;
+
+    TraceBuffer (const TraceBuffer&);
+    TraceBuffer& operator= (const TraceBuffer&);
+
+    static_assert((capacity & (capacity - 1)) == 0, "FSU_TRACE_CAPACITY must be a power of 2");
+  } ;
+
+  //---------------------
+  //    class Tracer
+  //---------------------
+
+  class Tracer
+  {
+  public:
+    static Tracer& Instance ()
+    {
+      static Tracer* tracer = new Tracer;   // never destroyed: threads may outlive main()
+      return *tracer;
+    }
+
+    TraceBuffer* Register ()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      TraceBuffer* b = new TraceBuffer((unsigned)buffers_.size() + 1);
+      buffers_.push_back(b);
+      return b;
+    }
+
+    void Clear ()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < buffers_.size(); ++i)
+        buffers_[i]->Clear();
+    }
+
+    // Chrome trace-event format; timestamps in microseconds from the first trace
+    void Dump (std::ostream& os)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      os << "{\"traceEvents\":[\n";
+      bool first = true;
+      for (size_t i = 0; i < buffers_.size(); ++i)
+      {
+        const TraceBuffer& b = *buffers_[i];
+        uint64_t end = b.Head();
+        uint64_t begin = (end > (uint64_t)TraceBuffer::capacity) ? end - TraceBuffer::capacity : 0;
+        for (uint64_t j = begin; j < end; ++j)
+        {
+          const TraceRecord& r = b.At(j);
+          if (!first) os << ",\n";
+          first = false;
+          os << "{\"name\":\"";
+          WriteEscaped(os, r.name);
+          os << "\",\"ph\":\"" << r.phase << "\",\"pid\":1,\"tid\":" << b.Tid()
+             << ",\"ts\":" << Microseconds(r.ticks);
+          if (r.phase == 'i')
+            os << ",\"s\":\"t\"";
+          if (r.phase != 'E')
+            os << ",\"args\":{\"arg\":" << r.arg << '}';
+          os << '}';
+        }
+      }
+      os << "\n]}\n";
+    }
+
+    bool DumpFile (const char* filename)
+    {
+      std::ofstream out(filename);
+      if (!out)
+      {
+        std::cerr << " ** trace: unable to open " << filename << '\n';
+        return false;
+      }
+      Dump(out);
+      return true;
+    }
+
+  private:
+    Tracer () : origin_(LatencyTimer::Ticks()) {}
+
+    double Microseconds (uint64_t ticks) const
+    {
+      return (ticks < origin_) ? 0.0 : 1.0e-3 * (double)LatencyTimer::ToNs(ticks - origin_);
+    }
+
+    static void WriteEscaped (std::ostream& os, const char* s)
+    {
+      for (; s && *s; ++s)
+      {
+        if (*s == '"' || *s == '\\') os << '\\';
+        if ((unsigned char)*s >= ' ') os << *s;
+      }
+    }
+
+    std::mutex                mutex_;
+    std::vector<TraceBuffer*> buffers_;   // owned; kept so a thread's events survive it
+    uint64_t                  origin_;
+  } ;
+
+  inline TraceBuffer* TraceBuffer::Local ()
+  {
+    static thread_local TraceBuffer* local = Tracer::Instance().Register();
+    return local;
+  }
+
+  //-------------------------
+  //    class TraceScope
+  //-------------------------
+
+  class TraceScope
+  {
+  public:
+    explicit TraceScope (const char* name, uint64_t arg = 0)
+      : buffer_(TraceBuffer::Local()), name_(name)
+    {
+      buffer_->Record('B', name_, arg);
+    }
+    ~TraceScope () { buffer_->Record('E', name_, 0); }
+
+  private:
+    TraceBuffer* buffer_;
+    const char*  name_;
+
+    TraceScope (const TraceScope&);
+    TraceScope& operator= (const TraceScope&);
+  } ;
+
+} // namespace fsu
+
+#else  // FSU_TRACE not defined: tracing compiles away
+
+#define FSU_TRACE_SCOPE(name)
+#define FSU_TRACE_SCOPE_ARG(name,arg)
+#define FSU_TRACE_EVENT(name,arg)     ((void)0)
+#define FSU_TRACE_DUMP(file)          ((void)0)
+
+#endif // FSU_TRACE
+
+#endif
@@ -252,6 +252,20 @@ size_t Vector<T>::Capacity() const
   return capacity_;
 }
 
+template <typename T>
+size_t Vector<T>::MemoryUsage() const
+// the whole data_ array is owned, and every slot in it is a live T
+{
+  size_t bytes = sizeof(*this);
+  if (data_ != 0)
+  {
+    bytes += capacity_ * sizeof(T);
+    for (size_t i = 0; i < capacity_; ++i)
+      bytes += HeapUsage(data_[i]);
+  }
+  return bytes;
+}
+
 // Container class protocol implementation
 
 template <typename T>
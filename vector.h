@@ -14,6 +14,7 @@
 #include <iostream>
 #include <cstdlib>    // EXIT_FAILURE, size_t
 #include <genalg.h>   // fsu::Swap(x,y)
+#include <memtrack.h> // HeapUsage()
 
 namespace fsu
 {
@@ -68,6 +69,7 @@ namespace fsu
     bool     SetCapacity (size_t);    // force capacity change (up or down)
     size_t   Size        () const;    // return size
     size_t   Capacity    () const;    // return capacity
+    size_t   MemoryUsage () const;    // bytes owned, including slack capacity
 
     // Container class protocol
     bool     Empty       () const;    // 1 iff empty
@@ -108,6 +110,9 @@ namespace fsu
     static T*  NewArray (size_t);  // safe space allocator
   } ;
 
+  template < class T >
+  size_t HeapUsage (const Vector<T>& v) { return v.MemoryUsage() - sizeof(v); }
+
 #include <vector.cpp> // "slave" file, included inside multiple read protection and namespace
 
 }   // namespace fsu
@@ -12,8 +12,9 @@
 #include <wordsmith3.h> // included to indicate that this is the implementation file
 #include <fstream> // Allows for read access to files
 #include <iomanip>
+#include <trace.h>     // FSU_TRACE_*(), compiled in with -DFSU_TRACE
 
-WordSmith::WordSmith() : frequency_(), infiles_(), count_(0)  //default constructor
+WordSmith::WordSmith() : frequency_(), infiles_(), count_(0), ingest_(), stopwords_(), skipped_(0)  //default constructor
 {}
 
 WordSmith::~WordSmith() // destructor
@@ -21,6 +22,8 @@ WordSmith::~WordSmith() // destructor
 
 bool WordSmith::ReadText (const fsu::String& infile, bool showProgress)
 {
+    FSU_TRACE_SCOPE("WordSmith::ReadText");
+    fsu::LatencyTimer timer; //per-file ingest latency, recorded on success
     const char * fileForOpen = infile.Cstr();
     std::ifstream inClientFile(fileForOpen, std::ios::in); //open file for read
     
@@ -32,13 +35,19 @@ bool WordSmith::ReadText (const fsu::String& infile, bool showProgress)
     const unsigned long tickerVal = 65536;
     fsu::String wordString;
     size_t wordCounter = 0;
+    size_t skipCounter = 0;
     size_t initVocabSize = VocabSize();
+    bool useStopwords = !stopwords_.Empty();
     
     while (inClientFile >> wordString) //read words from file separated by whitespace, continue until EOF
     {
         WordSmith::Cleanup(wordString); //cleans up the string as per rules
         
-        if (wordString.Length() != 0) //if cleanup operation resulted in non-zero length string
+        if (wordString.Length() != 0 && useStopwords && stopwords_.Includes(wordString))
+        {
+            ++skipCounter; //a stopword: not counted
+        }
+        else if (wordString.Length() != 0) //if cleanup operation resulted in non-zero length string
         {
             ++frequency_[wordString]; //get data value based on key value, increment by one if it exists already.
                                       //if it does not exist, create new and increment to 1.
@@ -55,13 +64,18 @@ bool WordSmith::ReadText (const fsu::String& infile, bool showProgress)
         
     } // end reading file
     
+    FSU_TRACE_EVENT("ReadText words", wordCounter);
     count_ += wordCounter; //add to count_ var
+    skipped_ += skipCounter;
     
     std::cout << "\n\tNumber of words read:    " << wordCounter;
+    if (useStopwords)
+        std::cout << "\n\tStopwords skipped:       " << skipCounter;
     
     std::cout << "\n\tNew words in vocabulary: " << VocabSize() - initVocabSize << "\n";
     
     infiles_.PushBack(infile); //pushes the file name to the infiles_ list
+    ingest_.Record(timer.ElapsedNs());
     
     return 1; //operation was successful
 }
@@ -150,13 +164,68 @@ void WordSmith::ShowSummary () const
     std::cout << WordsRead();
     std::cout << "\nCurrent vocabulary size: ";
     std::cout << VocabSize();
-    std::cout << "\n\n";
+    std::cout << "\n";
+    if (!stopwords_.Empty())
+    {
+        std::cout << "Stopwords:               " << stopwords_.Size() << " words, "
+                  << skipped_ << " skipped" << (stopwords_.Mapped() ? " (mapped file)" : "") << '\n';
+    }
+    std::cout << "Memory owned:            ";
+    std::cout << MemoryUsage() << " bytes (vocabulary map " << frequency_.MemoryUsage() << ")\n";
+    if (fsu::HeapStats().Installed()) //counting operator new linked in (FSU_MEMTRACK_INSTALL_OPERATORS)
+    {
+        std::cout << "Process heap:            " << fsu::HeapStats().Live() << " bytes live, "
+                  << fsu::HeapStats().Peak() << " peak, " << fsu::HeapStats().Allocs() << " allocations\n";
+    }
+    if (ingest_.Count() > 0) //latency of ReadText, one sample per file
+    {
+        std::cout << "Ingest latency per file:\n";
+        fsu::LatencyHistogram::ReportHeader(std::cout);
+        ingest_.Report(std::cout, "ReadText");
+    }
+    std::cout << "\n";
 }
 
 void WordSmith::ClearData ()  //temporarily using as debugger
 {
     frequency_.Clear(); //empty the data
     infiles_.Clear(); //empty the list of file names
+    ingest_.Reset(); //latency samples belong to the cleared files
+    skipped_ = 0; //the stopword list itself is kept
+}
+
+bool WordSmith::LoadStopwords (const fsu::String& infile)
+{
+    FSU_TRACE_SCOPE("WordSmith::LoadStopwords");
+    if (stopwords_.Load(infile.Cstr())) //a frozen dictionary: mapped, not parsed
+        return 1;
+    if (StopType::IsImage(infile.Cstr())) //a frozen dictionary Load refused: not text
+        return 0;
+    
+    std::ifstream inClientFile(infile.Cstr(), std::ios::in);
+    if (!inClientFile)
+    {
+        return 0;
+    }
+    fsu::Map_ADT <KeyType,uint8_t> words;
+    fsu::String wordString;
+    while (inClientFile >> wordString)
+    {
+        WordSmith::Cleanup(wordString); //same rules as the text, so the words can match
+        if (wordString.Length() != 0)
+            words.Put(wordString, 1);
+    }
+    return stopwords_.Build(words);
+}
+
+bool WordSmith::SaveStopwords (const fsu::String& outfile) const
+{
+    return stopwords_.Save(outfile.Cstr());
+}
+
+void WordSmith::ClearStopwords ()
+{
+    stopwords_.Clear();
 }
 
 size_t WordSmith::WordsRead() const
@@ -164,6 +233,12 @@ size_t WordSmith::WordsRead() const
     return count_;
 }
 
+size_t WordSmith::MemoryUsage() const
+{
+    return sizeof(*this) + fsu::HeapUsage(frequency_) + fsu::HeapUsage(infiles_)
+           + stopwords_.MemoryUsage() - sizeof(stopwords_);
+}
+
 size_t WordSmith::VocabSize() const
 {
     return frequency_.Size(); //returns size of wordset
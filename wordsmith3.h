@@ -21,6 +21,14 @@
  The cleanup method is a helper method used to make it easy for the client to store words;
  it removes junk characters according to a set of rules for the program.
  
+ LoadStopwords() reads a list of words to leave out of the counts. ReadText then skips any
+ cleaned word found in the list. The list is held in a FrozenHashDict (frozendict.h), so each
+ check is one hash and at most one string compare. The file may be plain text (whitespace
+ separated words, cleaned like the text) or a frozen dictionary written by SaveStopwords(),
+ which is mapped into memory as-is. A frozen dictionary that cannot be loaded (damaged, or
+ saved with another data type) makes LoadStopwords() fail; it is never read as text.
+ Stopwords survive ClearData().
+ 
  The copy constructor and assignment operator are marked as private methods and are not implemented 
  so that the compiler does not generate default versions.
  */
@@ -31,6 +39,9 @@
 #include <xstring.h> //fsu::String
 #include <list.h> //fsu::List
 #include <map_adt.h>
+#include <histogram.h> // fsu::LatencyHistogram
+#include <memtrack.h> // fsu::HeapUsage, fsu::HeapStats
+#include <frozendict.h> // fsu::FrozenHashDict
 
 class WordSmith
 {
@@ -42,6 +53,10 @@ public:
     bool WriteReport    (const fsu::String& outfile, unsigned short kw = 15, unsigned short dw = 15) const;
     void ShowSummary    () const;
     void ClearData      ();
+    bool LoadStopwords  (const fsu::String& infile);        //word list or frozen dictionary
+    bool SaveStopwords  (const fsu::String& outfile) const; //as a frozen dictionary
+    void ClearStopwords ();
+    size_t MemoryUsage  () const; //bytes owned: map, file list, and the object itself
     
 private:
     
@@ -52,10 +67,14 @@ private:
     typedef size_t                                      DataType;
     
     typedef fsu::Map_ADT <KeyType,DataType>             SetType;
+    typedef fsu::FrozenHashDict <uint8_t>               StopType; //a set: data unused
     
     SetType                     frequency_; //specified set; holds frequency of keys
     ListType                    infiles_; //list of file names
     size_t                      count_; //keeps track of how many words were read
+    fsu::LatencyHistogram       ingest_; //wall time of each ReadText, in ns
+    StopType                    stopwords_; //words not counted
+    size_t                      skipped_; //stopwords skipped so far
     
     static void Cleanup (fsu::String&); //removes invalid characters from string
     
@@ -408,6 +408,12 @@ namespace fsu
     return size_;
   }
 
+  size_t String::MemoryUsage() const
+  // the buffer, when present, is size_ + 1 bytes (NewCstr)
+  {
+    return sizeof(String) + (data_ ? size_ + 1 : 0);
+  }
+
   size_t String::Length () const
   {
     if (data_ != nullptr)
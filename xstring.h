@@ -29,6 +29,8 @@
 
 #include <iostream>
 #include <cstdlib> // size_t
+#include <cstring> // strlen
+#include <hashval.h>
 
 namespace fsu
 {
@@ -72,6 +74,7 @@ namespace fsu
                                        // (returns '\0' if n is out of range)
     size_t Position  (char c, size_t beg); // index of first occurrence of c in [beg,size)
     const char* Cstr () const; // returns C-string for use as const char* function argument
+    size_t MemoryUsage () const;   // bytes owned: sizeof(String) + character buffer
 
     // String comparison function
     static int StrCmp (const String&, const String&);
@@ -105,6 +108,16 @@ namespace fsu
   // sum (concatenation) operator
   String operator + (const String&, const String&);
 
+  // heap bytes owned beyond sizeof(String); see memtrack.h
+  inline size_t HeapUsage (const String& s) { return s.MemoryUsage() - sizeof(String); }
+
+  // hash of the characters operator == compares (up to the first '\0'); see hashval.h
+  inline uint64_t HashValue (const String& s)
+  {
+    const char* p = s.Cstr();
+    return HashBytes(p, p ? strlen(p) : 0);
+  }
+
 }   // namespace fsu
 
 #endif